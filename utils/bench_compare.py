@@ -0,0 +1,72 @@
+#!/usr/bin/env python3
+"""compares two google-benchmark JSON reports and flags regressions.
+
+usage: bench_compare.py BASELINE.json CURRENT.json [--threshold 0.10]
+
+a benchmark is reported as a regression when its cpu time grew by more than
+the threshold (a fraction, 0.10 = 10%). the script exits with 1 if any
+regression was found, so it can fail a make target or a CI job.
+"""
+
+import argparse
+import json
+import sys
+
+TIME_UNITS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load_times(path):
+    with open(path, encoding="utf-8") as report:
+        data = json.load(report)
+
+    times = {}
+    for entry in data.get("benchmarks", []):
+        if entry.get("run_type", "iteration") != "iteration":
+            continue
+        scale = TIME_UNITS.get(entry.get("time_unit", "ns"), 1.0)
+        times[entry["name"]] = entry["cpu_time"] * scale
+    return times
+
+
+def format_time(nanoseconds):
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if nanoseconds >= scale:
+            return f"{nanoseconds / scale:.3f} {unit}"
+    return f"{nanoseconds:.1f} ns"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.10)
+    args = parser.parse_args()
+
+    baseline = load_times(args.baseline)
+    current = load_times(args.current)
+    regressions = 0
+
+    print(f"{'benchmark':<40} {'baseline':>12} {'current':>12} {'change':>9}")
+    for name, time in current.items():
+        if name not in baseline:
+            print(f"{name:<40} {'-':>12} {format_time(time):>12}      new")
+            continue
+
+        change = (time - baseline[name]) / baseline[name]
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print(f"{name:<40} {format_time(baseline[name]):>12} "
+              f"{format_time(time):>12} {change:>+8.1%}{flag}")
+
+    for name in baseline:
+        if name not in current:
+            print(f"{name:<40} {'(missing from current run)':>35}")
+
+    print(f"\n{regressions} regression(s) above {args.threshold:.0%}")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,243 @@
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "../src/s21_matrix.h"
+}
+
+// O(n^2) functions sweep the full 2..4096 range, s21_mult_matrix is O(n^3)
+// and stops at kMaxProductSize, the cofactor expansion used by
+// s21_determinant, s21_calc_complements and s21_inverse_matrix grows
+// factorially, so those sweeps stop at kMaxExpansionSize
+
+constexpr int kMinSize = 2;
+constexpr int kMaxSize = 4096;
+constexpr int kMaxProductSize = 1024;
+constexpr int kMaxExpansionSize = 8;
+
+// deterministic, well-conditioned fill: small pseudo-random values with a
+// dominant diagonal, so s21_inverse_matrix never hits a zero determinant
+static matrix_t make_matrix(int rows, int columns) {
+  matrix_t result = init_matrix();
+  unsigned state = 12345u + static_cast<unsigned>(rows * 31 + columns);
+
+  s21_create_matrix(rows, columns, &result);
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < columns; j++) {
+      state = state * 1103515245u + 12345u;
+      result.matrix[i][j] =
+          static_cast<double>(state >> 16 & 0xFF) / 256.0 - 0.5;
+    }
+    if (i < columns) result.matrix[i][i] += columns;
+  }
+  return result;
+}
+
+static void set_elements_counters(benchmark::State &state, int64_t elements) {
+  state.SetItemsProcessed(state.iterations() * elements);
+  state.SetBytesProcessed(state.iterations() * elements *
+                          static_cast<int64_t>(sizeof(double)));
+}
+
+// main
+
+static void BM_create_remove_matrix(benchmark::State &state) {
+  int size = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    matrix_t m = init_matrix();
+    s21_create_matrix(size, size, &m);
+    benchmark::DoNotOptimize(m.matrix);
+    s21_remove_matrix(&m);
+  }
+  set_elements_counters(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_create_remove_matrix)
+    ->RangeMultiplier(2)
+    ->Range(kMinSize, kMaxSize);
+
+static void BM_eq_matrix(benchmark::State &state) {
+  int size = static_cast<int>(state.range(0));
+  matrix_t m1 = make_matrix(size, size);
+  matrix_t m2 = make_matrix(size, size);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(s21_eq_matrix(&m1, &m2));
+  }
+  set_elements_counters(state, 2 * state.range(0) * state.range(0));
+  s21_remove_matrix(&m1);
+  s21_remove_matrix(&m2);
+}
+BENCHMARK(BM_eq_matrix)->RangeMultiplier(2)->Range(kMinSize, kMaxSize);
+
+static void BM_sum_matrix(benchmark::State &state) {
+  int size = static_cast<int>(state.range(0));
+  matrix_t m1 = make_matrix(size, size);
+  matrix_t m2 = make_matrix(size, size);
+  for (auto _ : state) {
+    matrix_t result = init_matrix();
+    s21_sum_matrix(&m1, &m2, &result);
+    benchmark::DoNotOptimize(result.matrix);
+    s21_remove_matrix(&result);
+  }
+  set_elements_counters(state, 3 * state.range(0) * state.range(0));
+  s21_remove_matrix(&m1);
+  s21_remove_matrix(&m2);
+}
+BENCHMARK(BM_sum_matrix)->RangeMultiplier(2)->Range(kMinSize, kMaxSize);
+
+// the same sum written into a reused result, without the allocation
+static void BM_sum_matrix_into(benchmark::State &state) {
+  int size = static_cast<int>(state.range(0));
+  matrix_t m1 = make_matrix(size, size);
+  matrix_t m2 = make_matrix(size, size);
+  matrix_t result = make_matrix(size, size);
+  for (auto _ : state) {
+    s21_sum_matrix_into(&m1, &m2, &result);
+    benchmark::DoNotOptimize(result.matrix);
+  }
+  set_elements_counters(state, 3 * state.range(0) * state.range(0));
+  s21_remove_matrix(&m1);
+  s21_remove_matrix(&m2);
+  s21_remove_matrix(&result);
+}
+BENCHMARK(BM_sum_matrix_into)->RangeMultiplier(2)->Range(kMinSize, kMaxSize);
+
+static void BM_sub_matrix(benchmark::State &state) {
+  int size = static_cast<int>(state.range(0));
+  matrix_t m1 = make_matrix(size, size);
+  matrix_t m2 = make_matrix(size, size);
+  for (auto _ : state) {
+    matrix_t result = init_matrix();
+    s21_sub_matrix(&m1, &m2, &result);
+    benchmark::DoNotOptimize(result.matrix);
+    s21_remove_matrix(&result);
+  }
+  set_elements_counters(state, 3 * state.range(0) * state.range(0));
+  s21_remove_matrix(&m1);
+  s21_remove_matrix(&m2);
+}
+BENCHMARK(BM_sub_matrix)->RangeMultiplier(2)->Range(kMinSize, kMaxSize);
+
+static void BM_mult_number(benchmark::State &state) {
+  int size = static_cast<int>(state.range(0));
+  matrix_t m = make_matrix(size, size);
+  for (auto _ : state) {
+    matrix_t result = init_matrix();
+    s21_mult_number(&m, 1.5, &result);
+    benchmark::DoNotOptimize(result.matrix);
+    s21_remove_matrix(&result);
+  }
+  set_elements_counters(state, 2 * state.range(0) * state.range(0));
+  s21_remove_matrix(&m);
+}
+BENCHMARK(BM_mult_number)->RangeMultiplier(2)->Range(kMinSize, kMaxSize);
+
+static void BM_mult_matrix(benchmark::State &state) {
+  int size = static_cast<int>(state.range(0));
+  matrix_t m1 = make_matrix(size, size);
+  matrix_t m2 = make_matrix(size, size);
+  for (auto _ : state) {
+    matrix_t result = init_matrix();
+    s21_mult_matrix(&m1, &m2, &result);
+    benchmark::DoNotOptimize(result.matrix);
+    s21_remove_matrix(&result);
+  }
+  state.counters["flops"] = benchmark::Counter(
+      2.0 * size * size * size, benchmark::Counter::kIsIterationInvariantRate);
+  s21_remove_matrix(&m1);
+  s21_remove_matrix(&m2);
+}
+BENCHMARK(BM_mult_matrix)
+    ->RangeMultiplier(2)
+    ->Range(kMinSize, kMaxProductSize);
+
+// the in-place update c += 0.5 * a * op(b), with b read transposed by the
+// kernel in the second variant
+static void BM_gemm(benchmark::State &state) {
+  int size = static_cast<int>(state.range(0));
+  int transposed = static_cast<int>(state.range(1));
+  matrix_t m1 = make_matrix(size, size);
+  matrix_t m2 = make_matrix(size, size);
+  matrix_t result = make_matrix(size, size);
+  for (auto _ : state) {
+    s21_gemm(0.5, &m1, FALSE, &m2, transposed, 1, &result);
+    benchmark::DoNotOptimize(result.matrix);
+  }
+  state.counters["flops"] = benchmark::Counter(
+      2.0 * size * size * size, benchmark::Counter::kIsIterationInvariantRate);
+  s21_remove_matrix(&m1);
+  s21_remove_matrix(&m2);
+  s21_remove_matrix(&result);
+}
+BENCHMARK(BM_gemm)->ArgsProduct(
+    {benchmark::CreateRange(kMinSize, kMaxProductSize, 2), {FALSE, TRUE}});
+
+static void BM_transpose(benchmark::State &state) {
+  int size = static_cast<int>(state.range(0));
+  matrix_t m = make_matrix(size, size);
+  for (auto _ : state) {
+    matrix_t result = init_matrix();
+    s21_transpose(&m, &result);
+    benchmark::DoNotOptimize(result.matrix);
+    s21_remove_matrix(&result);
+  }
+  set_elements_counters(state, 2 * state.range(0) * state.range(0));
+  s21_remove_matrix(&m);
+}
+BENCHMARK(BM_transpose)->RangeMultiplier(2)->Range(kMinSize, kMaxSize);
+
+static void BM_determinant(benchmark::State &state) {
+  int size = static_cast<int>(state.range(0));
+  matrix_t m = make_matrix(size, size);
+  for (auto _ : state) {
+    double result = 0;
+    s21_determinant(&m, &result);
+    benchmark::DoNotOptimize(result);
+  }
+  s21_remove_matrix(&m);
+}
+BENCHMARK(BM_determinant)->DenseRange(kMinSize, kMaxExpansionSize);
+
+// the same expansion split over a context pool (S21_MATRIX_THREADS or the
+// online CPUs)
+static void BM_determinant_ctx(benchmark::State &state) {
+  int size = static_cast<int>(state.range(0));
+  matrix_t m = make_matrix(size, size);
+  s21_context_t *context = NULL;
+  s21_context_create(NULL, &context);
+  double result = 0;
+  for (auto _ : state) {
+    s21_determinant_ctx(context, &m, &result);
+    benchmark::DoNotOptimize(result);
+  }
+  state.counters["threads"] = s21_context_threads(context);
+  s21_context_destroy(context);
+  s21_remove_matrix(&m);
+}
+BENCHMARK(BM_determinant_ctx)->DenseRange(kMinSize, kMaxExpansionSize);
+
+static void BM_calc_complements(benchmark::State &state) {
+  int size = static_cast<int>(state.range(0));
+  matrix_t m = make_matrix(size, size);
+  for (auto _ : state) {
+    matrix_t result = init_matrix();
+    s21_calc_complements(&m, &result);
+    benchmark::DoNotOptimize(result.matrix);
+    s21_remove_matrix(&result);
+  }
+  s21_remove_matrix(&m);
+}
+BENCHMARK(BM_calc_complements)->DenseRange(kMinSize, kMaxExpansionSize);
+
+static void BM_inverse_matrix(benchmark::State &state) {
+  int size = static_cast<int>(state.range(0));
+  matrix_t m = make_matrix(size, size);
+  for (auto _ : state) {
+    matrix_t result = init_matrix();
+    s21_inverse_matrix(&m, &result);
+    benchmark::DoNotOptimize(result.matrix);
+    s21_remove_matrix(&result);
+  }
+  s21_remove_matrix(&m);
+}
+BENCHMARK(BM_inverse_matrix)->DenseRange(kMinSize, kMaxExpansionSize);
+
+BENCHMARK_MAIN();
@@ -1,187 +1,348 @@
+#include <stdatomic.h>
+
 #include "s21_matrix.h"
 
-int s21_create_matrix(int rows, int columns, matrix_t *result) {
-  int error_code = OK;
+// with a context, the cofactor expansions of matrices from this size on are
+// split over the pool: the first row terms of the determinant, the rows of
+// the complements
+#define EXPANSION_PARALLEL_SIZE 7
+
+typedef struct expansion_job {
+  matrix_t *A;
+  matrix_t *result;
+  double determinant;
+  double *terms;
+  char *minors;
+  size_t minors_size;
+} expansion_job_t;
+
+static matrix_t *worker_minors(expansion_job_t *job, int worker) {
+  return layout_minors(job->minors + worker * job->minors_size, job->A->rows);
+}
 
-  if (!result || rows < 1 || columns < 1) {
-    error_code = INCORRECT_MATRIX;
-  } else {
-    *result = init_matrix();
-    result->rows = rows;
-    result->columns = columns;
-    result->matrix = allocate_matrix(rows, columns);
+static void determinant_task(void *arg, int task, int worker) {
+  expansion_job_t *job = arg;
+  matrix_t *minors = worker_minors(job, worker);
 
-    if (result->matrix) {
-      fill_matrix_zero(result);
-    } else {
-      error_code = MEMORY_ERROR;
-      free_matrix(rows, result->matrix);
+  fill_minor(job->A, minors, 0, task);
+  job->terms[task] = job->A->matrix[0][task] *
+                     expand_determinant(minors, minors + 1) *
+                     (task % 2 ? -1 : 1);
+}
+
+static void complements_task(void *arg, int task, int worker) {
+  expansion_job_t *job = arg;
+  matrix_t *minors = worker_minors(job, worker);
+
+  for (int j = 0; j < job->A->columns; j++) {
+    fill_minor(job->A, minors, task, j);
+    job->result->matrix[task][j] =
+        pow(-1, task + j) * expand_determinant(minors, minors + 1);
+  }
+}
+
+// runs the expansion tasks (one per row of A) with the terms and a chain of
+// minors per worker in one scratch block. the determinant terms are added in
+// order, whatever the number of threads
+static int run_expansion(s21_context_t *context, context_body_t body,
+                         expansion_job_t *job) {
+  int error_code = OK;
+  int size = job->A->rows;
+  int workers = size >= EXPANSION_PARALLEL_SIZE ? s21_context_threads(context)
+                                                : 1;
+  size_t terms_bytes = sizeof(double) * size;
+  job->minors_size = minors_bytes(size);
+  size_t bytes = terms_bytes + job->minors_size * workers;
+  char *block = scratch_acquire(context, bytes);
+
+  if (block) {
+    job->terms = (double *)block;
+    job->minors = block + terms_bytes;
+    context_parallel_for(workers > 1 ? context : NULL, size, body, job);
+    for (int i = 0; i < size; i++) {
+      job->determinant += job->terms[i];
     }
+    scratch_release(context, block, bytes);
+  } else {
+    error_code = MEMORY_ERROR;
+  }
+  return error_code;
+}
+
+// with a context, s21_find_mismatch splits matrices from this many elements
+// into blocks of MISMATCH_ROWS_BLOCK rows
+#define MISMATCH_PARALLEL_SIZE (1 << 20)
+#define MISMATCH_ROWS_BLOCK 16
+
+typedef struct mismatch_job {
+  matrix_t *A;
+  matrix_t *B;
+  const s21_tolerance_t *tolerance;
+  atomic_llong best;
+} mismatch_job_t;
+
+static int before_best(mismatch_job_t *job, int row) {
+  return (long long)row * job->A->columns <
+         atomic_load_explicit(&job->best, memory_order_relaxed);
+}
+
+// a block stops as soon as an earlier mismatch is known, and best only
+// decreases, so the result doesn't depend on the scheduling
+static void mismatch_task(void *arg, int task, int worker) {
+  mismatch_job_t *job = arg;
+  int begin = task * MISMATCH_ROWS_BLOCK;
+  int end = begin + MISMATCH_ROWS_BLOCK;
+  long long found = -1;
+  (void)worker;
+
+  if (end > job->A->rows) {
+    end = job->A->rows;
+  }
+  for (int i = begin; i < end && found < 0 && before_best(job, i); i++) {
+    found = first_mismatch(job->A, job->B, i, i + 1, job->tolerance);
   }
+
+  long long current = atomic_load_explicit(&job->best, memory_order_relaxed);
+  while (found >= 0 && found < current &&
+         !atomic_compare_exchange_weak_explicit(&job->best, &current, found,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed)) {
+  }
+}
+
+int s21_create_matrix(int rows, int columns, matrix_t *result) {
+  s21_stats_scope_t scope;
+  s21_stats_begin(&scope, S21_OP_CREATE_MATRIX);
+  int error_code = create_matrix(rows, columns, TRUE, result);
+  s21_stats_end(&scope);
   return error_code;
 }
 
 void s21_remove_matrix(matrix_t *A) {
   if (A) {
-    free_matrix(A->rows, A->matrix);
+    free_matrix(A->rows, A->columns, A->matrix);
     *A = init_matrix();
   }
 }
 
 int s21_eq_matrix(matrix_t *A, matrix_t *B) {
+  s21_stats_scope_t scope;
+  s21_stats_begin(&scope, S21_OP_EQ_MATRIX);
   int result = FALSE;
 
   if (A && B && A->matrix && B->matrix && check_eq_size(A, B)) {
-    int flag = 1;
-    for (int i = 0; i < A->rows && flag == 1; i++) {
-      for (int j = 0; j < A->columns; j++) {
-        double diff_abs = fabs(A->matrix[i][j] - B->matrix[i][j]);
-
-        if (diff_abs > 1e-7) {
-          flag--;
-          break;
-        }
-      }
-    }
+    s21_tolerance_t tolerance = {1e-7, 0, 0};
 
-    if (flag) {
+    if (first_mismatch(A, B, 0, A->rows, &tolerance) < 0) {
       result = TRUE;
     }
   }
+  s21_stats_end(&scope);
   return result;
 }
 
+int s21_approx_equal(matrix_t *A, matrix_t *B, s21_tolerance_t tolerance) {
+  int result = FALSE;
+
+  if (check_matrix(A) && check_matrix(B) && check_eq_size(A, B) &&
+      check_tolerance(tolerance) &&
+      first_mismatch(A, B, 0, A->rows, &tolerance) < 0) {
+    result = TRUE;
+  }
+  return result;
+}
+
+int s21_find_mismatch(matrix_t *A, matrix_t *B, s21_tolerance_t tolerance,
+                      int *row, int *column) {
+  return s21_find_mismatch_ctx(NULL, A, B, tolerance, row, column);
+}
+
+int s21_find_mismatch_ctx(s21_context_t *context, matrix_t *A, matrix_t *B,
+                          s21_tolerance_t tolerance, int *row, int *column) {
+  int error_code = INCORRECT_MATRIX;
+
+  if (check_matrix(A) && check_matrix(B) && check_tolerance(tolerance) &&
+      row && column) {
+    error_code = CALCULATION_ERROR;
+    if (check_eq_size(A, B)) {
+      long long found = -1;
+
+      if ((double)A->rows * A->columns < MISMATCH_PARALLEL_SIZE ||
+          s21_context_threads(context) == 1) {
+        found = first_mismatch(A, B, 0, A->rows, &tolerance);
+      } else {
+        long long none = (long long)A->rows * A->columns;
+        mismatch_job_t job = {A, B, &tolerance, none};
+        int blocks = (A->rows + MISMATCH_ROWS_BLOCK - 1) / MISMATCH_ROWS_BLOCK;
+
+        context_parallel_for(context, blocks, mismatch_task, &job);
+        found = atomic_load(&job.best);
+        if (found == none) {
+          found = -1;
+        }
+      }
+      *row = found < 0 ? -1 : (int)(found / A->columns);
+      *column = found < 0 ? -1 : (int)(found % A->columns);
+      error_code = OK;
+    }
+  }
+  return error_code;
+}
+
 int s21_sum_matrix(matrix_t *A, matrix_t *B, matrix_t *result) {
+  s21_stats_scope_t scope;
+  s21_stats_begin(&scope, S21_OP_SUM_MATRIX);
   int error_code = CALCULATION_ERROR;
 
   if (check_matrix(A) && check_matrix(B)) {
     if (check_eq_size(A, B)) {
-      error_code = s21_create_matrix(A->rows, A->columns, result);
+      error_code = create_matrix(A->rows, A->columns, FALSE, result);
     }
   } else {
     error_code = INCORRECT_MATRIX;
   }
 
   if (error_code == OK) {
-    for (int i = 0; i < A->rows; i++) {
-      for (int j = 0; j < A->columns; j++) {
-        result->matrix[i][j] = A->matrix[i][j] + B->matrix[i][j];
-      }
-    }
+    add_elements(A, B, 1, result);
+    s21_stats_add_flops(&scope, (double)A->rows * A->columns);
   }
+  s21_stats_end(&scope);
   return error_code;
 }
 
 int s21_sub_matrix(matrix_t *A, matrix_t *B, matrix_t *result) {
+  s21_stats_scope_t scope;
+  s21_stats_begin(&scope, S21_OP_SUB_MATRIX);
   int error_code = CALCULATION_ERROR;
 
   if (check_matrix(A) && check_matrix(B)) {
     if (check_eq_size(A, B)) {
-      error_code = s21_create_matrix(A->rows, A->columns, result);
+      error_code = create_matrix(A->rows, A->columns, FALSE, result);
     }
   } else {
     error_code = INCORRECT_MATRIX;
   }
 
   if (error_code == OK) {
-    for (int i = 0; i < A->rows; i++) {
-      for (int j = 0; j < A->columns; j++) {
-        result->matrix[i][j] = A->matrix[i][j] - B->matrix[i][j];
-      }
-    }
+    add_elements(A, B, -1, result);
+    s21_stats_add_flops(&scope, (double)A->rows * A->columns);
   }
+  s21_stats_end(&scope);
   return error_code;
 }
 
 int s21_mult_number(matrix_t *A, double number, matrix_t *result) {
+  s21_stats_scope_t scope;
+  s21_stats_begin(&scope, S21_OP_MULT_NUMBER);
   int error_code = CALCULATION_ERROR;
 
   if (check_matrix(A)) {
-    error_code = s21_create_matrix(A->rows, A->columns, result);
+    error_code = create_matrix(A->rows, A->columns, FALSE, result);
   } else {
     error_code = INCORRECT_MATRIX;
   }
 
   if (error_code == OK) {
-    for (int i = 0; i < A->rows; i++) {
-      for (int j = 0; j < A->columns; j++) {
-        result->matrix[i][j] = A->matrix[i][j] * number;
-      }
-    }
+    scale_elements(A, number, result);
+    s21_stats_add_flops(&scope, (double)A->rows * A->columns);
   }
+  s21_stats_end(&scope);
   return error_code;
 }
 
 int s21_mult_matrix(matrix_t *A, matrix_t *B, matrix_t *result) {
+  return s21_mult_matrix_ctx(NULL, A, B, result);
+}
+
+int s21_mult_matrix_ctx(s21_context_t *context, matrix_t *A, matrix_t *B,
+                        matrix_t *result) {
+  s21_stats_scope_t scope;
+  s21_stats_begin(&scope, S21_OP_MULT_MATRIX);
   int error_code = CALCULATION_ERROR;
 
   if (check_matrix(A) && check_matrix(B)) {
     if (A->columns == B->rows) {
-      error_code = s21_create_matrix(A->rows, B->columns, result);
+      error_code = create_matrix(A->rows, B->columns, FALSE, result);
     }
   } else {
     error_code = INCORRECT_MATRIX;
   }
 
   if (error_code == OK) {
-    for (int i = 0; i < result->rows; i++) {
-      for (int j = 0; j < result->columns; j++) {
-        for (int k = 0; k < A->columns; k++) {
-          result->matrix[i][j] += A->matrix[i][k] * B->matrix[k][j];
-        }
-      }
+    error_code = gemm_update(context, 1, A, FALSE, B, FALSE, 0, result);
+    if (error_code == OK) {
+      s21_stats_add_flops(&scope, 2.0 * A->rows * A->columns * B->columns);
+    } else {
+      s21_remove_matrix(result);
     }
   }
+  s21_stats_end(&scope);
   return error_code;
 }
 
 int s21_transpose(matrix_t *A, matrix_t *result) {
+  s21_stats_scope_t scope;
+  s21_stats_begin(&scope, S21_OP_TRANSPOSE);
   int error_code = CALCULATION_ERROR;
 
   if (check_matrix(A)) {
-    error_code = s21_create_matrix(A->columns, A->rows, result);
+    error_code = create_matrix(A->columns, A->rows, FALSE, result);
   } else {
     error_code = INCORRECT_MATRIX;
   }
 
   if (error_code == OK) {
-    for (int i = 0; i < result->rows; i++) {
-      for (int j = 0; j < result->columns; j++) {
-        result->matrix[i][j] = A->matrix[j][i];
-      }
-    }
+    transpose_elements(A, result);
   }
+  s21_stats_end(&scope);
   return error_code;
 }
 
 int s21_calc_complements(matrix_t *A, matrix_t *result) {
+  return s21_calc_complements_ctx(NULL, A, result);
+}
+
+int s21_calc_complements_ctx(s21_context_t *context, matrix_t *A,
+                             matrix_t *result) {
+  s21_stats_scope_t scope;
+  s21_stats_begin(&scope, S21_OP_CALC_COMPLEMENTS);
   int error_code = CALCULATION_ERROR;
 
   if (check_matrix(A)) {
     if (A->rows == A->columns) {
-      error_code = s21_create_matrix(A->rows, A->columns, result);
+      error_code = create_matrix(A->rows, A->columns, FALSE, result);
     }
   } else {
     error_code = INCORRECT_MATRIX;
   }
 
   if (error_code == OK) {
-    for (int i = 0; i < result->rows && error_code == OK; i++) {
-      for (int j = 0; j < result->columns && error_code == OK; j++) {
-        double determinant = 0;
-        matrix_t buffer = init_matrix();
-
-        error_code = create_minor_elements_matrix(A, &buffer, i, j);
-        error_code = s21_determinant(&buffer, &determinant);
-        result->matrix[i][j] = pow(-1, i + j) * determinant;
-        s21_remove_matrix(&buffer);
-      }
+    if (A->rows == 1) {
+      // the minor of a 1x1 matrix is empty, with a determinant of 1
+      result->matrix[0][0] = 1;
+    } else {
+      expansion_job_t job = {A, result, 0, NULL, NULL, 0};
+      error_code = run_expansion(context, complements_task, &job);
     }
   }
+
+  if (error_code == OK) {
+    s21_stats_add_flops(&scope, (double)A->rows * A->rows *
+                                    (determinant_flops(A->rows - 1) + 1));
+  } else if (check_matrix(A) && A->rows == A->columns) {
+    s21_remove_matrix(result);
+  }
+  s21_stats_end(&scope);
   return error_code;
 }
 
 int s21_determinant(matrix_t *A, double *result) {
+  return s21_determinant_ctx(NULL, A, result);
+}
+
+int s21_determinant_ctx(s21_context_t *context, matrix_t *A, double *result) {
+  s21_stats_scope_t scope;
+  s21_stats_begin(&scope, S21_OP_DETERMINANT);
   int error_code = CALCULATION_ERROR;
 
   if (check_matrix(A)) {
@@ -189,39 +350,38 @@ int s21_determinant(matrix_t *A, double *result) {
       *result = 0;
       error_code = OK;
 
-      if (A->rows == 1) {
-        *result = A->matrix[0][0];
-      } else if (A->rows == 2) {
-        *result = A->matrix[0][0] * A->matrix[1][1] -
-                  A->matrix[0][1] * A->matrix[1][0];
+      if (A->rows <= 2) {
+        *result = expand_determinant(A, NULL);
       } else {
-        matrix_t buffer = init_matrix();
-        int sign = 1;
-
-        for (int i = 0; i < A->columns && error_code == OK; i++) {
-          error_code = create_minor_elements_matrix(A, &buffer, 0, i);
-          double minor_result = 0;
-          error_code = s21_determinant(&buffer, &minor_result);
-
-          *result += A->matrix[0][i] * minor_result * sign;
-          sign = -1 * sign;
-          s21_remove_matrix(&buffer);
-        }
+        expansion_job_t job = {A, NULL, 0, NULL, NULL, 0};
+        error_code = run_expansion(context, determinant_task, &job);
+        *result = job.determinant;
+      }
+      if (error_code == OK) {
+        s21_stats_add_flops(&scope, determinant_flops(A->rows));
       }
     }
   } else {
     error_code = INCORRECT_MATRIX;
   }
+  s21_stats_end(&scope);
   return error_code;
 }
 
 int s21_inverse_matrix(matrix_t *A, matrix_t *result) {
+  return s21_inverse_matrix_ctx(NULL, A, result);
+}
+
+int s21_inverse_matrix_ctx(s21_context_t *context, matrix_t *A,
+                           matrix_t *result) {
+  s21_stats_scope_t scope;
+  s21_stats_begin(&scope, S21_OP_INVERSE_MATRIX);
   int error_code = CALCULATION_ERROR;
   double determinant = 0;
 
   if (check_matrix(A)) {
     if (A->rows == A->columns) {
-      error_code = s21_determinant(A, &determinant);
+      error_code = s21_determinant_ctx(context, A, &determinant);
     }
   } else {
     error_code = INCORRECT_MATRIX;
@@ -232,15 +392,26 @@ int s21_inverse_matrix(matrix_t *A, matrix_t *result) {
       matrix_t m_complements = init_matrix();
       matrix_t m_transposed = init_matrix();
 
-      error_code = s21_calc_complements(A, &m_complements);
-      error_code = s21_transpose(&m_complements, &m_transposed);
-      error_code = s21_mult_number(&m_transposed, 1.0 / determinant, result);
+      error_code = s21_calc_complements_ctx(context, A, &m_complements);
+      if (error_code == OK) {
+        error_code = s21_transpose(&m_complements, &m_transposed);
+      }
+      if (error_code == OK) {
+        error_code =
+            s21_mult_number(&m_transposed, 1.0 / determinant, result);
+      }
 
       s21_remove_matrix(&m_complements);
       s21_remove_matrix(&m_transposed);
+      s21_stats_add_flops(
+          &scope, determinant_flops(A->rows) +
+                      (double)A->rows * A->rows *
+                          (determinant_flops(A->rows - 1) + 2) +
+                      1);
     } else {
       error_code = CALCULATION_ERROR;
     }
   }
+  s21_stats_end(&scope);
   return error_code;
 }
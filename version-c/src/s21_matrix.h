@@ -2,6 +2,7 @@
 #define SRC_S21_MATRIX_H_
 
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
@@ -14,12 +15,110 @@
 #define CALCULATION_ERROR 2
 #define MEMORY_ERROR 3
 
+// the elements of a matrix start on a cache line boundary
+#define MATRIX_ALIGNMENT 64
+
 typedef struct matrix_struct {
   double **matrix;
   int rows;
   int columns;
 } matrix_t;
 
+// stats: opt-in per-operation instrumentation (calls, wall time histogram,
+// allocated bytes, flops). disabled by default, enabled with
+// s21_stats_set_enabled(TRUE) or the S21_MATRIX_STATS=1 environment variable,
+// compiled out with -DS21_MATRIX_NO_STATS
+
+#define S21_STATS_BUCKETS 13
+
+typedef enum s21_operation {
+  S21_OP_CREATE_MATRIX,
+  S21_OP_EQ_MATRIX,
+  S21_OP_SUM_MATRIX,
+  S21_OP_SUB_MATRIX,
+  S21_OP_MULT_NUMBER,
+  S21_OP_MULT_MATRIX,
+  S21_OP_TRANSPOSE,
+  S21_OP_CALC_COMPLEMENTS,
+  S21_OP_DETERMINANT,
+  S21_OP_INVERSE_MATRIX,
+  S21_OP_GEMM,
+  S21_OP_COUNT
+} s21_operation_t;
+
+typedef struct s21_operation_stats {
+  const char *name;
+  unsigned long long calls;
+  unsigned long long nanoseconds;
+  unsigned long long flops;
+  unsigned long long allocated_bytes;
+  unsigned long long histogram[S21_STATS_BUCKETS];
+} s21_operation_stats_t;
+
+typedef struct s21_stats_scope {
+  s21_operation_t operation;
+  int active;
+  unsigned long long flops;
+  unsigned long long allocated_bytes;
+  struct timespec start;
+} s21_stats_scope_t;
+
+// memory: every matrix buffer goes through s21_allocate/s21_deallocate. the
+// allocation functions can be replaced with s21_set_allocator, live bytes,
+// peak bytes and allocation counts are kept per thread and for the whole
+// process. S21_MATRIX_MEMORY_REPORT=1 prints the process totals (and the
+// leaked bytes) to stderr at exit
+
+typedef struct s21_allocator {
+  // returns NULL on failure
+  void *(*allocate)(size_t size, void *context);
+  void (*deallocate)(void *pointer, size_t size, void *context);
+  void *context;
+} s21_allocator_t;
+
+typedef struct s21_memory_stats {
+  // signed: a thread can release memory allocated by another one
+  long long live_bytes;
+  long long peak_bytes;
+  unsigned long long allocations;
+  unsigned long long deallocations;
+} s21_memory_stats_t;
+
+typedef struct s21_memory_scope {
+  s21_memory_stats_t start;
+  long long outer_peak;
+} s21_memory_scope_t;
+
+// context: a thread pool, a random number generator (xoshiro256**) and a
+// scratch arena owned by one calling thread. the _ctx operations split their
+// work over the pool and take their temporaries from the arena, a NULL
+// context runs them on the calling thread (and s21_context_random on
+// rand()). threads that each use their own context share nothing. a context
+// isn't synchronized: one thread at a time, and not from inside its own
+// operations
+
+typedef struct s21_context s21_context_t;
+
+typedef struct s21_context_config {
+  // 0: the S21_MATRIX_THREADS environment variable, or the online CPUs
+  int threads;
+  unsigned long long seed;
+} s21_context_config_t;
+
+// body(arg, task, worker), worker in [0, s21_context_threads(context))
+typedef void (*context_body_t)(void *arg, int task, int worker);
+
+// compare: two elements are close when they are equal, or their difference
+// is within absolute, or within relative times the larger magnitude, or
+// they are at most ulps representable doubles apart. NaN is never close.
+// s21_eq_matrix is the absolute 1e-7 case
+
+typedef struct s21_tolerance {
+  double absolute;
+  double relative;
+  long long ulps;
+} s21_tolerance_t;
+
 // main
 int s21_create_matrix(int rows, int columns, matrix_t *result);
 void s21_remove_matrix(matrix_t *A);
@@ -32,19 +131,139 @@ int s21_transpose(matrix_t *A, matrix_t *result);
 int s21_calc_complements(matrix_t *A, matrix_t *result);
 int s21_determinant(matrix_t *A, double *result);
 int s21_inverse_matrix(matrix_t *A, matrix_t *result);
+int s21_gemm(double alpha, matrix_t *A, int trans_a, matrix_t *B,
+             int trans_b, double beta, matrix_t *C);
+
+// into: the same operations writing into an existing result of the right
+// size (CALCULATION_ERROR otherwise) instead of creating it, so they never
+// allocate. the exception is the packing panel of a larger product, which
+// s21_mult_matrix_into allocates per call and s21_mult_matrix_into_ctx takes
+// from the context arena (allocated once, by the first call of a size).
+// result may be A or B, except for the products and s21_transpose_into,
+// which reject a result sharing storage with an operand. the in-place
+// variants update A
+int s21_sum_matrix_into(matrix_t *A, matrix_t *B, matrix_t *result);
+int s21_sub_matrix_into(matrix_t *A, matrix_t *B, matrix_t *result);
+int s21_mult_number_into(matrix_t *A, double number, matrix_t *result);
+int s21_mult_matrix_into(matrix_t *A, matrix_t *B, matrix_t *result);
+int s21_mult_matrix_into_ctx(s21_context_t *context, matrix_t *A,
+                             matrix_t *B, matrix_t *result);
+int s21_transpose_into(matrix_t *A, matrix_t *result);
+int s21_sum_matrix_inplace(matrix_t *A, matrix_t *B);
+int s21_sub_matrix_inplace(matrix_t *A, matrix_t *B);
+int s21_mult_number_inplace(matrix_t *A, double number);
+
+// compare: s21_approx_equal returns TRUE/FALSE (FALSE for a negative
+// tolerance), s21_find_mismatch gives the first element that isn't close in
+// row-major order, or -1, -1. CALCULATION_ERROR for different sizes
+int s21_approx_equal(matrix_t *A, matrix_t *B, s21_tolerance_t tolerance);
+int s21_find_mismatch(matrix_t *A, matrix_t *B, s21_tolerance_t tolerance,
+                      int *row, int *column);
+int s21_find_mismatch_ctx(s21_context_t *context, matrix_t *A, matrix_t *B,
+                          s21_tolerance_t tolerance, int *row, int *column);
+
+// context
+int s21_context_create(const s21_context_config_t *config,
+                       s21_context_t **result);
+void s21_context_destroy(s21_context_t *context);
+int s21_context_threads(s21_context_t *context);
+double s21_context_random(s21_context_t *context, double min, double max);
+int s21_fill_random(s21_context_t *context, matrix_t *A, double min,
+                    double max);
+int s21_mult_matrix_ctx(s21_context_t *context, matrix_t *A, matrix_t *B,
+                        matrix_t *result);
+int s21_gemm_ctx(s21_context_t *context, double alpha, matrix_t *A,
+                 int trans_a, matrix_t *B, int trans_b, double beta,
+                 matrix_t *C);
+int s21_determinant_ctx(s21_context_t *context, matrix_t *A, double *result);
+int s21_calc_complements_ctx(s21_context_t *context, matrix_t *A,
+                             matrix_t *result);
+int s21_inverse_matrix_ctx(s21_context_t *context, matrix_t *A,
+                           matrix_t *result);
 
 // helpers
 matrix_t init_matrix();
+size_t matrix_bytes(int rows, int columns);
+double **layout_matrix(void *block, int rows, int columns);
 double **allocate_matrix(int rows, int columns);
-void free_matrix(int rows, double **array);
+double **allocate_zeroed_matrix(int rows, int columns);
+int create_matrix(int rows, int columns, int zeroed, matrix_t *result);
+void free_matrix(int rows, int columns, double **array);
 int check_matrix(matrix_t *matrix);
 int check_eq_size(matrix_t *m1, matrix_t *m2);
 void fill_matrix_zero(matrix_t *matrix);
+void add_elements(matrix_t *A, matrix_t *B, double sign, matrix_t *result);
+void scale_elements(matrix_t *A, double number, matrix_t *result);
+void transpose_elements(matrix_t *A, matrix_t *result);
+int check_tolerance(s21_tolerance_t tolerance);
+int close_elements(double a, double b, const s21_tolerance_t *tolerance);
+int row_mismatch(const double *a, const double *b, int size,
+                 const s21_tolerance_t *tolerance);
+long long first_mismatch(matrix_t *A, matrix_t *B, int begin, int end,
+                         const s21_tolerance_t *tolerance);
 void fill_matrix_increment(matrix_t *matrix, int value);
 void fill_matrix_range(matrix_t *matrix, double minvalue, double maxvalue);
 double generate_value_in_range(double min, double max);
 void print_matrix(matrix_t *matrix);
 int create_minor_elements_matrix(matrix_t *origin, matrix_t *result,
                                  int index_rows, int index_columns);
+void fill_minor(matrix_t *origin, matrix_t *result, int index_rows,
+                int index_columns);
+size_t minors_bytes(int size);
+matrix_t *layout_minors(void *block, int size);
+double expand_determinant(matrix_t *A, matrix_t *minors);
+double determinant_flops(int size);
+int gemm_update(s21_context_t *context, double alpha, matrix_t *A,
+                int trans_a, matrix_t *B, int trans_b, double beta,
+                matrix_t *C);
+void context_parallel_for(s21_context_t *context, int tasks,
+                          context_body_t body, void *arg);
+void *scratch_acquire(s21_context_t *context, size_t bytes);
+void scratch_release(s21_context_t *context, void *block, size_t bytes);
+
+// stats
+void s21_stats_set_enabled(int enabled);
+int s21_stats_is_enabled();
+void s21_stats_reset();
+void s21_stats_snapshot(s21_operation_stats_t result[S21_OP_COUNT]);
+unsigned long long s21_stats_histogram_bound(int bucket);
+int s21_stats_to_json(char *buffer, size_t size);
+int s21_stats_to_prometheus(char *buffer, size_t size);
+#ifdef S21_MATRIX_NO_STATS
+static inline void s21_stats_begin(s21_stats_scope_t *scope,
+                                   s21_operation_t operation) {
+  (void)scope;
+  (void)operation;
+}
+static inline void s21_stats_add_flops(s21_stats_scope_t *scope,
+                                       double flops) {
+  (void)scope;
+  (void)flops;
+}
+static inline void s21_stats_add_allocated_bytes(size_t bytes) {
+  (void)bytes;
+}
+static inline void s21_stats_end(s21_stats_scope_t *scope) { (void)scope; }
+#else
+void s21_stats_begin(s21_stats_scope_t *scope, s21_operation_t operation);
+void s21_stats_add_flops(s21_stats_scope_t *scope, double flops);
+void s21_stats_add_allocated_bytes(size_t bytes);
+void s21_stats_end(s21_stats_scope_t *scope);
+#endif
+
+// memory
+void s21_set_allocator(const s21_allocator_t *allocator);
+void *s21_allocate(size_t size);
+void *s21_allocate_zeroed(size_t size);
+void s21_deallocate(void *pointer, size_t size);
+void s21_memory_thread_stats(s21_memory_stats_t *result);
+void s21_memory_process_stats(s21_memory_stats_t *result);
+void s21_memory_reset_thread_stats();
+void s21_memory_print_report(FILE *stream);
+void s21_memory_scope_begin(s21_memory_scope_t *scope);
+void s21_memory_scope_delta(s21_memory_scope_t *scope,
+                            s21_memory_stats_t *result);
+void s21_memory_scope_end(s21_memory_scope_t *scope,
+                          s21_memory_stats_t *result);
 
 #endif  // SRC_S21_MATRIX_H_
@@ -0,0 +1,190 @@
+#include <stdatomic.h>
+#include <string.h>
+
+#include "s21_matrix.h"
+
+static void *default_allocate(size_t size, void *context) {
+  (void)context;
+  return malloc(size);
+}
+
+static void default_deallocate(void *pointer, size_t size, void *context) {
+  (void)size;
+  (void)context;
+  free(pointer);
+}
+
+// not synchronized with running allocations: install the allocator before
+// any matrix is created, memory is always released through the allocator
+// that allocated it
+static s21_allocator_t allocator = {default_allocate, default_deallocate,
+                                    NULL};
+
+static _Thread_local s21_memory_stats_t thread_stats = {0, 0, 0, 0};
+
+static atomic_llong process_live_bytes = 0;
+static atomic_llong process_peak_bytes = 0;
+static atomic_ullong process_allocations = 0;
+static atomic_ullong process_deallocations = 0;
+static atomic_flag report_checked = ATOMIC_FLAG_INIT;
+
+static void report_at_exit() { s21_memory_print_report(stderr); }
+
+// the exit report is registered by the first allocation, the library has no
+// initialization function of its own
+static void register_report() {
+  if (!atomic_flag_test_and_set(&report_checked)) {
+    const char *variable = getenv("S21_MATRIX_MEMORY_REPORT");
+    if (variable && variable[0] == '1') {
+      atexit(report_at_exit);
+    }
+  }
+}
+
+static void update_process_peak(long long live) {
+  long long peak =
+      atomic_load_explicit(&process_peak_bytes, memory_order_relaxed);
+
+  while (live > peak && !atomic_compare_exchange_weak_explicit(
+                            &process_peak_bytes, &peak, live,
+                            memory_order_relaxed, memory_order_relaxed)) {
+  }
+}
+
+void s21_set_allocator(const s21_allocator_t *new_allocator) {
+  if (new_allocator) {
+    allocator = *new_allocator;
+  } else {
+    allocator.allocate = default_allocate;
+    allocator.deallocate = default_deallocate;
+    allocator.context = NULL;
+  }
+}
+
+static void count_allocation(void *result, size_t size) {
+  register_report();
+  if (result) {
+    long long bytes = (long long)size;
+
+    thread_stats.live_bytes += bytes;
+    if (thread_stats.live_bytes > thread_stats.peak_bytes) {
+      thread_stats.peak_bytes = thread_stats.live_bytes;
+    }
+    thread_stats.allocations++;
+
+    update_process_peak(atomic_fetch_add_explicit(&process_live_bytes, bytes,
+                                                  memory_order_relaxed) +
+                        bytes);
+    atomic_fetch_add_explicit(&process_allocations, 1, memory_order_relaxed);
+    s21_stats_add_allocated_bytes(size);
+  }
+}
+
+void *s21_allocate(size_t size) {
+  void *result = allocator.allocate(size, allocator.context);
+
+  count_allocation(result, size);
+  return result;
+}
+
+// the default allocator zeroes through calloc, which hands large blocks out
+// as fresh pages the OS zeroes on first touch, so untouched elements cost
+// nothing. other allocators are cleared with memset
+void *s21_allocate_zeroed(size_t size) {
+  void *result = NULL;
+
+  if (allocator.allocate == default_allocate) {
+    result = calloc(1, size);
+  } else {
+    result = allocator.allocate(size, allocator.context);
+    if (result) {
+      memset(result, 0, size);
+    }
+  }
+  count_allocation(result, size);
+  return result;
+}
+
+void s21_deallocate(void *pointer, size_t size) {
+  if (pointer) {
+    allocator.deallocate(pointer, size, allocator.context);
+
+    thread_stats.live_bytes -= (long long)size;
+    thread_stats.deallocations++;
+
+    atomic_fetch_sub_explicit(&process_live_bytes, (long long)size,
+                              memory_order_relaxed);
+    atomic_fetch_add_explicit(&process_deallocations, 1,
+                              memory_order_relaxed);
+  }
+}
+
+void s21_memory_thread_stats(s21_memory_stats_t *result) {
+  if (result) {
+    *result = thread_stats;
+  }
+}
+
+void s21_memory_process_stats(s21_memory_stats_t *result) {
+  if (result) {
+    result->live_bytes =
+        atomic_load_explicit(&process_live_bytes, memory_order_relaxed);
+    result->peak_bytes =
+        atomic_load_explicit(&process_peak_bytes, memory_order_relaxed);
+    result->allocations =
+        atomic_load_explicit(&process_allocations, memory_order_relaxed);
+    result->deallocations =
+        atomic_load_explicit(&process_deallocations, memory_order_relaxed);
+  }
+}
+
+void s21_memory_reset_thread_stats() {
+  thread_stats.live_bytes = 0;
+  thread_stats.peak_bytes = 0;
+  thread_stats.allocations = 0;
+  thread_stats.deallocations = 0;
+}
+
+void s21_memory_print_report(FILE *stream) {
+  s21_memory_stats_t stats;
+  s21_memory_process_stats(&stats);
+
+  fprintf(stream,
+          "s21_matrix memory: peak %lld bytes, %llu allocations, "
+          "%llu deallocations, %lld bytes live\n",
+          stats.peak_bytes, stats.allocations, stats.deallocations,
+          stats.live_bytes);
+  if (stats.live_bytes > 0) {
+    fprintf(stream, "s21_matrix memory: %lld bytes leaked\n",
+            stats.live_bytes);
+  }
+}
+
+// the thread peak restarts from the current live bytes, so it measures the
+// high-water mark of the scope, the outer value is restored by
+// s21_memory_scope_end. scopes nest, they must end in reverse order
+void s21_memory_scope_begin(s21_memory_scope_t *scope) {
+  scope->start = thread_stats;
+  scope->outer_peak = thread_stats.peak_bytes;
+  thread_stats.peak_bytes = thread_stats.live_bytes;
+}
+
+void s21_memory_scope_delta(s21_memory_scope_t *scope,
+                            s21_memory_stats_t *result) {
+  result->live_bytes = thread_stats.live_bytes - scope->start.live_bytes;
+  result->peak_bytes = thread_stats.peak_bytes - scope->start.live_bytes;
+  result->allocations = thread_stats.allocations - scope->start.allocations;
+  result->deallocations =
+      thread_stats.deallocations - scope->start.deallocations;
+}
+
+// result may be NULL when only the scope has to be closed
+void s21_memory_scope_end(s21_memory_scope_t *scope,
+                          s21_memory_stats_t *result) {
+  if (result) {
+    s21_memory_scope_delta(scope, result);
+  }
+  if (scope->outer_peak > thread_stats.peak_bytes) {
+    thread_stats.peak_bytes = scope->outer_peak;
+  }
+}
@@ -0,0 +1,305 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+#include "s21_matrix.h"
+
+// fill: the matrix is split into blocks of whole rows, about
+// FILL_BLOCK_ELEMENTS each, and every block draws from its own stream, so
+// the values don't depend on the worker filling a block or on how many
+// workers there are
+#define FILL_BLOCK_ELEMENTS 4096
+
+typedef struct context_worker {
+  pthread_t thread;
+  s21_context_t *context;
+  int index;
+} context_worker_t;
+
+struct s21_context {
+  int threads;
+  unsigned long long rng[4];
+  void *scratch;
+  size_t scratch_bytes;
+
+  // the pool: threads - 1 workers, the calling thread is worker 0
+  context_worker_t *workers;
+  pthread_mutex_t mutex;
+  pthread_cond_t wake;
+  pthread_cond_t done;
+  unsigned long long generation;
+  int busy;
+  int stop;
+
+  // the current job
+  context_body_t body;
+  void *arg;
+  int tasks;
+  atomic_int next_task;
+};
+
+// rng: xoshiro256**, seeded through splitmix64
+
+static unsigned long long splitmix64(unsigned long long *state) {
+  unsigned long long z = (*state += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+static unsigned long long rotl(unsigned long long x, int k) {
+  return (x << k) | (x >> (64 - k));
+}
+
+static unsigned long long next_random(unsigned long long *s) {
+  unsigned long long result = rotl(s[1] * 5, 7) * 9;
+  unsigned long long t = s[1] << 17;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl(s[3], 45);
+  return result;
+}
+
+// a uniform double in [min, max) from the top 53 bits
+static double random_in_range(unsigned long long *s, double min, double max) {
+  return min + (next_random(s) >> 11) * 0x1.0p-53 * (max - min);
+}
+
+typedef struct fill_job {
+  matrix_t *A;
+  double min;
+  double max;
+  unsigned long long seed;
+  int block_rows;
+} fill_job_t;
+
+// the stream of a block is seeded with splitmix64 outputs 4 * task + 1 to
+// 4 * task + 4 after the seed of the call, no two blocks share one
+static void fill_task(void *arg, int task, int worker) {
+  fill_job_t *job = arg;
+  unsigned long long state = job->seed + 4ull * task * 0x9E3779B97F4A7C15ull;
+  unsigned long long rng[4];
+  int begin = task * job->block_rows;
+  int end = begin + job->block_rows;
+
+  (void)worker;
+  for (int i = 0; i < 4; i++) {
+    rng[i] = splitmix64(&state);
+  }
+  for (int i = begin; i < end && i < job->A->rows; i++) {
+    for (int j = 0; j < job->A->columns; j++) {
+      job->A->matrix[i][j] = random_in_range(rng, job->min, job->max);
+    }
+  }
+}
+
+// pool
+
+static void run_tasks(s21_context_t *context, int worker) {
+  int task = atomic_fetch_add_explicit(&context->next_task, 1,
+                                       memory_order_relaxed);
+
+  while (task < context->tasks) {
+    context->body(context->arg, task, worker);
+    task = atomic_fetch_add_explicit(&context->next_task, 1,
+                                     memory_order_relaxed);
+  }
+}
+
+static void *worker_main(void *argument) {
+  context_worker_t *self = argument;
+  s21_context_t *context = self->context;
+  unsigned long long seen = 0;
+
+  pthread_mutex_lock(&context->mutex);
+  while (!context->stop) {
+    if (context->generation != seen) {
+      seen = context->generation;
+      pthread_mutex_unlock(&context->mutex);
+      run_tasks(context, self->index);
+      pthread_mutex_lock(&context->mutex);
+      if (--context->busy == 0) {
+        pthread_cond_signal(&context->done);
+      }
+    } else {
+      pthread_cond_wait(&context->wake, &context->mutex);
+    }
+  }
+  pthread_mutex_unlock(&context->mutex);
+  return NULL;
+}
+
+static int default_threads() {
+  long result = sysconf(_SC_NPROCESSORS_ONLN);
+  const char *variable = getenv("S21_MATRIX_THREADS");
+
+  if (variable && atoi(variable) > 0) {
+    result = atoi(variable);
+  }
+  return result > 0 ? (int)result : 1;
+}
+
+static void stop_workers(s21_context_t *context, int started) {
+  pthread_mutex_lock(&context->mutex);
+  context->stop = TRUE;
+  pthread_cond_broadcast(&context->wake);
+  pthread_mutex_unlock(&context->mutex);
+  for (int i = 0; i < started; i++) {
+    pthread_join(context->workers[i].thread, NULL);
+  }
+}
+
+// main
+
+int s21_context_create(const s21_context_config_t *config,
+                       s21_context_t **result) {
+  int error_code = INCORRECT_MATRIX;
+
+  if (result && (!config || config->threads >= 0)) {
+    s21_context_t *context = calloc(1, sizeof(s21_context_t));
+    int threads = config && config->threads ? config->threads
+                                            : default_threads();
+    unsigned long long seed = config ? config->seed : 0;
+    int started = 0;
+
+    error_code = MEMORY_ERROR;
+    if (context) {
+      context->threads = threads;
+      for (int i = 0; i < 4; i++) {
+        context->rng[i] = splitmix64(&seed);
+      }
+      pthread_mutex_init(&context->mutex, NULL);
+      pthread_cond_init(&context->wake, NULL);
+      pthread_cond_init(&context->done, NULL);
+      context->workers = calloc(threads, sizeof(context_worker_t));
+
+      if (context->workers) {
+        error_code = OK;
+        while (started < threads - 1 && error_code == OK) {
+          context_worker_t *worker = &context->workers[started];
+          worker->context = context;
+          worker->index = started + 1;
+          if (pthread_create(&worker->thread, NULL, worker_main, worker)) {
+            error_code = MEMORY_ERROR;
+          } else {
+            started++;
+          }
+        }
+      }
+
+      if (error_code != OK) {
+        stop_workers(context, started);
+        s21_context_destroy(context);
+        context = NULL;
+      }
+    }
+    *result = context;
+  }
+  return error_code;
+}
+
+void s21_context_destroy(s21_context_t *context) {
+  if (context) {
+    if (!context->stop) {
+      stop_workers(context, context->threads - 1);
+    }
+    s21_deallocate(context->scratch, context->scratch_bytes);
+    pthread_mutex_destroy(&context->mutex);
+    pthread_cond_destroy(&context->wake);
+    pthread_cond_destroy(&context->done);
+    free(context->workers);
+    free(context);
+  }
+}
+
+int s21_context_threads(s21_context_t *context) {
+  return context ? context->threads : 1;
+}
+
+// without a context the value comes from rand(), like fill_matrix_range
+double s21_context_random(s21_context_t *context, double min, double max) {
+  return context ? random_in_range(context->rng, min, max)
+                 : generate_value_in_range(min, max);
+}
+
+// a call takes one value of the context sequence as the seed of its blocks
+int s21_fill_random(s21_context_t *context, matrix_t *A, double min,
+                    double max) {
+  int error_code = INCORRECT_MATRIX;
+
+  if (check_matrix(A)) {
+    if (context) {
+      fill_job_t job = {A, min, max, next_random(context->rng), 1};
+      if (A->columns < FILL_BLOCK_ELEMENTS) {
+        job.block_rows = FILL_BLOCK_ELEMENTS / A->columns;
+      }
+      context_parallel_for(context,
+                           (A->rows + job.block_rows - 1) / job.block_rows,
+                           fill_task, &job);
+    } else {
+      fill_matrix_range(A, min, max);
+    }
+    error_code = OK;
+  }
+  return error_code;
+}
+
+// helpers
+
+void context_parallel_for(s21_context_t *context, int tasks,
+                          context_body_t body, void *arg) {
+  if (!context || context->threads == 1 || tasks < 2) {
+    for (int task = 0; task < tasks; task++) {
+      body(arg, task, 0);
+    }
+  } else {
+    pthread_mutex_lock(&context->mutex);
+    context->body = body;
+    context->arg = arg;
+    context->tasks = tasks;
+    atomic_store_explicit(&context->next_task, 0, memory_order_relaxed);
+    context->busy = context->threads - 1;
+    context->generation++;
+    pthread_cond_broadcast(&context->wake);
+    pthread_mutex_unlock(&context->mutex);
+
+    run_tasks(context, 0);
+
+    pthread_mutex_lock(&context->mutex);
+    while (context->busy) {
+      pthread_cond_wait(&context->done, &context->mutex);
+    }
+    pthread_mutex_unlock(&context->mutex);
+  }
+}
+
+// the context arena only grows, so after the first call of a given size an
+// operation no longer allocates. without a context the block is allocated
+// and released around the call
+void *scratch_acquire(s21_context_t *context, size_t bytes) {
+  void *result = NULL;
+
+  if (!context) {
+    result = s21_allocate(bytes);
+  } else {
+    if (context->scratch_bytes < bytes) {
+      s21_deallocate(context->scratch, context->scratch_bytes);
+      context->scratch = s21_allocate(bytes);
+      context->scratch_bytes = context->scratch ? bytes : 0;
+    }
+    result = context->scratch;
+  }
+  return result;
+}
+
+void scratch_release(s21_context_t *context, void *block, size_t bytes) {
+  if (!context) {
+    s21_deallocate(block, bytes);
+  }
+}
@@ -0,0 +1,221 @@
+#include "s21_matrix.h"
+
+// the kernel walks C in GEMM_BLOCK_K x GEMM_BLOCK_N panels of B, packed
+// into one contiguous buffer (which is also where a transposed B is turned
+// around), four rows of C at a time share each row of the panel
+#define GEMM_BLOCK_K 128
+#define GEMM_BLOCK_N 512
+#define GEMM_TILE 16
+// panels up to this many elements (16 KiB) live on the stack, so products
+// of small matrices never allocate
+#define GEMM_STACK_PANEL 2048
+// with a context, rows of C are split into blocks of at least GEMM_MIN_ROWS
+// once the product reaches GEMM_PARALLEL_FLOPS, every block packs its own
+// panels
+#define GEMM_MIN_ROWS 32
+#define GEMM_PARALLEL_FLOPS (1 << 21)
+
+typedef struct gemm_job {
+  double alpha;
+  matrix_t *A;
+  int trans_a;
+  matrix_t *B;
+  int trans_b;
+  double beta;
+  matrix_t *C;
+  int k;
+  int block_rows;
+  double *panels;
+  size_t panel_size;
+} gemm_job_t;
+
+static double operand_at(matrix_t *A, int transposed, int i, int p) {
+  return transposed ? A->matrix[p][i] : A->matrix[i][p];
+}
+
+static int min_int(int a, int b) { return a < b ? a : b; }
+
+static void pack_panel(matrix_t *B, int trans_b, int kk, int k_end, int jj,
+                       int width, double *panel) {
+  if (trans_b) {
+    for (int j_tile = 0; j_tile < width; j_tile += GEMM_TILE) {
+      for (int p_tile = kk; p_tile < k_end; p_tile += GEMM_TILE) {
+        for (int j = j_tile; j < min_int(width, j_tile + GEMM_TILE); j++) {
+          for (int p = p_tile; p < min_int(k_end, p_tile + GEMM_TILE); p++) {
+            panel[(p - kk) * width + j] = B->matrix[jj + j][p];
+          }
+        }
+      }
+    }
+  } else {
+    for (int p = kk; p < k_end; p++) {
+      for (int j = 0; j < width; j++) {
+        panel[(p - kk) * width + j] = B->matrix[p][jj + j];
+      }
+    }
+  }
+}
+
+static void scale_rows(matrix_t *C, double beta, int begin, int end) {
+  for (int i = begin; i < end; i++) {
+    for (int j = 0; j < C->columns; j++) {
+      C->matrix[i][j] = beta == 0 ? 0 : beta * C->matrix[i][j];
+    }
+  }
+}
+
+static void update_rows(double alpha, matrix_t *A, int trans_a,
+                        const double *panel, matrix_t *C, int begin, int end,
+                        int kk, int k_end, int jj, int width) {
+  int i = begin;
+
+  for (; i + 4 <= end; i += 4) {
+    double *restrict c0 = C->matrix[i] + jj;
+    double *restrict c1 = C->matrix[i + 1] + jj;
+    double *restrict c2 = C->matrix[i + 2] + jj;
+    double *restrict c3 = C->matrix[i + 3] + jj;
+
+    for (int p = kk; p < k_end; p++) {
+      const double *restrict b_row = panel + (p - kk) * width;
+      double a0 = alpha * operand_at(A, trans_a, i, p);
+      double a1 = alpha * operand_at(A, trans_a, i + 1, p);
+      double a2 = alpha * operand_at(A, trans_a, i + 2, p);
+      double a3 = alpha * operand_at(A, trans_a, i + 3, p);
+
+      for (int j = 0; j < width; j++) {
+        c0[j] += a0 * b_row[j];
+        c1[j] += a1 * b_row[j];
+        c2[j] += a2 * b_row[j];
+        c3[j] += a3 * b_row[j];
+      }
+    }
+  }
+
+  for (; i < end; i++) {
+    double *restrict c_row = C->matrix[i] + jj;
+
+    for (int p = kk; p < k_end; p++) {
+      const double *restrict b_row = panel + (p - kk) * width;
+      double value = alpha * operand_at(A, trans_a, i, p);
+
+      for (int j = 0; j < width; j++) {
+        c_row[j] += value * b_row[j];
+      }
+    }
+  }
+}
+
+static void gemm_rows(gemm_job_t *job, int begin, int end, double *panel) {
+  matrix_t *C = job->C;
+
+  if (job->beta != 1) {
+    scale_rows(C, job->beta, begin, end);
+  }
+  for (int kk = 0; kk < job->k; kk += GEMM_BLOCK_K) {
+    int k_end = min_int(job->k, kk + GEMM_BLOCK_K);
+
+    for (int jj = 0; jj < C->columns; jj += GEMM_BLOCK_N) {
+      int width = min_int(C->columns, jj + GEMM_BLOCK_N) - jj;
+
+      pack_panel(job->B, job->trans_b, kk, k_end, jj, width, panel);
+      update_rows(job->alpha, job->A, job->trans_a, panel, C, begin, end, kk,
+                  k_end, jj, width);
+    }
+  }
+}
+
+static void gemm_task(void *arg, int task, int worker) {
+  gemm_job_t *job = arg;
+  int begin = task * job->block_rows;
+
+  gemm_rows(job, begin, min_int(job->C->rows, begin + job->block_rows),
+            job->panels + worker * job->panel_size);
+}
+
+// C = alpha * op(A) * op(B) + beta * C for matrices already checked by the
+// caller, C must not share storage with A or B. beta == 0 overwrites C
+// without reading it, like BLAS
+int gemm_update(s21_context_t *context, double alpha, matrix_t *A,
+                int trans_a, matrix_t *B, int trans_b, double beta,
+                matrix_t *C) {
+  int error_code = OK;
+  int workers = s21_context_threads(context);
+  gemm_job_t job = {alpha, A, trans_a, B, trans_b, beta, C,
+                    trans_a ? A->rows : A->columns, C->rows, NULL, 0};
+  job.panel_size = (size_t)min_int(job.k, GEMM_BLOCK_K) *
+                   min_int(C->columns, GEMM_BLOCK_N);
+
+  if (workers > 1 &&
+      2.0 * C->rows * job.k * C->columns >= GEMM_PARALLEL_FLOPS) {
+    int rows = (C->rows + 2 * workers - 1) / (2 * workers);
+    job.block_rows = (rows < GEMM_MIN_ROWS ? GEMM_MIN_ROWS : rows + 3) / 4 * 4;
+  }
+  int tasks = (C->rows + job.block_rows - 1) / job.block_rows;
+
+  if (tasks == 1 && job.panel_size <= GEMM_STACK_PANEL) {
+    double stack_panel[GEMM_STACK_PANEL];
+    gemm_rows(&job, 0, C->rows, stack_panel);
+  } else {
+    size_t bytes = sizeof(double) * job.panel_size * (tasks > 1 ? workers : 1);
+    job.panels = scratch_acquire(context, bytes);
+
+    if (job.panels) {
+      context_parallel_for(context, tasks, gemm_task, &job);
+      scratch_release(context, job.panels, bytes);
+    } else {
+      error_code = MEMORY_ERROR;
+    }
+  }
+  return error_code;
+}
+
+int s21_gemm(double alpha, matrix_t *A, int trans_a, matrix_t *B,
+             int trans_b, double beta, matrix_t *C) {
+  return s21_gemm_ctx(NULL, alpha, A, trans_a, B, trans_b, beta, C);
+}
+
+int s21_gemm_ctx(s21_context_t *context, double alpha, matrix_t *A,
+                 int trans_a, matrix_t *B, int trans_b, double beta,
+                 matrix_t *C) {
+  s21_stats_scope_t scope;
+  s21_stats_begin(&scope, S21_OP_GEMM);
+  int error_code = CALCULATION_ERROR;
+
+  if (check_matrix(A) && check_matrix(B) && check_matrix(C)) {
+    int m = trans_a ? A->columns : A->rows;
+    int k = trans_a ? A->rows : A->columns;
+    int n = trans_b ? B->rows : B->columns;
+
+    if (k == (trans_b ? B->columns : B->rows) && m == C->rows &&
+        n == C->columns) {
+      matrix_t copy = init_matrix();
+      matrix_t *source = C;
+
+      // an operand sharing storage with C is read from a copy
+      if (C->matrix == A->matrix || C->matrix == B->matrix) {
+        error_code = create_matrix(C->rows, C->columns, FALSE, &copy);
+        for (int i = 0; i < copy.rows && error_code == OK; i++) {
+          for (int j = 0; j < copy.columns; j++) {
+            copy.matrix[i][j] = C->matrix[i][j];
+          }
+        }
+        source = &copy;
+      } else {
+        error_code = OK;
+      }
+
+      if (error_code == OK) {
+        error_code = gemm_update(
+            context, alpha, C->matrix == A->matrix ? source : A, trans_a,
+            C->matrix == B->matrix ? source : B, trans_b, beta, C);
+        s21_stats_add_flops(&scope,
+                            2.0 * m * k * n + (beta != 0 ? 1.0 * m * n : 0));
+      }
+      s21_remove_matrix(&copy);
+    }
+  } else {
+    error_code = INCORRECT_MATRIX;
+  }
+  s21_stats_end(&scope);
+  return error_code;
+}
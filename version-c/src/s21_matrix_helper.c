@@ -8,28 +8,69 @@ matrix_t init_matrix() {
   return m;
 }
 
+// one block per matrix: the row pointer table, then the elements starting
+// on the next MATRIX_ALIGNMENT boundary (the block itself is only aligned
+// as the allocator returns it, so MATRIX_ALIGNMENT bytes of slack are
+// reserved for the shift)
+size_t matrix_bytes(int rows, int columns) {
+  return sizeof(double *) * rows + MATRIX_ALIGNMENT +
+         sizeof(double) * rows * columns;
+}
+
+// lays a matrix out in a block of matrix_bytes(rows, columns)
+double **layout_matrix(void *block, int rows, int columns) {
+  double **result = block;
+  uintptr_t data = (uintptr_t)(result + rows);
+  data = (data + MATRIX_ALIGNMENT - 1) & ~(uintptr_t)(MATRIX_ALIGNMENT - 1);
+
+  for (int i = 0; i < rows; i++) {
+    result[i] = (double *)data + (size_t)i * columns;
+  }
+  return result;
+}
+
 double **allocate_matrix(int rows, int columns) {
-  double **result = malloc(sizeof(double *) * rows);
+  double **result = s21_allocate(matrix_bytes(rows, columns));
 
   if (result) {
-    for (int i = 0; i < rows; i++) {
-      result[i] = malloc(sizeof(double) * columns);
-      if (!result[i]) {
-        break;
-      }
-    }
+    layout_matrix(result, rows, columns);
   }
   return result;
 }
 
-void free_matrix(int rows, double **array) {
-  if (array) {
-    for (int i = 0; i < rows; i++) {
-      if (array[i]) {
-        free(array[i]);
-      }
+double **allocate_zeroed_matrix(int rows, int columns) {
+  double **result = s21_allocate_zeroed(matrix_bytes(rows, columns));
+
+  if (result) {
+    layout_matrix(result, rows, columns);
+  }
+  return result;
+}
+
+// a rows x columns matrix, zeroed when zeroed is set, else left
+// uninitialized for a caller that writes every element
+int create_matrix(int rows, int columns, int zeroed, matrix_t *result) {
+  int error_code = OK;
+
+  if (!result || rows < 1 || columns < 1) {
+    error_code = INCORRECT_MATRIX;
+  } else {
+    *result = init_matrix();
+    result->rows = rows;
+    result->columns = columns;
+    result->matrix = zeroed ? allocate_zeroed_matrix(rows, columns)
+                            : allocate_matrix(rows, columns);
+
+    if (!result->matrix) {
+      error_code = MEMORY_ERROR;
     }
-    free(array);
+  }
+  return error_code;
+}
+
+void free_matrix(int rows, int columns, double **array) {
+  if (array) {
+    s21_deallocate(array, matrix_bytes(rows, columns));
   }
 }
 
@@ -59,6 +100,124 @@ void fill_matrix_zero(matrix_t *matrix) {
   }
 }
 
+// element-wise kernels of the allocating, _into and in-place variants, on
+// matrices already checked by the caller. result may be A or B
+void add_elements(matrix_t *A, matrix_t *B, double sign, matrix_t *result) {
+  for (int i = 0; i < A->rows; i++) {
+    for (int j = 0; j < A->columns; j++) {
+      result->matrix[i][j] = A->matrix[i][j] + sign * B->matrix[i][j];
+    }
+  }
+}
+
+void scale_elements(matrix_t *A, double number, matrix_t *result) {
+  for (int i = 0; i < A->rows; i++) {
+    for (int j = 0; j < A->columns; j++) {
+      result->matrix[i][j] = A->matrix[i][j] * number;
+    }
+  }
+}
+
+// result must not share storage with A
+void transpose_elements(matrix_t *A, matrix_t *result) {
+  for (int i = 0; i < result->rows; i++) {
+    for (int j = 0; j < result->columns; j++) {
+      result->matrix[i][j] = A->matrix[j][i];
+    }
+  }
+}
+
+int check_tolerance(s21_tolerance_t tolerance) {
+  int result = FALSE;
+
+  if (tolerance.absolute >= 0 && tolerance.relative >= 0 &&
+      tolerance.ulps >= 0) {
+    result = TRUE;
+  }
+  return result;
+}
+
+// doubles mapped to unsigned integers in the same order, adjacent doubles
+// differ by one
+static unsigned long long ordered_bits(double value) {
+  union {
+    double value;
+    unsigned long long bits;
+  } pun = {value};
+
+  return pun.bits >> 63 ? ~pun.bits : pun.bits | 0x8000000000000000ull;
+}
+
+int close_elements(double a, double b, const s21_tolerance_t *tolerance) {
+  double difference = fabs(a - b);
+  unsigned long long x = ordered_bits(a);
+  unsigned long long y = ordered_bits(b);
+  unsigned long long distance = x > y ? x - y : y - x;
+
+  return a == b || difference <= tolerance->absolute ||
+         difference <= tolerance->relative * fmax(fabs(a), fabs(b)) ||
+         (difference == difference &&
+          distance <= (unsigned long long)tolerance->ulps);
+}
+
+// the scan runs a tight early-exit loop on the absolute and relative bounds
+// only (a compare and a well predicted branch per element, a loop newer
+// compilers vectorize), an element it stops at is rechecked with
+// close_elements, which also covers the ulps bound, and the scan resumes
+// after it when it is close after all
+static inline int within_bound(double a, double b,
+                               const s21_tolerance_t *tolerance,
+                               int relative) {
+  double bound = tolerance->absolute;
+
+  if (relative) {
+    double scale = fabs(a) > fabs(b) ? fabs(a) : fabs(b);
+    if (tolerance->relative * scale > bound) {
+      bound = tolerance->relative * scale;
+    }
+  }
+  return fabs(a - b) <= bound;
+}
+
+static inline int scan_row(const double *a, const double *b, int size,
+                           const s21_tolerance_t *tolerance, int relative) {
+  int result = size;
+  int j = 0;
+
+  while (j < size && result == size) {
+    while (j < size && within_bound(a[j], b[j], tolerance, relative)) {
+      j++;
+    }
+    if (j < size && !close_elements(a[j], b[j], tolerance)) {
+      result = j;
+    }
+    j++;
+  }
+  return result;
+}
+
+// the first column of [0, size) that isn't close, or size
+int row_mismatch(const double *a, const double *b, int size,
+                 const s21_tolerance_t *tolerance) {
+  return tolerance->relative > 0 ? scan_row(a, b, size, tolerance, TRUE)
+                                 : scan_row(a, b, size, tolerance, FALSE);
+}
+
+// row-major index of the first element of rows [begin, end) that isn't
+// close, or -1
+long long first_mismatch(matrix_t *A, matrix_t *B, int begin, int end,
+                         const s21_tolerance_t *tolerance) {
+  long long result = -1;
+
+  for (int i = begin; i < end && result < 0; i++) {
+    int j = row_mismatch(A->matrix[i], B->matrix[i], A->columns, tolerance);
+    if (j < A->columns) {
+      result = (long long)i * A->columns + j;
+    }
+  }
+  return result;
+}
+
 void fill_matrix_increment(matrix_t *matrix, int value) {
   for (int i = 0; i < matrix->rows; i++) {
     for (int j = 0; j < matrix->columns; j++) {
@@ -86,7 +245,7 @@ double generate_value_in_range(double min, double max) {
 void print_matrix(matrix_t *matrix) {
   for (int i = 0; i < matrix->rows; i++) {
     for (int j = 0; j < matrix->columns; j++) {
-      printf("%lf ", matrix->matrix[i][j]);
+      printf("%.17g ", matrix->matrix[i][j]);
     }
     printf("\n");
   }
@@ -95,24 +254,89 @@ void print_matrix(matrix_t *matrix) {
 
 int create_minor_elements_matrix(matrix_t *origin, matrix_t *result,
                                  int index_rows, int index_columns) {
-  int elem_rows = 0;
-  int elem_columns = 0;
   int error_code =
-      s21_create_matrix(origin->rows - 1, origin->columns - 1, result);
+      create_matrix(origin->rows - 1, origin->columns - 1, FALSE, result);
 
   if (error_code == OK) {
-    for (int i = 0; i < origin->rows; i++) {
-      for (int j = 0; j < origin->columns; j++) {
-        if (i != index_rows && j != index_columns) {
-          result->matrix[elem_rows][elem_columns] = origin->matrix[i][j];
-          elem_columns++;
-        }
-      }
-      if (i != index_rows) {
-        elem_rows++;
+    fill_minor(origin, result, index_rows, index_columns);
+  }
+  return error_code;
+}
+
+void fill_minor(matrix_t *origin, matrix_t *result, int index_rows,
+                int index_columns) {
+  int elem_rows = 0;
+  int elem_columns = 0;
+
+  for (int i = 0; i < origin->rows; i++) {
+    for (int j = 0; j < origin->columns; j++) {
+      if (i != index_rows && j != index_columns) {
+        result->matrix[elem_rows][elem_columns] = origin->matrix[i][j];
+        elem_columns++;
       }
-      elem_columns = 0;
     }
+    if (i != index_rows) {
+      elem_rows++;
+    }
+    elem_columns = 0;
   }
-  return error_code;
+}
+
+// the minors of every level of a cofactor expansion of a size x size matrix
+// (sizes size - 1 down to 1), the headers first, then the matrices
+size_t minors_bytes(int size) {
+  size_t result = 0;
+
+  for (int n = size - 1; n >= 1; n--) {
+    result += sizeof(matrix_t) + matrix_bytes(n, n);
+  }
+  return result;
+}
+
+matrix_t *layout_minors(void *block, int size) {
+  matrix_t *result = block;
+  char *cursor = (char *)block + sizeof(matrix_t) * (size - 1);
+
+  for (int n = size - 1; n >= 1; n--) {
+    matrix_t *minor = &result[size - 1 - n];
+    minor->rows = n;
+    minor->columns = n;
+    minor->matrix = layout_matrix(cursor, n, n);
+    cursor += matrix_bytes(n, n);
+  }
+  return result;
+}
+
+// cofactor expansion along the first row, minors holds the minors of every
+// level below A (layout_minors), so the recursion doesn't allocate
+double expand_determinant(matrix_t *A, matrix_t *minors) {
+  double result = 0;
+
+  if (A->rows == 1) {
+    result = A->matrix[0][0];
+  } else if (A->rows == 2) {
+    result =
+        A->matrix[0][0] * A->matrix[1][1] - A->matrix[0][1] * A->matrix[1][0];
+  } else {
+    int sign = 1;
+
+    for (int i = 0; i < A->columns; i++) {
+      fill_minor(A, minors, 0, i);
+      result += A->matrix[0][i] * expand_determinant(minors, minors + 1) * sign;
+      sign = -1 * sign;
+    }
+  }
+  return result;
+}
+
+// flops of the cofactor expansion in s21_determinant: every one of the n
+// minors costs its own expansion, then a multiply by the element, by the sign
+// and an add
+double determinant_flops(int size) {
+  double result = size >= 2 ? 3 : 0;
+
+  for (int n = 3; n <= size; n++) {
+    result = n * (result + 3);
+  }
+  return result;
 }
@@ -0,0 +1,114 @@
+#include "s21_matrix.h"
+
+int s21_sum_matrix_into(matrix_t *A, matrix_t *B, matrix_t *result) {
+  s21_stats_scope_t scope;
+  s21_stats_begin(&scope, S21_OP_SUM_MATRIX);
+  int error_code = CALCULATION_ERROR;
+
+  if (check_matrix(A) && check_matrix(B) && check_matrix(result)) {
+    if (check_eq_size(A, B) && check_eq_size(A, result)) {
+      add_elements(A, B, 1, result);
+      s21_stats_add_flops(&scope, (double)A->rows * A->columns);
+      error_code = OK;
+    }
+  } else {
+    error_code = INCORRECT_MATRIX;
+  }
+  s21_stats_end(&scope);
+  return error_code;
+}
+
+int s21_sub_matrix_into(matrix_t *A, matrix_t *B, matrix_t *result) {
+  s21_stats_scope_t scope;
+  s21_stats_begin(&scope, S21_OP_SUB_MATRIX);
+  int error_code = CALCULATION_ERROR;
+
+  if (check_matrix(A) && check_matrix(B) && check_matrix(result)) {
+    if (check_eq_size(A, B) && check_eq_size(A, result)) {
+      add_elements(A, B, -1, result);
+      s21_stats_add_flops(&scope, (double)A->rows * A->columns);
+      error_code = OK;
+    }
+  } else {
+    error_code = INCORRECT_MATRIX;
+  }
+  s21_stats_end(&scope);
+  return error_code;
+}
+
+int s21_mult_number_into(matrix_t *A, double number, matrix_t *result) {
+  s21_stats_scope_t scope;
+  s21_stats_begin(&scope, S21_OP_MULT_NUMBER);
+  int error_code = CALCULATION_ERROR;
+
+  if (check_matrix(A) && check_matrix(result)) {
+    if (check_eq_size(A, result)) {
+      scale_elements(A, number, result);
+      s21_stats_add_flops(&scope, (double)A->rows * A->columns);
+      error_code = OK;
+    }
+  } else {
+    error_code = INCORRECT_MATRIX;
+  }
+  s21_stats_end(&scope);
+  return error_code;
+}
+
+int s21_mult_matrix_into(matrix_t *A, matrix_t *B, matrix_t *result) {
+  return s21_mult_matrix_into_ctx(NULL, A, B, result);
+}
+
+int s21_mult_matrix_into_ctx(s21_context_t *context, matrix_t *A,
+                             matrix_t *B, matrix_t *result) {
+  s21_stats_scope_t scope;
+  s21_stats_begin(&scope, S21_OP_MULT_MATRIX);
+  int error_code = CALCULATION_ERROR;
+
+  if (check_matrix(A) && check_matrix(B) && check_matrix(result)) {
+    if (A->columns == B->rows && result->rows == A->rows &&
+        result->columns == B->columns && result->matrix != A->matrix &&
+        result->matrix != B->matrix) {
+      error_code = gemm_update(context, 1, A, FALSE, B, FALSE, 0, result);
+    }
+  } else {
+    error_code = INCORRECT_MATRIX;
+  }
+
+  if (error_code == OK) {
+    s21_stats_add_flops(&scope, 2.0 * A->rows * A->columns * B->columns);
+  }
+  s21_stats_end(&scope);
+  return error_code;
+}
+
+int s21_transpose_into(matrix_t *A, matrix_t *result) {
+  s21_stats_scope_t scope;
+  s21_stats_begin(&scope, S21_OP_TRANSPOSE);
+  int error_code = CALCULATION_ERROR;
+
+  if (check_matrix(A) && check_matrix(result)) {
+    if (result->rows == A->columns && result->columns == A->rows &&
+        result->matrix != A->matrix) {
+      transpose_elements(A, result);
+      error_code = OK;
+    }
+  } else {
+    error_code = INCORRECT_MATRIX;
+  }
+  s21_stats_end(&scope);
+  return error_code;
+}
+
+// in-place
+
+int s21_sum_matrix_inplace(matrix_t *A, matrix_t *B) {
+  return s21_sum_matrix_into(A, B, A);
+}
+
+int s21_sub_matrix_inplace(matrix_t *A, matrix_t *B) {
+  return s21_sub_matrix_into(A, B, A);
+}
+
+int s21_mult_number_inplace(matrix_t *A, double number) {
+  return s21_mult_number_into(A, number, A);
+}
@@ -0,0 +1,277 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <limits.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+
+#include "s21_matrix.h"
+
+// aligned so each operation has its own cache line
+typedef struct operation_counters {
+  _Alignas(64) atomic_ullong calls;
+  atomic_ullong nanoseconds;
+  atomic_ullong flops;
+  atomic_ullong allocated_bytes;
+  atomic_ullong histogram[S21_STATS_BUCKETS];
+} operation_counters_t;
+
+static const char *operation_names[S21_OP_COUNT] = {
+    "create_matrix", "eq_matrix",      "sum_matrix", "sub_matrix",
+    "mult_number",   "mult_matrix",    "transpose",  "calc_complements",
+    "determinant",   "inverse_matrix", "gemm"};
+
+static operation_counters_t counters[S21_OP_COUNT];
+static atomic_int stats_enabled = -1;
+
+static int stats_enabled_relaxed() {
+  int result = atomic_load_explicit(&stats_enabled, memory_order_relaxed);
+
+#ifdef S21_MATRIX_NO_STATS
+  result = FALSE;
+#endif
+  if (result < 0) {
+    const char *variable = getenv("S21_MATRIX_STATS");
+    int expected = -1;
+    int value = (variable && variable[0] == '1') ? TRUE : FALSE;
+
+    atomic_compare_exchange_strong(&stats_enabled, &expected, value);
+    result = atomic_load_explicit(&stats_enabled, memory_order_relaxed);
+  }
+  return result;
+}
+
+// snprintf into buffer at offset, returns the new offset even when the
+// buffer is too small, so the caller gets the required size like snprintf
+static int append(char *buffer, size_t size, int offset, const char *format,
+                  ...) {
+  va_list args;
+  va_start(args, format);
+
+  int written = 0;
+  if (buffer && (size_t)offset < size) {
+    written = vsnprintf(buffer + offset, size - offset, format, args);
+  } else {
+    written = vsnprintf(NULL, 0, format, args);
+  }
+  va_end(args);
+  return offset + (written > 0 ? written : 0);
+}
+
+void s21_stats_set_enabled(int enabled) {
+  atomic_store_explicit(&stats_enabled, enabled ? TRUE : FALSE,
+                        memory_order_relaxed);
+}
+
+int s21_stats_is_enabled() { return stats_enabled_relaxed(); }
+
+void s21_stats_reset() {
+  for (int i = 0; i < S21_OP_COUNT; i++) {
+    atomic_store_explicit(&counters[i].calls, 0, memory_order_relaxed);
+    atomic_store_explicit(&counters[i].nanoseconds, 0, memory_order_relaxed);
+    atomic_store_explicit(&counters[i].flops, 0, memory_order_relaxed);
+    atomic_store_explicit(&counters[i].allocated_bytes, 0,
+                          memory_order_relaxed);
+    for (int j = 0; j < S21_STATS_BUCKETS; j++) {
+      atomic_store_explicit(&counters[i].histogram[j], 0,
+                            memory_order_relaxed);
+    }
+  }
+}
+
+void s21_stats_snapshot(s21_operation_stats_t result[S21_OP_COUNT]) {
+  for (int i = 0; i < S21_OP_COUNT; i++) {
+    result[i].name = operation_names[i];
+    result[i].calls =
+        atomic_load_explicit(&counters[i].calls, memory_order_relaxed);
+    result[i].nanoseconds =
+        atomic_load_explicit(&counters[i].nanoseconds, memory_order_relaxed);
+    result[i].flops =
+        atomic_load_explicit(&counters[i].flops, memory_order_relaxed);
+    result[i].allocated_bytes = atomic_load_explicit(
+        &counters[i].allocated_bytes, memory_order_relaxed);
+    for (int j = 0; j < S21_STATS_BUCKETS; j++) {
+      result[i].histogram[j] = atomic_load_explicit(&counters[i].histogram[j],
+                                                    memory_order_relaxed);
+    }
+  }
+}
+
+unsigned long long s21_stats_histogram_bound(int bucket) {
+  return bucket + 1 < S21_STATS_BUCKETS ? 256ULL << (2 * bucket) : ULLONG_MAX;
+}
+
+// both exporters follow snprintf: the output is truncated to size, the
+// return value is the length of the full text
+int s21_stats_to_json(char *buffer, size_t size) {
+  s21_operation_stats_t stats[S21_OP_COUNT];
+  s21_stats_snapshot(stats);
+
+  int offset = append(buffer, size, 0, "{\"histogram_bounds_ns\":[");
+  for (int j = 0; j + 1 < S21_STATS_BUCKETS; j++) {
+    offset = append(buffer, size, offset, "%s%llu", j ? "," : "",
+                    s21_stats_histogram_bound(j));
+  }
+  offset = append(buffer, size, offset, "],\"operations\":[");
+
+  for (int i = 0; i < S21_OP_COUNT; i++) {
+    offset = append(buffer, size, offset,
+                    "%s{\"name\":\"%s\",\"calls\":%llu,\"total_ns\":%llu,"
+                    "\"flops\":%llu,\"allocated_bytes\":%llu,\"histogram\":[",
+                    i ? "," : "", stats[i].name, stats[i].calls,
+                    stats[i].nanoseconds, stats[i].flops,
+                    stats[i].allocated_bytes);
+    for (int j = 0; j < S21_STATS_BUCKETS; j++) {
+      offset = append(buffer, size, offset, "%s%llu", j ? "," : "",
+                      stats[i].histogram[j]);
+    }
+    offset = append(buffer, size, offset, "]}");
+  }
+  return append(buffer, size, offset, "]}");
+}
+
+int s21_stats_to_prometheus(char *buffer, size_t size) {
+  s21_operation_stats_t stats[S21_OP_COUNT];
+  s21_stats_snapshot(stats);
+  int offset = 0;
+
+  offset = append(buffer, size, offset,
+                  "# HELP s21_matrix_operation_calls_total Completed "
+                  "operation calls.\n"
+                  "# TYPE s21_matrix_operation_calls_total counter\n");
+  for (int i = 0; i < S21_OP_COUNT; i++) {
+    offset = append(buffer, size, offset,
+                    "s21_matrix_operation_calls_total{operation=\"%s\"} %llu\n",
+                    stats[i].name, stats[i].calls);
+  }
+
+  offset = append(buffer, size, offset,
+                  "# HELP s21_matrix_operation_flops_total Floating point "
+                  "operations.\n"
+                  "# TYPE s21_matrix_operation_flops_total counter\n");
+  for (int i = 0; i < S21_OP_COUNT; i++) {
+    offset = append(buffer, size, offset,
+                    "s21_matrix_operation_flops_total{operation=\"%s\"} %llu\n",
+                    stats[i].name, stats[i].flops);
+  }
+
+  offset = append(buffer, size, offset,
+                  "# HELP s21_matrix_operation_allocated_bytes_total Bytes "
+                  "allocated.\n"
+                  "# TYPE s21_matrix_operation_allocated_bytes_total "
+                  "counter\n");
+  for (int i = 0; i < S21_OP_COUNT; i++) {
+    offset = append(
+        buffer, size, offset,
+        "s21_matrix_operation_allocated_bytes_total{operation=\"%s\"} %llu\n",
+        stats[i].name, stats[i].allocated_bytes);
+  }
+
+  offset = append(buffer, size, offset,
+                  "# HELP s21_matrix_operation_duration_seconds Operation "
+                  "wall time.\n"
+                  "# TYPE s21_matrix_operation_duration_seconds histogram\n");
+  for (int i = 0; i < S21_OP_COUNT; i++) {
+    unsigned long long cumulative = 0;
+
+    for (int j = 0; j < S21_STATS_BUCKETS; j++) {
+      cumulative += stats[i].histogram[j];
+      if (j + 1 < S21_STATS_BUCKETS) {
+        offset = append(buffer, size, offset,
+                        "s21_matrix_operation_duration_seconds_bucket{"
+                        "operation=\"%s\",le=\"%g\"} %llu\n",
+                        stats[i].name, s21_stats_histogram_bound(j) * 1e-9,
+                        cumulative);
+      } else {
+        offset = append(buffer, size, offset,
+                        "s21_matrix_operation_duration_seconds_bucket{"
+                        "operation=\"%s\",le=\"+Inf\"} %llu\n",
+                        stats[i].name, cumulative);
+      }
+    }
+    offset = append(buffer, size, offset,
+                    "s21_matrix_operation_duration_seconds_sum{operation="
+                    "\"%s\"} %.9f\n"
+                    "s21_matrix_operation_duration_seconds_count{operation="
+                    "\"%s\"} %llu\n",
+                    stats[i].name, stats[i].nanoseconds * 1e-9, stats[i].name,
+                    stats[i].calls);
+  }
+  return offset;
+}
+
+#ifndef S21_MATRIX_NO_STATS
+
+// scopes, the header replaces them with no-ops under S21_MATRIX_NO_STATS
+
+// the outermost scope of the thread, nested calls (the recursion of
+// s21_determinant, the matrices created inside other functions) are folded
+// into it, so a call is never counted twice
+static _Thread_local s21_stats_scope_t *current_scope = NULL;
+
+static unsigned long long elapsed_nanoseconds(struct timespec *start) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  long long result = (long long)(now.tv_sec - start->tv_sec) * 1000000000LL +
+                     (now.tv_nsec - start->tv_nsec);
+  return result > 0 ? (unsigned long long)result : 0;
+}
+
+// 4x wider buckets from 256 ns, the last one is open
+static int bucket_index(unsigned long long nanoseconds) {
+  int result = 0;
+
+  while (result + 1 < S21_STATS_BUCKETS &&
+         nanoseconds > s21_stats_histogram_bound(result)) {
+    result++;
+  }
+  return result;
+}
+
+void s21_stats_begin(s21_stats_scope_t *scope, s21_operation_t operation) {
+  scope->operation = operation;
+  scope->active = FALSE;
+  scope->flops = 0;
+  scope->allocated_bytes = 0;
+
+  if (s21_stats_is_enabled() && !current_scope) {
+    scope->active = TRUE;
+    current_scope = scope;
+    clock_gettime(CLOCK_MONOTONIC, &scope->start);
+  }
+}
+
+// saturates at ULLONG_MAX, NaN and non-positive counts are dropped
+void s21_stats_add_flops(s21_stats_scope_t *scope, double flops) {
+  if (scope->active && flops > 0) {
+    scope->flops = flops >= (double)(ULLONG_MAX - scope->flops)
+                       ? ULLONG_MAX
+                       : scope->flops + (unsigned long long)flops;
+  }
+}
+
+void s21_stats_add_allocated_bytes(size_t bytes) {
+  if (s21_stats_is_enabled() && current_scope) {
+    current_scope->allocated_bytes += bytes;
+  }
+}
+
+void s21_stats_end(s21_stats_scope_t *scope) {
+  if (scope->active) {
+    operation_counters_t *counter = &counters[scope->operation];
+    unsigned long long nanoseconds = elapsed_nanoseconds(&scope->start);
+
+    current_scope = NULL;
+    atomic_fetch_add_explicit(&counter->calls, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&counter->nanoseconds, nanoseconds,
+                              memory_order_relaxed);
+    atomic_fetch_add_explicit(&counter->flops, scope->flops,
+                              memory_order_relaxed);
+    atomic_fetch_add_explicit(&counter->allocated_bytes,
+                              scope->allocated_bytes, memory_order_relaxed);
+    atomic_fetch_add_explicit(&counter->histogram[bucket_index(nanoseconds)],
+                              1, memory_order_relaxed);
+  }
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include <check.h>
+#include <limits.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -696,6 +697,529 @@ START_TEST(test_inverse_matrix_2) {
 }
 END_TEST
 
+// gemm
+
+START_TEST(test_gemm_1) {
+  matrix_t a = init_matrix();
+  matrix_t b = init_matrix();
+  matrix_t c = init_matrix();
+  matrix_t product = init_matrix();
+
+  s21_create_matrix(3, 4, &a);
+  s21_create_matrix(4, 5, &b);
+  s21_create_matrix(3, 5, &c);
+  fill_matrix_range(&a, -2, 2);
+  fill_matrix_range(&b, -2, 2);
+  fill_matrix_range(&c, -2, 2);
+  s21_mult_matrix(&a, &b, &product);
+
+  double expected = 0.5 * product.matrix[2][4] + 2 * c.matrix[2][4];
+  ck_assert_int_eq(s21_gemm(0.5, &a, FALSE, &b, FALSE, 2, &c), OK);
+  ck_assert_double_eq_tol(c.matrix[2][4], expected, 1e-9);
+
+  // transposed operands are read in place
+  matrix_t a_t = init_matrix();
+  matrix_t b_t = init_matrix();
+  s21_transpose(&a, &a_t);
+  s21_transpose(&b, &b_t);
+  ck_assert_int_eq(s21_gemm(1, &a_t, TRUE, &b_t, TRUE, 0, &c), OK);
+  ck_assert_int_eq(s21_eq_matrix(&c, &product), TRUE);
+
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+  s21_remove_matrix(&c);
+  s21_remove_matrix(&product);
+  s21_remove_matrix(&a_t);
+  s21_remove_matrix(&b_t);
+}
+END_TEST
+
+START_TEST(test_gemm_2) {
+  matrix_t a = init_matrix();
+  matrix_t b = init_matrix();
+  matrix_t expected = init_matrix();
+
+  s21_create_matrix(3, 3, &a);
+  s21_create_matrix(3, 4, &b);
+  fill_matrix_increment(&a, 1);
+  s21_mult_matrix(&a, &a, &expected);
+
+  // the operand and the result share storage
+  ck_assert_int_eq(s21_gemm(1, &a, FALSE, &a, FALSE, 0, &a), OK);
+  ck_assert_int_eq(s21_eq_matrix(&a, &expected), TRUE);
+
+  ck_assert_int_eq(s21_gemm(1, &a, FALSE, &b, FALSE, 0, &a),
+                   CALCULATION_ERROR);
+  ck_assert_int_eq(s21_gemm(1, &a, FALSE, &b, TRUE, 0, &a),
+                   CALCULATION_ERROR);
+  ck_assert_int_eq(s21_gemm(1, &a, FALSE, NULL, FALSE, 0, &a),
+                   INCORRECT_MATRIX);
+
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+  s21_remove_matrix(&expected);
+}
+END_TEST
+
+// into
+
+START_TEST(test_into_1) {
+  matrix_t a = init_matrix();
+  matrix_t b = init_matrix();
+  matrix_t expected = init_matrix();
+  matrix_t result = init_matrix();
+  matrix_t product = init_matrix();
+  matrix_t transposed = init_matrix();
+  s21_memory_scope_t scope;
+  s21_memory_stats_t delta;
+
+  s21_create_matrix(3, 3, &a);
+  s21_create_matrix(3, 3, &b);
+  s21_create_matrix(3, 3, &result);
+  s21_create_matrix(3, 3, &product);
+  s21_create_matrix(3, 3, &transposed);
+  fill_matrix_range(&a, -2, 2);
+  fill_matrix_range(&b, -2, 2);
+
+  // the result buffers are reused, nothing is allocated
+  s21_memory_scope_begin(&scope);
+  ck_assert_int_eq(s21_sum_matrix_into(&a, &b, &result), OK);
+  ck_assert_int_eq(s21_sub_matrix_inplace(&result, &b), OK);
+  ck_assert_int_eq(s21_mult_number_inplace(&result, 2), OK);
+  ck_assert_int_eq(s21_sum_matrix_inplace(&result, &b), OK);
+  ck_assert_int_eq(s21_sub_matrix_into(&result, &b, &result), OK);
+  ck_assert_int_eq(s21_mult_number_into(&result, 0.5, &result), OK);
+  ck_assert_int_eq(s21_mult_matrix_into(&result, &b, &product), OK);
+  ck_assert_int_eq(s21_transpose_into(&product, &transposed), OK);
+  s21_memory_scope_end(&scope, &delta);
+  ck_assert_int_eq(delta.allocations, 0);
+
+  ck_assert_int_eq(s21_eq_matrix(&result, &a), TRUE);
+  s21_mult_matrix(&a, &b, &expected);
+  ck_assert_int_eq(s21_eq_matrix(&product, &expected), TRUE);
+  ck_assert_double_eq_tol(transposed.matrix[0][2], expected.matrix[2][0],
+                          1e-9);
+
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+  s21_remove_matrix(&expected);
+  s21_remove_matrix(&result);
+  s21_remove_matrix(&product);
+  s21_remove_matrix(&transposed);
+}
+END_TEST
+
+START_TEST(test_into_2) {
+  matrix_t a = init_matrix();
+  matrix_t b = init_matrix();
+  matrix_t empty = init_matrix();
+
+  s21_create_matrix(2, 2, &a);
+  s21_create_matrix(2, 3, &b);
+
+  ck_assert_int_eq(s21_sum_matrix_into(&a, &a, &b), CALCULATION_ERROR);
+  ck_assert_int_eq(s21_sub_matrix_inplace(&a, &b), CALCULATION_ERROR);
+  ck_assert_int_eq(s21_mult_number_into(&a, 2, &b), CALCULATION_ERROR);
+  ck_assert_int_eq(s21_mult_matrix_into(&a, &b, &a), CALCULATION_ERROR);
+  // the product can't be written over its operand
+  ck_assert_int_eq(s21_mult_matrix_into(&a, &a, &a), CALCULATION_ERROR);
+  ck_assert_int_eq(s21_transpose_into(&a, &a), CALCULATION_ERROR);
+  ck_assert_int_eq(s21_transpose_into(&b, &b), CALCULATION_ERROR);
+  ck_assert_int_eq(s21_sum_matrix_into(&a, &a, &empty), INCORRECT_MATRIX);
+  ck_assert_int_eq(s21_mult_number_inplace(NULL, 2), INCORRECT_MATRIX);
+  ck_assert_int_eq(s21_transpose_into(&empty, &a), INCORRECT_MATRIX);
+
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+}
+END_TEST
+
+START_TEST(test_into_3) {
+  s21_context_config_t config = {1, 0};
+  s21_context_t *context = NULL;
+  matrix_t a = init_matrix();
+  matrix_t b = init_matrix();
+  matrix_t expected = init_matrix();
+  matrix_t product = init_matrix();
+  s21_memory_scope_t scope;
+  s21_memory_stats_t delta;
+
+  // large enough for the packing panel not to fit on the stack
+  s21_context_create(&config, &context);
+  s21_create_matrix(48, 64, &a);
+  s21_create_matrix(64, 96, &b);
+  s21_create_matrix(48, 96, &product);
+  fill_matrix_range(&a, -2, 2);
+  fill_matrix_range(&b, -2, 2);
+
+  // the first call grows the arena, the next ones reuse it
+  ck_assert_int_eq(s21_mult_matrix_into_ctx(context, &a, &b, &product), OK);
+  s21_memory_scope_begin(&scope);
+  ck_assert_int_eq(s21_mult_matrix_into_ctx(context, &a, &b, &product), OK);
+  ck_assert_int_eq(s21_mult_matrix_into_ctx(context, &a, &b, &product), OK);
+  s21_memory_scope_end(&scope, &delta);
+  ck_assert_int_eq(delta.allocations, 0);
+
+  s21_mult_matrix(&a, &b, &expected);
+  ck_assert_int_eq(s21_eq_matrix(&product, &expected), TRUE);
+  ck_assert_int_eq(s21_mult_matrix_into_ctx(context, &a, &a, &product),
+                   CALCULATION_ERROR);
+
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+  s21_remove_matrix(&expected);
+  s21_remove_matrix(&product);
+  s21_context_destroy(context);
+}
+END_TEST
+
+// context
+
+START_TEST(test_context_1) {
+  s21_context_config_t config = {4, 42};
+  s21_context_t *context = NULL;
+  s21_context_t *twin = NULL;
+  matrix_t a = init_matrix();
+  matrix_t b = init_matrix();
+  matrix_t serial = init_matrix();
+  matrix_t parallel = init_matrix();
+  double expected = 0;
+  double determinant = 0;
+
+  ck_assert_int_eq(s21_context_create(&config, &context), OK);
+  ck_assert_int_eq(s21_context_create(&config, &twin), OK);
+  ck_assert_int_eq(s21_context_threads(context), 4);
+
+  // the same seed gives the same sequence
+  s21_create_matrix(96, 96, &a);
+  s21_create_matrix(96, 96, &b);
+  s21_fill_random(context, &a, -1, 1);
+  s21_fill_random(twin, &b, -1, 1);
+  ck_assert_int_eq(s21_eq_matrix(&a, &b), TRUE);
+  ck_assert_double_ge(a.matrix[5][7], -1);
+  ck_assert_double_lt(a.matrix[5][7], 1);
+
+  // and the same matrix at any thread count
+  config.threads = 1;
+  s21_context_destroy(twin);
+  ck_assert_int_eq(s21_context_create(&config, &twin), OK);
+  s21_fill_random(twin, &b, -1, 1);
+  ck_assert_int_eq(s21_eq_matrix(&a, &b), TRUE);
+
+  s21_fill_random(context, &b, -1, 1);
+  ck_assert_int_eq(s21_eq_matrix(&a, &b), FALSE);
+  s21_mult_matrix(&a, &b, &serial);
+  ck_assert_int_eq(s21_mult_matrix_ctx(context, &a, &b, &parallel), OK);
+  ck_assert_int_eq(s21_eq_matrix(&serial, &parallel), TRUE);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&serial);
+  s21_remove_matrix(&parallel);
+
+  // the expansions match the serial ones bit for bit
+  s21_create_matrix(8, 8, &a);
+  s21_fill_random(context, &a, -1, 1);
+  s21_determinant(&a, &expected);
+  ck_assert_int_eq(s21_determinant_ctx(context, &a, &determinant), OK);
+  ck_assert_double_eq(determinant, expected);
+
+  s21_inverse_matrix(&a, &serial);
+  ck_assert_int_eq(s21_inverse_matrix_ctx(context, &a, &parallel), OK);
+  ck_assert_int_eq(s21_eq_matrix(&serial, &parallel), TRUE);
+
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+  s21_remove_matrix(&serial);
+  s21_remove_matrix(&parallel);
+  s21_context_destroy(context);
+  s21_context_destroy(twin);
+}
+END_TEST
+
+START_TEST(test_context_2) {
+  s21_context_config_t config = {-1, 0};
+  s21_context_t *context = NULL;
+  matrix_t m = init_matrix();
+  matrix_t result = init_matrix();
+
+  ck_assert_int_eq(s21_context_create(&config, &context), INCORRECT_MATRIX);
+  ck_assert_int_eq(s21_context_create(NULL, NULL), INCORRECT_MATRIX);
+  ck_assert_int_eq(s21_context_create(NULL, &context), OK);
+  ck_assert_int_ge(s21_context_threads(context), 1);
+  ck_assert_int_eq(s21_fill_random(context, &m, 0, 1), INCORRECT_MATRIX);
+
+  // without a context the operations run on the calling thread
+  s21_create_matrix(1, 1, &m);
+  ck_assert_int_eq(s21_fill_random(NULL, &m, 2, 3), OK);
+  ck_assert_int_eq(m.matrix[0][0] >= 2 && m.matrix[0][0] <= 3, TRUE);
+  double value = s21_context_random(NULL, 2, 3);
+  ck_assert_int_eq(value >= 2 && value <= 3, TRUE);
+  m.matrix[0][0] = 4;
+  ck_assert_int_eq(s21_inverse_matrix_ctx(NULL, &m, &result), OK);
+  ck_assert_double_eq_tol(result.matrix[0][0], 0.25, 1e-9);
+  s21_remove_matrix(&result);
+  ck_assert_int_eq(s21_calc_complements_ctx(context, &m, &result), OK);
+  ck_assert_double_eq_tol(result.matrix[0][0], 1, 1e-9);
+
+  s21_remove_matrix(&m);
+  s21_remove_matrix(&result);
+  s21_context_destroy(context);
+  s21_context_destroy(NULL);
+}
+END_TEST
+
+// compare
+
+START_TEST(test_compare_1) {
+  s21_tolerance_t relative = {0, 1e-9, 0};
+  s21_tolerance_t ulps = {0, 0, 1};
+  matrix_t a = init_matrix();
+  matrix_t b = init_matrix();
+  int row = 0;
+  int column = 0;
+
+  s21_create_matrix(3, 20, &a);
+  s21_create_matrix(3, 20, &b);
+  fill_matrix_range(&a, 1e9, 2e9);
+  s21_mult_number_into(&a, 1, &b);
+  b.matrix[2][13] += 1;
+  ck_assert_int_eq(s21_eq_matrix(&a, &b), FALSE);
+  ck_assert_int_eq(s21_approx_equal(&a, &b, relative), TRUE);
+  b.matrix[2][13] = nextafter(a.matrix[2][13], 3e9);
+  ck_assert_int_eq(s21_approx_equal(&a, &b, ulps), TRUE);
+  ck_assert_int_eq(s21_find_mismatch(&a, &b, relative, &row, &column), OK);
+  ck_assert_int_eq(row, -1);
+  ck_assert_int_eq(column, -1);
+  b.matrix[2][13] = NAN;
+  b.matrix[0][1] += 1;
+  ck_assert_int_eq(s21_find_mismatch(&a, &b, relative, &row, &column), OK);
+  ck_assert_int_eq(row, 2);
+  ck_assert_int_eq(column, 13);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+
+  // the parallel scan reports the first mismatch in row-major order
+  s21_context_config_t config = {4, 0};
+  s21_context_t *context = NULL;
+  s21_context_create(&config, &context);
+  s21_create_matrix(1200, 1000, &a);
+  s21_create_matrix(1200, 1000, &b);
+  b.matrix[1100][3] = 1;
+  b.matrix[700][999] = 1;
+  ck_assert_int_eq(
+      s21_find_mismatch_ctx(context, &a, &b, relative, &row, &column), OK);
+  ck_assert_int_eq(row, 700);
+  ck_assert_int_eq(column, 999);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+  s21_context_destroy(context);
+}
+END_TEST
+
+START_TEST(test_compare_2) {
+  s21_tolerance_t tolerance = {1e-7, 0, 0};
+  s21_tolerance_t negative = {0, 0, -1};
+  matrix_t a = init_matrix();
+  matrix_t b = init_matrix();
+  int row = 0;
+  int column = 0;
+
+  s21_create_matrix(2, 2, &a);
+  s21_create_matrix(2, 3, &b);
+  ck_assert_int_eq(s21_approx_equal(&a, &b, tolerance), FALSE);
+  ck_assert_int_eq(s21_approx_equal(&a, &a, negative), FALSE);
+  ck_assert_int_eq(s21_approx_equal(&a, NULL, tolerance), FALSE);
+  ck_assert_int_eq(s21_find_mismatch(&a, &b, tolerance, &row, &column),
+                   CALCULATION_ERROR);
+  ck_assert_int_eq(s21_find_mismatch(&a, &a, negative, &row, &column),
+                   INCORRECT_MATRIX);
+  ck_assert_int_eq(s21_find_mismatch(&a, &a, tolerance, NULL, &column),
+                   INCORRECT_MATRIX);
+  s21_remove_matrix(&a);
+  s21_remove_matrix(&b);
+}
+END_TEST
+
+// stats
+
+START_TEST(test_stats_1) {
+  matrix_t m = init_matrix();
+  double result = 0;
+
+  s21_stats_reset();
+  s21_stats_set_enabled(TRUE);
+  s21_create_matrix(3, 3, &m);
+  m.matrix[0][0] = 2;
+  m.matrix[1][1] = 3;
+  m.matrix[2][2] = 4.5;
+  s21_determinant(&m, &result);
+  s21_stats_set_enabled(FALSE);
+  s21_remove_matrix(&m);
+
+  s21_operation_stats_t stats[S21_OP_COUNT];
+  s21_stats_snapshot(stats);
+  ck_assert_double_eq_tol(result, 27, 1e-7);
+  ck_assert_uint_eq(stats[S21_OP_CREATE_MATRIX].calls, 1);
+  ck_assert_uint_eq(stats[S21_OP_DETERMINANT].calls, 1);
+  ck_assert_uint_eq(stats[S21_OP_DETERMINANT].flops, 18);
+  ck_assert_uint_eq(stats[S21_OP_CREATE_MATRIX].allocated_bytes,
+                    matrix_bytes(3, 3));
+
+  char buffer[8192];
+  int length = s21_stats_to_json(buffer, sizeof(buffer));
+  ck_assert_int_lt(length, (int)sizeof(buffer));
+  ck_assert_ptr_ne(strstr(buffer, "\"determinant\""), NULL);
+  s21_stats_to_prometheus(buffer, sizeof(buffer));
+  ck_assert_ptr_ne(
+      strstr(buffer,
+             "s21_matrix_operation_calls_total{operation=\"determinant\"} 1"),
+      NULL);
+  s21_stats_reset();
+}
+END_TEST
+
+START_TEST(test_stats_2) {
+  matrix_t m = init_matrix();
+
+  s21_stats_reset();
+  s21_stats_set_enabled(FALSE);
+  s21_create_matrix(2, 2, &m);
+  s21_remove_matrix(&m);
+
+  s21_operation_stats_t stats[S21_OP_COUNT];
+  s21_stats_snapshot(stats);
+  ck_assert_uint_eq(stats[S21_OP_CREATE_MATRIX].calls, 0);
+  ck_assert_int_eq(s21_stats_to_json(NULL, 0) > 0, TRUE);
+
+  // flop counts saturate, NaN and negative ones are dropped
+  s21_stats_scope_t scope;
+  s21_stats_set_enabled(TRUE);
+  s21_stats_begin(&scope, S21_OP_GEMM);
+  s21_stats_add_flops(&scope, 10);
+  s21_stats_add_flops(&scope, -5);
+  s21_stats_add_flops(&scope, NAN);
+  s21_stats_end(&scope);
+  s21_stats_begin(&scope, S21_OP_DETERMINANT);
+  s21_stats_add_flops(&scope, 1e19);
+  s21_stats_add_flops(&scope, 1e19);
+  s21_stats_end(&scope);
+  s21_stats_set_enabled(FALSE);
+
+  s21_stats_snapshot(stats);
+  ck_assert_uint_eq(stats[S21_OP_GEMM].flops, 10);
+  ck_assert_uint_eq(stats[S21_OP_DETERMINANT].flops, ULLONG_MAX);
+  s21_stats_reset();
+}
+END_TEST
+
+// memory
+
+typedef struct counting_arena {
+  size_t allocated;
+  size_t released;
+  int fail_after;
+} counting_arena_t;
+
+static void *counting_allocate(size_t size, void *context) {
+  counting_arena_t *arena = context;
+  void *result = NULL;
+
+  // poisoned, so whatever isn't initialized shows
+  if (arena->fail_after != 0) {
+    arena->fail_after--;
+    arena->allocated += size;
+    result = malloc(size);
+    memset(result, 0xFF, size);
+  }
+  return result;
+}
+
+static void counting_deallocate(void *pointer, size_t size, void *context) {
+  counting_arena_t *arena = context;
+  arena->released += size;
+  free(pointer);
+}
+
+START_TEST(test_memory_1) {
+  long long bytes = matrix_bytes(3, 3);
+  matrix_t m1 = init_matrix();
+  matrix_t m2 = init_matrix();
+  s21_memory_scope_t scope;
+  s21_memory_stats_t delta;
+
+  s21_memory_scope_begin(&scope);
+  s21_create_matrix(3, 3, &m1);
+  s21_transpose(&m1, &m2);
+  s21_memory_scope_delta(&scope, &delta);
+  ck_assert_int_eq(delta.live_bytes, 2 * bytes);
+  s21_remove_matrix(&m2);
+  s21_remove_matrix(&m1);
+  s21_memory_scope_end(&scope, &delta);
+
+  ck_assert_int_eq(delta.live_bytes, 0);
+  ck_assert_int_eq(delta.peak_bytes, 2 * bytes);
+  ck_assert_int_eq(delta.allocations, 2);
+  ck_assert_int_eq(delta.deallocations, 2);
+
+  s21_memory_stats_t process;
+  s21_memory_process_stats(&process);
+  ck_assert_int_ge(process.peak_bytes, 2 * bytes);
+}
+END_TEST
+
+START_TEST(test_memory_2) {
+  counting_arena_t arena = {0, 0, -1};
+  s21_allocator_t allocator = {counting_allocate, counting_deallocate,
+                               &arena};
+  matrix_t m = init_matrix();
+
+  s21_set_allocator(&allocator);
+  ck_assert_int_eq(s21_create_matrix(4, 2, &m), OK);
+  // one block, the rows follow each other from an aligned start
+  ck_assert_int_eq((uintptr_t)m.matrix[0] % MATRIX_ALIGNMENT, 0);
+  ck_assert_ptr_eq(m.matrix[3], m.matrix[0] + 6);
+  ck_assert_double_eq(m.matrix[3][1], 0);
+  s21_remove_matrix(&m);
+  ck_assert_int_eq(arena.allocated, matrix_bytes(4, 2));
+  ck_assert_int_eq(arena.allocated, arena.released);
+
+  arena.fail_after = 0;
+  ck_assert_int_eq(s21_create_matrix(4, 2, &m), MEMORY_ERROR);
+  ck_assert_ptr_eq(m.matrix, NULL);
+  ck_assert_int_eq(arena.allocated, arena.released);
+  s21_set_allocator(NULL);
+}
+END_TEST
+
+START_TEST(test_memory_3) {
+  counting_arena_t arena = {0, 0, -1};
+  s21_allocator_t allocator = {counting_allocate, counting_deallocate,
+                               &arena};
+  matrix_t m1 = init_matrix();
+  matrix_t m2 = init_matrix();
+  matrix_t m3 = init_matrix();
+
+  // calloc pages, zero without being written
+  ck_assert_int_eq(s21_create_matrix(1024, 1024, &m1), OK);
+  ck_assert_double_eq(m1.matrix[0][0], 0);
+  ck_assert_double_eq(m1.matrix[1023][1023], 0);
+  s21_remove_matrix(&m1);
+
+  // results skip the zeroing, every element is written
+  s21_set_allocator(&allocator);
+  s21_create_matrix(3, 2, &m1);
+  fill_matrix_increment(&m1, 1);
+  ck_assert_int_eq(s21_transpose(&m1, &m2), OK);
+  ck_assert_int_eq(s21_mult_matrix(&m1, &m2, &m3), OK);
+  ck_assert_double_eq(m2.matrix[1][2], 6);
+  ck_assert_double_eq(m3.matrix[2][2], 61);
+  s21_remove_matrix(&m1);
+  s21_remove_matrix(&m2);
+  s21_remove_matrix(&m3);
+  ck_assert_int_eq(arena.allocated, arena.released);
+  s21_set_allocator(NULL);
+}
+END_TEST
+
 // SUITES
 
 Suite *suite_create_matrix() {
@@ -870,6 +1394,96 @@ Suite *suite_inverse_matrix() {
   return s;
 }
 
+Suite *suite_gemm() {
+  Suite *s = suite_create("suite_gemm");
+  TCase *tc_1 = tcase_create("tc_1");
+  TCase *tc_2 = tcase_create("tc_2");
+
+  tcase_add_test(tc_1, test_gemm_1);
+  tcase_add_test(tc_2, test_gemm_2);
+
+  suite_add_tcase(s, tc_1);
+  suite_add_tcase(s, tc_2);
+
+  return s;
+}
+
+Suite *suite_into() {
+  Suite *s = suite_create("suite_into");
+  TCase *tc_1 = tcase_create("tc_1");
+  TCase *tc_2 = tcase_create("tc_2");
+  TCase *tc_3 = tcase_create("tc_3");
+
+  tcase_add_test(tc_1, test_into_1);
+  tcase_add_test(tc_2, test_into_2);
+  tcase_add_test(tc_3, test_into_3);
+
+  suite_add_tcase(s, tc_1);
+  suite_add_tcase(s, tc_2);
+  suite_add_tcase(s, tc_3);
+
+  return s;
+}
+
+Suite *suite_context() {
+  Suite *s = suite_create("suite_context");
+  TCase *tc_1 = tcase_create("tc_1");
+  TCase *tc_2 = tcase_create("tc_2");
+
+  tcase_add_test(tc_1, test_context_1);
+  tcase_add_test(tc_2, test_context_2);
+
+  suite_add_tcase(s, tc_1);
+  suite_add_tcase(s, tc_2);
+
+  return s;
+}
+
+Suite *suite_compare() {
+  Suite *s = suite_create("suite_compare");
+  TCase *tc_1 = tcase_create("tc_1");
+  TCase *tc_2 = tcase_create("tc_2");
+
+  tcase_add_test(tc_1, test_compare_1);
+  tcase_add_test(tc_2, test_compare_2);
+
+  suite_add_tcase(s, tc_1);
+  suite_add_tcase(s, tc_2);
+
+  return s;
+}
+
+Suite *suite_stats() {
+  Suite *s = suite_create("suite_stats");
+  TCase *tc_1 = tcase_create("tc_1");
+  TCase *tc_2 = tcase_create("tc_2");
+
+  tcase_add_test(tc_1, test_stats_1);
+  tcase_add_test(tc_2, test_stats_2);
+
+  suite_add_tcase(s, tc_1);
+  suite_add_tcase(s, tc_2);
+
+  return s;
+}
+
+Suite *suite_memory() {
+  Suite *s = suite_create("suite_memory");
+  TCase *tc_1 = tcase_create("tc_1");
+  TCase *tc_2 = tcase_create("tc_2");
+  TCase *tc_3 = tcase_create("tc_3");
+
+  tcase_add_test(tc_1, test_memory_1);
+  tcase_add_test(tc_2, test_memory_2);
+  tcase_add_test(tc_3, test_memory_3);
+
+  suite_add_tcase(s, tc_1);
+  suite_add_tcase(s, tc_2);
+  suite_add_tcase(s, tc_3);
+
+  return s;
+}
+
 // MAIN
 
 void run_test(Suite *thesuit) {
@@ -898,6 +1512,12 @@ int main() {
   Suite *s_calc_complements = suite_calc_complements();
   Suite *s_determinant = suite_determinant();
   Suite *s_inverse_matrix = suite_inverse_matrix();
+  Suite *s_gemm = suite_gemm();
+  Suite *s_into = suite_into();
+  Suite *s_context = suite_context();
+  Suite *s_compare = suite_compare();
+  Suite *s_stats = suite_stats();
+  Suite *s_memory = suite_memory();
 
   run_test(s_create_matrix);
   run_test(s_remove_matrix);
@@ -910,6 +1530,12 @@ int main() {
   run_test(s_calc_complements);
   run_test(s_determinant);
   run_test(s_inverse_matrix);
+  run_test(s_gemm);
+  run_test(s_into);
+  run_test(s_context);
+  run_test(s_compare);
+  run_test(s_stats);
+  run_test(s_memory);
 
   return 0;
 }
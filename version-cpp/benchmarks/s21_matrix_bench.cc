@@ -0,0 +1,566 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "../src/s21_allocator.h"
+#include "../src/s21_factorization.h"
+#include "../src/s21_lazy.h"
+#include "../src/s21_matrix_cache.h"
+#include "../src/s21_matrix_oop.h"
+
+// O(n^2) operations sweep the full 2..4096 range, the O(n^3) products run
+// from kMinProductSize to kMaxProductSize, the cofactor expansion used by
+// Determinant, CalcComplements and InverseMatrix grows factorially, so those
+// sweeps stop at kMaxExpansionSize
+
+constexpr int kMinSize = 2;
+constexpr int kMaxSize = 4096;
+constexpr int kMaxExpansionSize = 8;
+constexpr int kMinProductSize = 256;
+constexpr int kMaxProductSize = 2048;
+
+// deterministic, well-conditioned fill: small pseudo-random values with a
+// dominant diagonal, so InverseMatrix never hits a zero determinant
+static S21Matrix MakeMatrix(int rows, int cols) {
+  S21Matrix result(rows, cols);
+  unsigned state = 12345u + static_cast<unsigned>(rows * 31 + cols);
+
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) {
+      state = state * 1103515245u + 12345u;
+      result(i, j) = static_cast<double>(state >> 16 & 0xFF) / 256.0 - 0.5;
+    }
+    if (i < cols) result(i, i) += cols;
+  }
+  return result;
+}
+
+static void SetElementsCounters(benchmark::State& state, int64_t elements) {
+  state.SetItemsProcessed(state.iterations() * elements);
+  state.SetBytesProcessed(state.iterations() * elements *
+                          static_cast<int64_t>(sizeof(double)));
+}
+
+// constructors, destructor
+
+static void BM_Construct(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    S21Matrix matrix(size, size);
+    benchmark::DoNotOptimize(matrix.GetMatrix());
+  }
+  SetElementsCounters(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_Construct)->RangeMultiplier(2)->Range(kMinSize, kMaxSize);
+
+static void BM_Copy(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  S21Matrix origin = MakeMatrix(size, size);
+  for (auto _ : state) {
+    S21Matrix copy(origin);
+    benchmark::DoNotOptimize(copy.GetMatrix());
+  }
+  SetElementsCounters(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_Copy)->RangeMultiplier(2)->Range(kMinSize, kMaxSize);
+
+// copies of a copy-on-write matrix: 0: a read-only snapshot, 1: a snapshot
+// written once, which pays for the deep copy then
+static void BM_CopyOnWrite(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  S21Matrix origin = MakeMatrix(size, size);
+  origin.SetCopyOnWrite(true);
+  for (auto _ : state) {
+    S21Matrix copy(origin);
+    if (state.range(1) == 1) copy(0, 0) = 1.0;
+    benchmark::DoNotOptimize(copy.GetMatrix());
+  }
+  SetElementsCounters(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_CopyOnWrite)->ArgsProduct({{64, 512}, {0, 1}});
+
+static void BM_CopyAssign(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  S21Matrix origin = MakeMatrix(size, size);
+  S21Matrix copy(size, size);
+  for (auto _ : state) {
+    copy = origin;
+    benchmark::DoNotOptimize(copy.GetMatrix());
+  }
+  SetElementsCounters(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_CopyAssign)->RangeMultiplier(2)->Range(kMinSize, kMaxSize);
+
+static void BM_Move(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  S21Matrix origin = MakeMatrix(size, size);
+  for (auto _ : state) {
+    S21Matrix moved(std::move(origin));
+    benchmark::DoNotOptimize(moved.GetMatrix());
+    // the moved-from origin owns nothing, it's rebuilt in place since the
+    // class has no move assignment
+    new (&origin) S21Matrix(std::move(moved));
+  }
+}
+BENCHMARK(BM_Move)->RangeMultiplier(2)->Range(kMinSize, kMaxSize);
+
+// getters, setters
+
+static void BM_Resize(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  S21Matrix matrix = MakeMatrix(size, size);
+  for (auto _ : state) {
+    matrix.SetRowsCount(size + 1);
+    matrix.SetColsCount(size + 1);
+    matrix.SetRowsCount(size);
+    matrix.SetColsCount(size);
+    benchmark::DoNotOptimize(matrix.GetMatrix());
+  }
+  SetElementsCounters(state, 4 * state.range(0) * state.range(0));
+}
+BENCHMARK(BM_Resize)->RangeMultiplier(2)->Range(kMinSize, kMaxSize);
+
+// public functions (lib)
+
+static void BM_EqMatrix(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  S21Matrix matrix1 = MakeMatrix(size, size);
+  S21Matrix matrix2 = MakeMatrix(size, size);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(matrix1.EqMatrix(matrix2));
+  }
+  SetElementsCounters(state, 2 * state.range(0) * state.range(0));
+}
+BENCHMARK(BM_EqMatrix)->RangeMultiplier(2)->Range(kMinSize, kMaxSize);
+
+static void BM_SumMatrix(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  S21Matrix matrix1 = MakeMatrix(size, size);
+  S21Matrix matrix2 = MakeMatrix(size, size);
+  for (auto _ : state) {
+    matrix1.SumMatrix(matrix2);
+    benchmark::DoNotOptimize(matrix1.GetMatrix());
+  }
+  SetElementsCounters(state, 2 * state.range(0) * state.range(0));
+}
+BENCHMARK(BM_SumMatrix)->RangeMultiplier(2)->Range(kMinSize, kMaxSize);
+
+static void BM_SubMatrix(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  S21Matrix matrix1 = MakeMatrix(size, size);
+  S21Matrix matrix2 = MakeMatrix(size, size);
+  for (auto _ : state) {
+    matrix1.SubMatrix(matrix2);
+    benchmark::DoNotOptimize(matrix1.GetMatrix());
+  }
+  SetElementsCounters(state, 2 * state.range(0) * state.range(0));
+}
+BENCHMARK(BM_SubMatrix)->RangeMultiplier(2)->Range(kMinSize, kMaxSize);
+
+static void BM_MulNumber(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  S21Matrix matrix = MakeMatrix(size, size);
+  for (auto _ : state) {
+    matrix.MulNumber(1.0000001);
+    benchmark::DoNotOptimize(matrix.GetMatrix());
+  }
+  SetElementsCounters(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_MulNumber)->RangeMultiplier(2)->Range(kMinSize, kMaxSize);
+
+static void BM_MulMatrix(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  S21Matrix matrix1 = MakeMatrix(size, size);
+  S21Matrix matrix2 = MakeMatrix(size, size);
+  matrix2.SetMatrix(1.0);
+  for (auto _ : state) {
+    matrix1.MulMatrix(matrix2);
+    benchmark::DoNotOptimize(matrix1.GetMatrix());
+  }
+  SetElementsCounters(state, 2 * state.range(0) * state.range(0));
+}
+BENCHMARK(BM_MulMatrix)->RangeMultiplier(2)->Range(kMinSize, kMaxSize);
+
+// accuracy vs speed: both algorithms report their largest deviation from
+// the classical product, relative to its largest element
+static void BM_Product(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  S21ProductAlgorithm algorithm = static_cast<S21ProductAlgorithm>(
+      state.range(1));
+  S21Matrix matrix1 = MakeMatrix(size, size) * (1.0 / 3.0);
+  S21Matrix matrix2 = MakeMatrix(size, size) * (1.0 / 7.0);
+  S21Matrix result;
+
+  for (auto _ : state) {
+    result = matrix1.Product(matrix2, algorithm);
+    benchmark::DoNotOptimize(result.GetMatrix());
+  }
+
+  S21Matrix reference =
+      matrix1.Product(matrix2, S21ProductAlgorithm::kClassical);
+  double error = 0;
+  double magnitude = 0;
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) {
+      error = std::max(error, std::fabs(result(i, j) - reference(i, j)));
+      magnitude = std::max(magnitude, std::fabs(reference(i, j)));
+    }
+  }
+  state.counters["relative_error"] = error / magnitude;
+  state.counters["flops"] =
+      benchmark::Counter(2.0 * size * size * size,
+                         benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_Product)
+    ->ArgsProduct({benchmark::CreateRange(kMinProductSize, kMaxProductSize,
+                                          2),
+                   {static_cast<int64_t>(S21ProductAlgorithm::kClassical),
+                    static_cast<int64_t>(S21ProductAlgorithm::kStrassen)}})
+    ->Unit(benchmark::kMillisecond);
+
+// the in-place update result += 0.5 * a * op(b), with b read transposed by
+// the kernel in the second variant
+static void BM_Gemm(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  bool transposed = state.range(1) != 0;
+  S21Matrix matrix1 = MakeMatrix(size, size);
+  S21Matrix matrix2 = MakeMatrix(size, size);
+  S21Matrix result = MakeMatrix(size, size);
+
+  for (auto _ : state) {
+    result.Gemm(0.5, matrix1, false, matrix2, transposed, 1.0);
+    benchmark::DoNotOptimize(result.GetMatrix());
+  }
+  state.counters["flops"] =
+      benchmark::Counter(2.0 * size * size * size,
+                         benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_Gemm)
+    ->ArgsProduct({benchmark::CreateRange(kMinProductSize, kMaxProductSize,
+                                          2),
+                   {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_Gemv(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  bool transposed = state.range(1) != 0;
+  S21Matrix matrix = MakeMatrix(size, size);
+  S21Vector x = matrix.GetRow(0);
+  S21Vector y(size);
+
+  for (auto _ : state) {
+    y.Gemv(1.0, matrix, transposed, x, 0.0);
+    benchmark::DoNotOptimize(y.GetData());
+  }
+  SetElementsCounters(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_Gemv)->ArgsProduct(
+    {benchmark::CreateRange(kMinSize, kMaxSize, 4), {0, 1}});
+
+static void BM_Dot(benchmark::State& state) {
+  S21Vector x(static_cast<int>(state.range(0)));
+  x.SetVector(0.5);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(x.Dot(x));
+  }
+  SetElementsCounters(state, state.range(0));
+}
+BENCHMARK(BM_Dot)->RangeMultiplier(8)->Range(kMinSize, 1 << 24);
+
+// second argument: 0 uniform, 1 normal, 2 bernoulli
+static void BM_Random(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  const S21Distribution distributions[] = {S21Distribution::Uniform(),
+                                           S21Distribution::Normal(),
+                                           S21Distribution::Bernoulli()};
+  std::uint64_t seed = 0;
+
+  for (auto _ : state) {
+    S21Matrix result =
+        S21Matrix::Random(size, size, distributions[state.range(1)], seed++);
+    benchmark::DoNotOptimize(result.GetMatrix());
+  }
+  SetElementsCounters(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_Random)->ArgsProduct(
+    {benchmark::CreateRange(kMinSize, kMaxSize, 8), {0, 1, 2}});
+
+// 0: Sum, 1: ColSums, 2: FrobeniusNorm, 3: Max
+static void BM_Reduce(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  S21Matrix matrix = MakeMatrix(size, size);
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case 0:
+        benchmark::DoNotOptimize(matrix.Sum());
+        break;
+      case 1:
+        benchmark::DoNotOptimize(matrix.ColSums());
+        break;
+      case 2:
+        benchmark::DoNotOptimize(matrix.FrobeniusNorm());
+        break;
+      default:
+        benchmark::DoNotOptimize(matrix.Max());
+    }
+  }
+  SetElementsCounters(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_Reduce)->ArgsProduct(
+    {benchmark::CreateRange(kMinSize, kMaxSize, 8), {0, 1, 2, 3}});
+
+// a user loop summing every element: 0: operator(), 1: At, 2: RowPtr,
+// 3: iterators
+static void BM_ElementLoop(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  const S21Matrix matrix = MakeMatrix(size, size);
+  for (auto _ : state) {
+    double sum = 0;
+    if (state.range(1) == 0) {
+      for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) sum += matrix(i, j);
+      }
+    } else if (state.range(1) == 1) {
+      for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) sum += matrix.At(i, j);
+      }
+    } else if (state.range(1) == 2) {
+      for (int i = 0; i < size; i++) {
+        const double* row = matrix.RowPtr(i);
+        for (int j = 0; j < size; j++) sum += row[j];
+      }
+    } else {
+      for (double value : matrix) sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  SetElementsCounters(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_ElementLoop)->ArgsProduct({{64, 512}, {0, 1, 2, 3}});
+
+// Map with the vectorized functors against lambdas calling libm: 0: S21Exp,
+// 1: exp, 2: S21Sqrt, 3: sqrt
+static void BM_Map(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  S21Matrix matrix = MakeMatrix(size, size);
+  auto map = [&matrix](const auto& function) {
+    S21Matrix result = matrix.Map(function);
+    benchmark::DoNotOptimize(result.GetMatrix());
+  };
+  for (auto _ : state) {
+    switch (state.range(1)) {
+      case 0:
+        map(S21Exp());
+        break;
+      case 1:
+        map([](double value) { return exp(value); });
+        break;
+      case 2:
+        map(S21Sqrt());
+        break;
+      default:
+        map([](double value) { return sqrt(value); });
+    }
+  }
+  SetElementsCounters(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_Map)->ArgsProduct({{64, 512}, {0, 1, 2, 3}});
+
+// 0: SumBroadcast of a bias row, 1: MulBroadcast of a column (of ones, so
+// repeated calls don't decay into subnormals), 2: the bias row expanded to a
+// full matrix, then SumMatrix
+static void BM_Broadcast(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  S21Matrix matrix = MakeMatrix(size, size);
+  S21Matrix row = MakeMatrix(1, size);
+  S21Matrix col(size, 1);
+  col.SetMatrix(1.0);
+  for (auto _ : state) {
+    if (state.range(1) == 0) {
+      matrix.SumBroadcast(row);
+    } else if (state.range(1) == 1) {
+      matrix.MulBroadcast(col);
+    } else {
+      S21Matrix expanded(size, size);
+      for (int i = 0; i < size; i++) {
+        std::copy_n(row.RowPtr(0), size, expanded.RowPtr(i));
+      }
+      matrix.SumMatrix(expanded);
+    }
+    benchmark::DoNotOptimize(matrix.GetMatrix());
+  }
+  SetElementsCounters(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_Broadcast)->ArgsProduct({{64, 512, 2048}, {0, 1, 2}});
+
+// (a * b)^T + (a * b) * 2 with products, an element-wise chain of the same
+// shape, eager (0) against the lazy graph (1)
+static void BM_LazyProduct(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  S21Matrix a = MakeMatrix(size, size);
+  S21Matrix b = MakeMatrix(size, size);
+  S21LazyMatrix lazyA(a);
+  S21LazyMatrix lazyB(b);
+  for (auto _ : state) {
+    S21Matrix result;
+    if (state.range(1) == 0) {
+      result = a.Product(b).Transpose() + a.Product(b) * 2.0;
+    } else {
+      result = (lazyA.Product(lazyB).Transpose() + lazyA.Product(lazyB) * 2.0)
+                   .Evaluate();
+    }
+    benchmark::DoNotOptimize(result.GetMatrix());
+  }
+  SetElementsCounters(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_LazyProduct)->ArgsProduct({{256, 1024}, {0, 1}});
+
+static void BM_LazyFused(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  S21Matrix x = MakeMatrix(size, size);
+  S21Matrix y = MakeMatrix(size, size);
+  S21LazyMatrix lazyX(x);
+  S21LazyMatrix lazyY(y);
+  for (auto _ : state) {
+    S21Matrix result;
+    if (state.range(1) == 0) {
+      result = (x + y) * 0.5 - x * y;
+    } else {
+      result = ((lazyX + lazyY) * 0.5 - lazyX * lazyY).Evaluate();
+    }
+    benchmark::DoNotOptimize(result.GetMatrix());
+  }
+  SetElementsCounters(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_LazyFused)->ArgsProduct({{64, 512, 2048}, {0, 1}});
+
+// the same 8 matrices inverted over and over, each time as a new object
+// (the copy made by * 1.0), so every lookup hashes the elements. 0: no
+// cache, 1: S21MatrixCache
+static void BM_Cache(benchmark::State& state) {
+  constexpr int kMatrices = 8;
+  int size = static_cast<int>(state.range(0));
+  std::vector<S21Matrix> matrices;
+  for (int i = 0; i < kMatrices; i++) {
+    S21Matrix matrix = MakeMatrix(size, size);
+    matrix(0, 0) += i;
+    matrices.push_back(matrix);
+  }
+  S21MatrixCache::SetBudget(state.range(1) == 0 ? 0 : 64 << 20);
+  S21MatrixCache::ResetStats();
+  int next = 0;
+  for (auto _ : state) {
+    S21Matrix request = matrices[next] * 1.0;
+    S21Matrix result = request.InverseMatrix();
+    benchmark::DoNotOptimize(result.GetMatrix());
+    next = (next + 1) % kMatrices;
+  }
+  S21CacheStats stats = S21MatrixCache::GetStats();
+  state.counters["hits"] = static_cast<double>(stats.hits);
+  S21MatrixCache::SetBudget(0);
+}
+BENCHMARK(BM_Cache)->ArgsProduct({{4, 6, kMaxExpansionSize}, {0, 1}});
+
+// one row of a matrix replaced, and its inverse wanted: 0: factorize again
+// and invert, 1: S21LU::SetRow, 2: UpdateInverse of the held inverse
+static void BM_RankUpdate(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  S21Matrix matrix = MakeMatrix(size, size);
+  S21LU lu(matrix);
+  S21Matrix inverse = lu.InverseMatrix();
+  S21Vector rows[2] = {matrix.GetRow(0), MakeMatrix(1, size).GetRow(0)};
+  int next = 1;
+  for (auto _ : state) {
+    const S21Vector& row = rows[next];
+    if (state.range(1) == 0) {
+      matrix.SetRow(0, row);
+      S21Matrix result = S21LU(matrix).InverseMatrix();
+      benchmark::DoNotOptimize(result.GetMatrix());
+    } else if (state.range(1) == 1) {
+      lu.SetRow(0, row);
+      benchmark::DoNotOptimize(lu.GetMatrix().GetMatrix());
+    } else {
+      S21Vector change(row);
+      change.Axpy(-1.0, rows[1 - next]);
+      S21Vector unit(size);
+      unit(0) = 1.0;
+      inverse.UpdateInverse(unit, change);
+      benchmark::DoNotOptimize(inverse.GetMatrix());
+    }
+    next = 1 - next;
+  }
+  SetElementsCounters(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_RankUpdate)->ArgsProduct({{256, 1024}, {0, 1, 2}});
+
+static void BM_Transpose(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  S21Matrix matrix = MakeMatrix(size, size);
+  for (auto _ : state) {
+    S21Matrix result = matrix.Transpose();
+    benchmark::DoNotOptimize(result.GetMatrix());
+  }
+  SetElementsCounters(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_Transpose)->RangeMultiplier(2)->Range(kMinSize, kMaxSize);
+
+// Transpose reads down the columns, a TLB miss per element with 4 KiB
+// pages once the matrix outgrows the TLB reach. placement of the matrices:
+// 0: heap, 1: transparent huge pages, 2: huge pages touched first by the
+// pool, 3: huge pages interleaved over the NUMA nodes
+static void BM_Placement(benchmark::State& state) {
+  constexpr S21Placement kPlacements[] = {
+      {S21HugePages::kNone, S21NumaPlacement::kLocal, 2 << 20},
+      {S21HugePages::kTransparent, S21NumaPlacement::kLocal, 2 << 20},
+      {S21HugePages::kTransparent, S21NumaPlacement::kFirstTouch, 2 << 20},
+      {S21HugePages::kTransparent, S21NumaPlacement::kInterleave, 2 << 20},
+  };
+  int size = static_cast<int>(state.range(0));
+  S21Allocator::SetPlacement(kPlacements[state.range(1)]);
+  {
+    S21Matrix matrix = MakeMatrix(size, size);
+    for (auto _ : state) {
+      S21Matrix result = matrix.Transpose();
+      benchmark::DoNotOptimize(result.GetMatrix());
+    }
+  }
+  S21Allocator::ResetPlacement();
+  SetElementsCounters(state, state.range(0) * state.range(0));
+}
+BENCHMARK(BM_Placement)->ArgsProduct({{512, 2048, 4096}, {0, 1, 2, 3}});
+
+static void BM_Determinant(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  S21Matrix matrix = MakeMatrix(size, size);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(matrix.Determinant());
+  }
+}
+BENCHMARK(BM_Determinant)->DenseRange(kMinSize, kMaxExpansionSize);
+
+static void BM_CalcComplements(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  S21Matrix matrix = MakeMatrix(size, size);
+  for (auto _ : state) {
+    S21Matrix result = matrix.CalcComplements();
+    benchmark::DoNotOptimize(result.GetMatrix());
+  }
+}
+BENCHMARK(BM_CalcComplements)->DenseRange(kMinSize, kMaxExpansionSize);
+
+static void BM_InverseMatrix(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  S21Matrix matrix = MakeMatrix(size, size);
+  for (auto _ : state) {
+    S21Matrix result = matrix.InverseMatrix();
+    benchmark::DoNotOptimize(result.GetMatrix());
+  }
+}
+BENCHMARK(BM_InverseMatrix)->DenseRange(kMinSize, kMaxExpansionSize);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,325 @@
+#include "s21_allocator.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <unordered_set>
+#include <utility>
+
+#include "s21_matrix_stats.h"
+
+namespace {
+
+constexpr std::size_t kHugePageSize = 2 << 20;
+constexpr S21Placement kDefaultPlacement = {
+    S21HugePages::kNone, S21NumaPlacement::kLocal, kHugePageSize};
+
+// the fields are read by every allocation, on any thread. one changed while
+// a block is allocated may be seen old or new, the block is released by
+// what its allocation did either way
+std::atomic<S21HugePages> hugePages{kDefaultPlacement.hugePages};
+std::atomic<S21NumaPlacement> numa{kDefaultPlacement.numa};
+std::atomic<std::size_t> largeBytes{kDefaultPlacement.largeBytes};
+
+S21Placement LoadPlacement() noexcept {
+  return {hugePages.load(std::memory_order_relaxed),
+          numa.load(std::memory_order_relaxed),
+          largeBytes.load(std::memory_order_relaxed)};
+}
+
+bool IsMapped(const S21Placement& placement, std::size_t bytes) noexcept {
+#ifdef __linux__
+  return bytes >= placement.largeBytes &&
+         (placement.hugePages != S21HugePages::kNone ||
+          placement.numa != S21NumaPlacement::kLocal);
+#else
+  (void)placement;
+  (void)bytes;
+  return false;
+#endif
+}
+
+#ifdef __linux__
+
+// whole huge pages, so the block doesn't share one with the heap
+std::size_t MappedLength(std::size_t bytes) noexcept {
+  return (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+}
+
+// the kernel intersects the mask with the allowed nodes. the policy is
+// advice: a kernel without NUMA support leaves the pages local
+void Interleave(void* pointer, std::size_t length) noexcept {
+  constexpr int kMpolInterleave = 3;
+  unsigned long nodes = ~0ul;
+  syscall(SYS_mbind, pointer, length, kMpolInterleave, &nodes,
+          8 * sizeof(nodes) + 1, 0);
+}
+
+// the blocks mapped by MapBlock, a block is unmapped when it is found here
+// and freed otherwise. the lock is only taken while some are live, and for
+// blocks at least as large as the smallest one ever mapped
+std::mutex mappedMutex;
+std::unordered_set<void*> mappedBlocks;
+std::atomic<std::size_t> mappedCount{0};
+std::atomic<std::size_t> mappedMinBytes{SIZE_MAX};
+
+bool RegisterMapped(void* pointer, std::size_t bytes) noexcept {
+  try {
+    std::lock_guard<std::mutex> lock(mappedMutex);
+    mappedBlocks.insert(pointer);
+    mappedCount.fetch_add(1, std::memory_order_relaxed);
+    if (bytes < mappedMinBytes.load(std::memory_order_relaxed)) {
+      mappedMinBytes.store(bytes, std::memory_order_relaxed);
+    }
+    return true;
+  } catch (...) {
+    return false;
+  }
+}
+
+bool UnregisterMapped(void* pointer, std::size_t bytes) noexcept {
+  if (mappedCount.load(std::memory_order_relaxed) == 0 ||
+      bytes < mappedMinBytes.load(std::memory_order_relaxed)) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(mappedMutex);
+  if (mappedBlocks.erase(pointer) == 0) return false;
+  mappedCount.fetch_sub(1, std::memory_order_relaxed);
+  return true;
+}
+
+// fresh pages, zeroed by the OS on first touch
+void* MapBlock(const S21Placement& placement, std::size_t bytes) noexcept {
+  std::size_t length = MappedLength(bytes);
+  int protection = PROT_READ | PROT_WRITE;
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  void* result = MAP_FAILED;
+
+  if (placement.hugePages == S21HugePages::kExplicit) {
+    result = mmap(nullptr, length, protection, flags | MAP_HUGETLB, -1, 0);
+  }
+  if (result == MAP_FAILED) {
+    result = mmap(nullptr, length, protection, flags, -1, 0);
+    if (result != MAP_FAILED && placement.hugePages != S21HugePages::kNone) {
+      madvise(result, length, MADV_HUGEPAGE);
+    }
+  }
+  if (result != MAP_FAILED &&
+      placement.numa == S21NumaPlacement::kInterleave) {
+    Interleave(result, length);
+  }
+  if (result != MAP_FAILED && !RegisterMapped(result, bytes)) {
+    munmap(result, length);
+    result = MAP_FAILED;
+  }
+  return result == MAP_FAILED ? nullptr : result;
+}
+
+#endif
+
+void* DefaultAllocate(std::size_t bytes, void*) {
+#ifdef __linux__
+  S21Placement placement = LoadPlacement();
+  if (IsMapped(placement, bytes)) return MapBlock(placement, bytes);
+#endif
+  return std::malloc(bytes);
+}
+
+// by the way the block was allocated, not by the current placement
+void DefaultDeallocate(void* pointer, std::size_t bytes, void*) {
+#ifdef __linux__
+  if (UnregisterMapped(pointer, bytes)) {
+    munmap(pointer, MappedLength(bytes));
+    return;
+  }
+#else
+  (void)bytes;
+#endif
+  std::free(pointer);
+}
+
+constexpr S21AllocatorHooks kDefaultHooks = {DefaultAllocate,
+                                             DefaultDeallocate, nullptr};
+
+S21AllocatorHooks hooks = kDefaultHooks;
+
+std::atomic<std::int64_t> processLiveBytes{0};
+std::atomic<std::int64_t> processPeakBytes{0};
+std::atomic<std::uint64_t> processAllocations{0};
+std::atomic<std::uint64_t> processDeallocations{0};
+
+void UpdateProcessPeak(std::int64_t live) noexcept {
+  std::int64_t peak = processPeakBytes.load(std::memory_order_relaxed);
+  while (live > peak && !processPeakBytes.compare_exchange_weak(
+                            peak, live, std::memory_order_relaxed)) {
+  }
+}
+
+void ReportAtExit() { S21Allocator::PrintReport(stderr); }
+
+bool RegisterReport() {
+  const char* variable = std::getenv("S21_MATRIX_MEMORY_REPORT");
+  if (variable != nullptr && variable[0] == '1') {
+    std::atexit(ReportAtExit);
+  }
+  return true;
+}
+
+const bool kReportRegistered = RegisterReport();
+
+}  // namespace
+
+// public functions
+
+void* S21Allocator::Allocate(std::size_t bytes) {
+  void* result = hooks.allocate(bytes, hooks.context);
+  if (result == nullptr) throw std::bad_alloc();
+
+  CountAllocation(bytes);
+  return result;
+}
+
+void* S21Allocator::AllocateZeroed(std::size_t bytes) {
+  void* result = nullptr;
+
+  if (hooks.allocate == DefaultAllocate) {
+    result = IsMapped(LoadPlacement(), bytes) ? DefaultAllocate(bytes, nullptr)
+                                              : std::calloc(1, bytes);
+  } else {
+    result = hooks.allocate(bytes, hooks.context);
+    if (result != nullptr) std::memset(result, 0, bytes);
+  }
+  if (result == nullptr) throw std::bad_alloc();
+
+  CountAllocation(bytes);
+  return result;
+}
+
+void S21Allocator::CountAllocation(std::size_t bytes) noexcept {
+  S21MemoryStats& thread = ThreadStats();
+  thread.liveBytes += static_cast<std::int64_t>(bytes);
+  thread.peakBytes = std::max(thread.peakBytes, thread.liveBytes);
+  thread.allocations++;
+
+  std::int64_t live =
+      processLiveBytes.fetch_add(static_cast<std::int64_t>(bytes),
+                                 std::memory_order_relaxed) +
+      static_cast<std::int64_t>(bytes);
+  UpdateProcessPeak(live);
+  processAllocations.fetch_add(1, std::memory_order_relaxed);
+
+  S21OperationTimer::AddAllocatedBytes(bytes);
+}
+
+void S21Allocator::Deallocate(void* pointer, std::size_t bytes) noexcept {
+  if (pointer != nullptr) {
+    hooks.deallocate(pointer, bytes, hooks.context);
+
+    S21MemoryStats& thread = ThreadStats();
+    thread.liveBytes -= static_cast<std::int64_t>(bytes);
+    thread.deallocations++;
+
+    processLiveBytes.fetch_sub(static_cast<std::int64_t>(bytes),
+                               std::memory_order_relaxed);
+    processDeallocations.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void S21Allocator::SetHooks(const S21AllocatorHooks& newHooks) noexcept {
+  hooks = newHooks;
+}
+
+void S21Allocator::ResetHooks() noexcept { hooks = kDefaultHooks; }
+
+void S21Allocator::SetPlacement(const S21Placement& placement) noexcept {
+  hugePages.store(placement.hugePages, std::memory_order_relaxed);
+  numa.store(placement.numa, std::memory_order_relaxed);
+  largeBytes.store(placement.largeBytes, std::memory_order_relaxed);
+}
+
+void S21Allocator::ResetPlacement() noexcept {
+  SetPlacement(kDefaultPlacement);
+}
+
+S21Placement S21Allocator::GetPlacement() noexcept { return LoadPlacement(); }
+
+bool S21Allocator::IsPlaced(std::size_t bytes) noexcept {
+  return hooks.allocate == DefaultAllocate && IsMapped(LoadPlacement(), bytes);
+}
+
+S21MemoryStats S21Allocator::GetThreadStats() noexcept {
+  return ThreadStats();
+}
+
+S21MemoryStats S21Allocator::GetProcessStats() noexcept {
+  return {processLiveBytes.load(std::memory_order_relaxed),
+          processPeakBytes.load(std::memory_order_relaxed),
+          processAllocations.load(std::memory_order_relaxed),
+          processDeallocations.load(std::memory_order_relaxed)};
+}
+
+void S21Allocator::ResetThreadStats() noexcept { ThreadStats() = {}; }
+
+void S21Allocator::PrintReport(std::FILE* stream) noexcept {
+  S21MemoryStats stats = GetProcessStats();
+
+  std::fprintf(stream,
+               "s21_matrix memory: peak %lld bytes, %llu allocations, "
+               "%llu deallocations, %lld bytes live\n",
+               static_cast<long long>(stats.peakBytes),
+               static_cast<unsigned long long>(stats.allocations),
+               static_cast<unsigned long long>(stats.deallocations),
+               static_cast<long long>(stats.liveBytes));
+  if (stats.liveBytes > 0) {
+    std::fprintf(stream, "s21_matrix memory: %lld bytes leaked\n",
+                 static_cast<long long>(stats.liveBytes));
+  }
+}
+
+// private functions
+
+S21MemoryStats& S21Allocator::ThreadStats() noexcept {
+  thread_local S21MemoryStats stats = {};
+  return stats;
+}
+
+// S21MemoryScope
+
+S21MemoryScope::S21MemoryScope() noexcept : S21MemoryScope(Reporter()) {}
+
+S21MemoryScope::S21MemoryScope(Reporter reporter) noexcept
+    : start_(S21Allocator::ThreadStats()),
+      outerPeak_(start_.peakBytes),
+      reporter_(std::move(reporter)) {
+  // the thread peak restarts from the current live bytes, so it measures the
+  // high-water mark of this scope, the outer value is restored on exit
+  S21Allocator::ThreadStats().peakBytes = start_.liveBytes;
+}
+
+S21MemoryScope::~S21MemoryScope() {
+  S21MemoryStats delta = GetDelta();
+  S21MemoryStats& thread = S21Allocator::ThreadStats();
+
+  thread.peakBytes = std::max(thread.peakBytes, outerPeak_);
+  if (reporter_) reporter_(delta);
+}
+
+S21MemoryStats S21MemoryScope::GetDelta() const noexcept {
+  const S21MemoryStats& thread = S21Allocator::ThreadStats();
+
+  return {thread.liveBytes - start_.liveBytes,
+          thread.peakBytes - start_.liveBytes,
+          thread.allocations - start_.allocations,
+          thread.deallocations - start_.deallocations};
+}
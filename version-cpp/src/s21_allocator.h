@@ -0,0 +1,119 @@
+#ifndef SRC_S21_ALLOCATOR_H_
+#define SRC_S21_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+
+// every matrix buffer goes through S21Allocator: the allocation functions can
+// be replaced by user hooks, and live bytes, peak bytes and allocation counts
+// are kept per thread and for the whole process. with the
+// S21_MATRIX_MEMORY_REPORT=1 environment variable the process totals (and the
+// bytes still live, i.e. leaked) are printed to stderr at exit
+
+struct S21AllocatorHooks {
+  // returns nullptr on failure, S21Allocator::Allocate throws std::bad_alloc
+  void* (*allocate)(std::size_t bytes, void* context);
+  void (*deallocate)(void* pointer, std::size_t bytes, void* context);
+  void* context;
+};
+
+// placement of the large blocks (at least largeBytes) under the default
+// hooks, user hooks place their memory themselves. with huge pages or a NUMA
+// policy requested such blocks are mapped straight from the OS instead of
+// the heap. Linux only, elsewhere every block comes from the heap
+enum class S21HugePages {
+  kNone,
+  // madvise(MADV_HUGEPAGE), the kernel backs the block with transparent
+  // huge pages where it can
+  kTransparent,
+  // MAP_HUGETLB from the reserved huge page pool, kTransparent when the pool
+  // can't serve the block
+  kExplicit,
+};
+
+enum class S21NumaPlacement {
+  // the kernel default, each page on the node of the thread touching it
+  // first
+  kLocal,
+  // pages spread round-robin over the allowed nodes: even bandwidth for
+  // matrices all threads read
+  kInterleave,
+  // a new matrix is touched by the thread pool in the row blocks the
+  // parallel kernels split their work into, so its pages spread over the
+  // nodes of the workers
+  kFirstTouch,
+};
+
+struct S21Placement {
+  S21HugePages hugePages;
+  S21NumaPlacement numa;
+  std::size_t largeBytes;
+};
+
+struct S21MemoryStats {
+  // signed: a thread can release memory allocated by another one
+  std::int64_t liveBytes;
+  std::int64_t peakBytes;
+  std::uint64_t allocations;
+  std::uint64_t deallocations;
+};
+
+class S21Allocator {
+ public:
+  static void* Allocate(std::size_t bytes);
+  // zeroed memory: calloc with the default hooks (large blocks come as
+  // fresh pages the OS zeroes on first touch), memset after user hooks
+  static void* AllocateZeroed(std::size_t bytes);
+  static void Deallocate(void* pointer, std::size_t bytes) noexcept;
+
+  // not synchronized with running allocations: install the hooks before any
+  // matrix is created, memory is always released through the hooks that
+  // allocated it
+  static void SetHooks(const S21AllocatorHooks& hooks) noexcept;
+  static void ResetHooks() noexcept;
+
+  // may change at any time: a block is released the way it was allocated
+  // (mapped or from the heap), whatever the placement is by then
+  static void SetPlacement(const S21Placement& placement) noexcept;
+  static void ResetPlacement() noexcept;
+  static S21Placement GetPlacement() noexcept;
+  // whether a block of bytes is mapped under the placement
+  static bool IsPlaced(std::size_t bytes) noexcept;
+
+  static S21MemoryStats GetThreadStats() noexcept;
+  static S21MemoryStats GetProcessStats() noexcept;
+  static void ResetThreadStats() noexcept;
+  static void PrintReport(std::FILE* stream) noexcept;
+
+ private:
+  friend class S21MemoryScope;
+
+  static S21MemoryStats& ThreadStats() noexcept;
+  static void CountAllocation(std::size_t bytes) noexcept;
+};
+
+// RAII scope measuring the memory activity of the current thread: the delta
+// holds the bytes still live, the peak above the starting point and the
+// allocation counts since the scope began. the optional reporter gets the
+// final delta when the scope ends
+class S21MemoryScope {
+ public:
+  using Reporter = std::function<void(const S21MemoryStats&)>;
+
+  S21MemoryScope() noexcept;
+  explicit S21MemoryScope(Reporter reporter) noexcept;
+  S21MemoryScope(const S21MemoryScope& other) = delete;
+  S21MemoryScope& operator=(const S21MemoryScope& other) = delete;
+  ~S21MemoryScope();
+
+  S21MemoryStats GetDelta() const noexcept;
+
+ private:
+  S21MemoryStats start_;
+  std::int64_t outerPeak_;
+  Reporter reporter_;
+};
+
+#endif  // SRC_S21_ALLOCATOR_H_
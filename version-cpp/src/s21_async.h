@@ -0,0 +1,229 @@
+#ifndef SRC_S21_ASYNC_H_
+#define SRC_S21_ASYNC_H_
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "s21_parallel.h"
+
+// futures of operations running on the shared thread pool. unlike
+// std::future they chain: Then schedules a continuation once the result is
+// there, without a thread blocking on it, so load -> compute -> save stages
+// pipeline. an exception skips the continuations and reaches Get. without
+// pool workers (a single hardware thread) the tasks run inline in the caller.
+// a pool worker waiting for a future runs pending tasks meanwhile, so tasks
+// can Get each other's futures
+
+template <class T>
+class S21Future;
+
+namespace s21_async_detail {
+
+struct Empty {};
+
+// the result of a task, shared by the task and its future
+template <class T>
+class State {
+ public:
+  using Value = std::conditional_t<std::is_void_v<T>, Empty, T>;
+
+  template <class... Args>
+  void SetValue(Args&&... args) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      value_.emplace(std::forward<Args>(args)...);
+    }
+    Finish();
+  }
+
+  void SetException(std::exception_ptr error) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      error_ = error;
+    }
+    Finish();
+  }
+
+  bool IsReady() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ready_;
+  }
+
+  void Wait() {
+    S21ThreadPool& pool = S21ThreadPool::GetInstance();
+
+    if (pool.IsWorkerThread()) {
+      pool.WaitUntil([this]() { return IsReady(); });
+    } else {
+      std::unique_lock<std::mutex> lock(mutex_);
+      readyCondition_.wait(lock, [this]() { return ready_; });
+    }
+  }
+
+  // waits, rethrows the exception of the task or moves the value out
+  Value Take() {
+    Wait();
+    if (error_) std::rethrow_exception(error_);
+    return std::move(*value_);
+  }
+
+  // runs continuation right away when the result is there already, else in
+  // the thread finishing the task
+  void OnReady(std::function<void()> continuation) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (ready_) {
+      lock.unlock();
+      continuation();
+    } else {
+      continuations_.push_back(std::move(continuation));
+    }
+  }
+
+  std::exception_ptr GetException() const noexcept { return error_; }
+
+ private:
+  void Finish() {
+    std::vector<std::function<void()>> continuations;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ready_ = true;
+      continuations.swap(continuations_);
+    }
+    readyCondition_.notify_all();
+    for (std::function<void()>& continuation : continuations) continuation();
+  }
+
+  std::mutex mutex_;
+  std::condition_variable readyCondition_;
+  bool ready_ = false;
+  std::optional<Value> value_;
+  std::exception_ptr error_;
+  std::vector<std::function<void()>> continuations_;
+};
+
+// function(args...) into state, its exception as well
+template <class T, class Function, class... Args>
+void Fulfil(State<T>& state, Function& function, Args&&... args) {
+  try {
+    if constexpr (std::is_void_v<T>) {
+      function(std::forward<Args>(args)...);
+      state.SetValue();
+    } else {
+      state.SetValue(function(std::forward<Args>(args)...));
+    }
+  } catch (...) {
+    state.SetException(std::current_exception());
+  }
+}
+
+inline void Schedule(std::function<void()> task) {
+  S21ThreadPool& pool = S21ThreadPool::GetInstance();
+
+  if (pool.GetThreadsCount() > 1) {
+    pool.Submit(std::move(task));
+  } else {
+    task();
+  }
+}
+
+template <class T>
+S21Future<T> MakeFuture(std::shared_ptr<State<T>> state) {
+  return S21Future<T>(std::move(state));
+}
+
+}  // namespace s21_async_detail
+
+// move-only, Get and Then consume the future like std::future::get does
+template <class T>
+class S21Future {
+ public:
+  S21Future() noexcept = default;
+  S21Future(const S21Future& other) = delete;
+  S21Future(S21Future&& other) noexcept = default;
+  S21Future& operator=(const S21Future& other) = delete;
+  S21Future& operator=(S21Future&& other) noexcept = default;
+
+  bool IsValid() const noexcept { return state_ != nullptr; }
+  bool IsReady() const { return CheckedState().IsReady(); }
+  void Wait() const { CheckedState().Wait(); }
+
+  // blocks until the task is done, rethrows its exception
+  T Get() {
+    std::shared_ptr<s21_async_detail::State<T>> state = TakeState();
+    if constexpr (std::is_void_v<T>) {
+      state->Take();
+    } else {
+      return state->Take();
+    }
+  }
+
+  // a future of function(value), or function() for a void future, run on
+  // the pool once this one is ready. an exception of this future passes
+  // through without calling function
+  template <class Function>
+  auto Then(Function function) {
+    using Result = std::conditional_t<std::is_void_v<T>,
+                                      std::invoke_result<Function&>,
+                                      std::invoke_result<Function&, T>>;
+    using U = typename Result::type;
+
+    std::shared_ptr<s21_async_detail::State<T>> state = TakeState();
+    auto next = std::make_shared<s21_async_detail::State<U>>();
+    auto task = [state, next, function = std::move(function)]() mutable {
+      if (state->GetException()) {
+        next->SetException(state->GetException());
+      } else if constexpr (std::is_void_v<T>) {
+        s21_async_detail::Fulfil(*next, function);
+      } else {
+        s21_async_detail::Fulfil(*next, function, state->Take());
+      }
+    };
+    state->OnReady([task = std::move(task)]() mutable {
+      s21_async_detail::Schedule(std::move(task));
+    });
+    return s21_async_detail::MakeFuture(std::move(next));
+  }
+
+ private:
+  template <class U>
+  friend S21Future<U> s21_async_detail::MakeFuture(
+      std::shared_ptr<s21_async_detail::State<U>> state);
+
+  explicit S21Future(std::shared_ptr<s21_async_detail::State<T>> state)
+      : state_(std::move(state)) {}
+
+  s21_async_detail::State<T>& CheckedState() const {
+    if (state_ == nullptr)
+      throw std::invalid_argument("S21Future: invalid future exception");
+    return *state_;
+  }
+
+  std::shared_ptr<s21_async_detail::State<T>> TakeState() {
+    CheckedState();
+    return std::move(state_);
+  }
+
+  std::shared_ptr<s21_async_detail::State<T>> state_;
+};
+
+// a future of function(), run on the shared thread pool
+template <class Function>
+auto S21Async(Function function) {
+  using T = std::invoke_result_t<Function&>;
+
+  auto state = std::make_shared<s21_async_detail::State<T>>();
+  s21_async_detail::Schedule([state, function = std::move(function)]() mutable {
+    s21_async_detail::Fulfil(*state, function);
+  });
+  return s21_async_detail::MakeFuture(std::move(state));
+}
+
+#endif  // SRC_S21_ASYNC_H_
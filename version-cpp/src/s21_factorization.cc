@@ -0,0 +1,639 @@
+#include "s21_factorization.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "s21_matrix_stats.h"
+#include "s21_parallel.h"
+
+namespace {
+
+// eliminations and updates from kParallelSize elements are split over the
+// thread pool in blocks of kRowsBlock rows
+constexpr double kParallelSize = 1 << 16;
+constexpr int kRowsBlock = 16;
+
+// partial pivoting keeps the elements of L within 1, the updates don't
+// pivot. the rounding errors grow with L, an update that lets it grow past
+// kMaxGrowth factorizes the matrix again instead. with 1e4 a few percent of
+// random row and column replacements do, and the inverse stays within about
+// 1e-10 of a new factorization
+constexpr double kMaxGrowth = 1e4;
+
+// body(begin, end) over the rows [begin, end), in blocks on the pool when
+// parallel holds
+void ForRows(int begin, int end, bool parallel,
+             const std::function<void(int, int)>& body) {
+  if (!parallel || end - begin <= kRowsBlock) {
+    body(begin, end);
+    return;
+  }
+  std::size_t blocks =
+      static_cast<std::size_t>((end - begin + kRowsBlock - 1) / kRowsBlock);
+  S21ThreadPool::GetInstance().ParallelFor(blocks, [&](std::size_t block) {
+    int first = begin + static_cast<int>(block) * kRowsBlock;
+    body(first, std::min(end, first + kRowsBlock));
+  });
+}
+
+bool IsParallel(int rows, int cols) {
+  return static_cast<double>(rows) * cols >= kParallelSize;
+}
+
+double FactorizationFlops(int size) { return 2.0 * size * size * size / 3; }
+
+// the inverse column by column, solve(column) solves in place
+S21Matrix InverseByColumns(int size,
+                           const std::function<void(double*)>& solve) {
+  S21Matrix result(size, size, S21Matrix::uninit);
+  double* const* matrix = result.GetMatrix();
+
+  ForRows(0, size, IsParallel(size, size), [&](int begin, int end) {
+    std::vector<double> column(size);
+    for (int j = begin; j < end; j++) {
+      std::fill(column.begin(), column.end(), 0.0);
+      column[j] = 1.0;
+      solve(column.data());
+      for (int i = 0; i < size; i++) matrix[i][j] = column[i];
+    }
+  });
+  return result;
+}
+
+void CheckSquare(const S21Matrix& matrix, const char* method) {
+  if (matrix.IsNullOrEmpty())
+    throw std::invalid_argument(std::string(method) +
+                                ": null matrix exception");
+
+  if (!matrix.IsSquare())
+    throw std::invalid_argument(std::string(method) +
+                                ": matrix is not square exception");
+}
+
+void CheckSize(const S21Vector& vector, int size, const char* method) {
+  if (vector.GetSize() != size)
+    throw std::invalid_argument(std::string(method) +
+                                ": different vector dimensions exception");
+}
+
+void CheckIndex(int index, int size, const char* method) {
+  if (index < 0 || index >= size)
+    throw std::out_of_range(std::string(method) +
+                            ": index out of range exception");
+}
+
+}  // namespace
+
+// S21LU
+
+S21LU::S21LU(const S21Matrix& matrix) : refactors_(0) {
+  S21OperationTimer timer(S21Operation::kFactorize);
+  CheckSquare(matrix, "S21LU::S21LU");
+
+  size_ = matrix.GetRowsCount();
+  matrix_ = matrix;
+  lower_.SetRowsCount(size_);
+  lower_.SetColsCount(size_);
+  upper_.SetRowsCount(size_);
+  upper_.SetColsCount(size_);
+  if (!Factorize())
+    throw std::invalid_argument("S21LU::S21LU: singular matrix exception");
+  timer.AddFlops(FactorizationFlops(size_));
+}
+
+// right-looking elimination of a copy of the matrix. the rows are swapped
+// as pointers, the factors are written out only on success
+bool S21LU::Factorize() {
+  S21Matrix work(matrix_);
+  std::vector<double*> rows(work.GetMatrix(), work.GetMatrix() + size_);
+  std::vector<int> pivots(size_);
+  std::iota(pivots.begin(), pivots.end(), 0);
+  int sign = 1;
+
+  for (int k = 0; k < size_; k++) {
+    int pivot = k;
+    for (int i = k + 1; i < size_; i++) {
+      if (fabs(rows[i][k]) > fabs(rows[pivot][k])) pivot = i;
+    }
+    if (!(fabs(rows[pivot][k]) > EPS)) return false;
+    if (pivot != k) {
+      std::swap(rows[k], rows[pivot]);
+      std::swap(pivots[k], pivots[pivot]);
+      sign = -sign;
+    }
+
+    const double* pivotRow = rows[k];
+    int remaining = size_ - k - 1;
+    ForRows(k + 1, size_, IsParallel(remaining, remaining),
+            [&](int begin, int end) {
+      for (int i = begin; i < end; i++) {
+        double* row = rows[i];
+        double factor = row[k] / pivotRow[k];
+
+        row[k] = factor;
+        for (int j = k + 1; j < size_; j++) row[j] -= factor * pivotRow[j];
+      }
+    });
+  }
+
+  double* const* lower = lower_.GetMatrix();
+  double* const* upper = upper_.GetMatrix();
+  for (int k = 0; k < size_; k++) {
+    std::copy(rows[k] + k, rows[k] + size_, upper[k] + k);
+    for (int i = k + 1; i < size_; i++) lower[k][i] = rows[i][k];
+  }
+  pivots_ = pivots;
+  sign_ = sign;
+  return true;
+}
+
+// Bennett's algorithm: L * U + x * y^T, one row of U and one column of L at
+// a time. false when a pivot vanishes or L grows past kMaxGrowth, the factors
+// are then partly updated
+bool S21LU::UpdateFactors(double* x, double* y) {
+  double* const* lower = lower_.GetMatrix();
+  double* const* upper = upper_.GetMatrix();
+  double growth = 0.0;
+
+  for (int k = 0; k < size_; k++) {
+    double xk = x[k];
+    double yk = y[k];
+    if (xk == 0.0 && yk == 0.0) continue;
+
+    double* l = lower[k];
+    double* u = upper[k];
+    double pivot = u[k] + xk * yk;
+    if (!(fabs(pivot) > EPS)) return false;
+    u[k] = pivot;
+
+    double beta = yk / pivot;
+    for (int i = k + 1; i < size_; i++) {
+      x[i] -= xk * l[i];
+      l[i] += beta * x[i];
+      growth = std::max(growth, fabs(l[i]));
+    }
+    for (int j = k + 1; j < size_; j++) {
+      u[j] += xk * y[j];
+      y[j] -= beta * u[j];
+    }
+  }
+  return growth <= kMaxGrowth;
+}
+
+// x is P * alpha * u and y is v of the change, change(matrix) applies it to
+// a matrix
+void S21LU::Apply(std::vector<double>* x, std::vector<double>* y,
+                  const std::function<void(S21Matrix*)>& change,
+                  const char* method) {
+  S21OperationTimer timer(S21Operation::kUpdate);
+
+  if (UpdateFactors(x->data(), y->data())) {
+    change(&matrix_);
+    timer.AddFlops(4.0 * size_ * size_);
+    return;
+  }
+
+  S21Matrix previous(matrix_);
+  change(&matrix_);
+  if (!Factorize()) {
+    matrix_ = previous;
+    Factorize();
+    throw std::invalid_argument(std::string(method) +
+                                ": singular matrix exception");
+  }
+  refactors_++;
+  timer.AddFlops(FactorizationFlops(size_));
+}
+
+void S21LU::Update(double alpha, const S21Vector& u, const S21Vector& v) {
+  CheckSize(u, size_, "S21LU::Update");
+  CheckSize(v, size_, "S21LU::Update");
+
+  std::vector<double> x(size_);
+  std::vector<double> y(v.GetData(), v.GetData() + size_);
+  for (int i = 0; i < size_; i++) x[i] = alpha * u(pivots_[i]);
+
+  Apply(&x, &y, [&](S21Matrix* matrix) {
+    for (int i = 0; i < size_; i++) {
+      double factor = alpha * u(i);
+      double* row = matrix->RowPtr(i);
+      if (factor != 0.0) {
+        for (int j = 0; j < size_; j++) row[j] += factor * v(j);
+      }
+    }
+  }, "S21LU::Update");
+}
+
+void S21LU::SetElementAtIndex(int indexRows, int indexCols, double value) {
+  CheckIndex(indexRows, size_, "S21LU::SetElementAtIndex");
+  CheckIndex(indexCols, size_, "S21LU::SetElementAtIndex");
+
+  double delta = value - matrix_(indexRows, indexCols);
+  if (delta == 0.0) return;
+
+  std::vector<double> x(size_, 0.0);
+  std::vector<double> y(size_, 0.0);
+  int position = static_cast<int>(
+      std::find(pivots_.begin(), pivots_.end(), indexRows) - pivots_.begin());
+  x[position] = delta;
+  y[indexCols] = 1.0;
+
+  Apply(&x, &y, [&](S21Matrix* matrix) {
+    matrix->At(indexRows, indexCols) = value;
+  }, "S21LU::SetElementAtIndex");
+}
+
+void S21LU::SetRow(int indexRows, const S21Vector& values) {
+  CheckIndex(indexRows, size_, "S21LU::SetRow");
+  CheckSize(values, size_, "S21LU::SetRow");
+
+  std::vector<double> x(size_, 0.0);
+  std::vector<double> y(size_);
+  int position = static_cast<int>(
+      std::find(pivots_.begin(), pivots_.end(), indexRows) - pivots_.begin());
+  x[position] = 1.0;
+  for (int j = 0; j < size_; j++) y[j] = values(j) - matrix_(indexRows, j);
+
+  Apply(&x, &y, [&](S21Matrix* matrix) { matrix->SetRow(indexRows, values); },
+        "S21LU::SetRow");
+}
+
+void S21LU::SetCol(int indexCols, const S21Vector& values) {
+  CheckIndex(indexCols, size_, "S21LU::SetCol");
+  CheckSize(values, size_, "S21LU::SetCol");
+
+  std::vector<double> x(size_);
+  std::vector<double> y(size_, 0.0);
+  for (int i = 0; i < size_; i++) {
+    x[i] = values(pivots_[i]) - matrix_(pivots_[i], indexCols);
+  }
+  y[indexCols] = 1.0;
+
+  Apply(&x, &y, [&](S21Matrix* matrix) { matrix->SetCol(indexCols, values); },
+        "S21LU::SetCol");
+}
+
+// b is P * b on the way in, L * U * x = P * b is solved in place: the
+// columns of L forward, the rows of U backward
+void S21LU::SolveInPlace(double* b) const {
+  double* const* lower = lower_.GetMatrix();
+  double* const* upper = upper_.GetMatrix();
+
+  for (int k = 0; k < size_; k++) {
+    const double* l = lower[k];
+    double value = b[k];
+    for (int i = k + 1; i < size_; i++) b[i] -= l[i] * value;
+  }
+  for (int k = size_ - 1; k >= 0; k--) {
+    const double* u = upper[k];
+    double value = b[k];
+    for (int j = k + 1; j < size_; j++) value -= u[j] * b[j];
+    b[k] = value / u[k];
+  }
+}
+
+S21Vector S21LU::Solve(const S21Vector& b) const {
+  CheckSize(b, size_, "S21LU::Solve");
+
+  S21Vector result(size_);
+  for (int i = 0; i < size_; i++) result(i) = b(pivots_[i]);
+  SolveInPlace(result.GetData());
+  return result;
+}
+
+S21Matrix S21LU::InverseMatrix() const {
+  S21OperationTimer timer(S21Operation::kInverseMatrix);
+
+  S21Matrix result = InverseByColumns(size_, [this](double* column) {
+    std::vector<double> permuted(size_);
+    for (int i = 0; i < size_; i++) permuted[i] = column[pivots_[i]];
+    SolveInPlace(permuted.data());
+    std::copy(permuted.begin(), permuted.end(), column);
+  });
+  timer.AddFlops(2.0 * size_ * size_ * size_);
+  return result;
+}
+
+double S21LU::Determinant() const noexcept {
+  double result = sign_;
+  for (int k = 0; k < size_; k++) result *= upper_.At(k, k);
+  return result;
+}
+
+int S21LU::GetSize() const noexcept { return size_; }
+
+const S21Matrix& S21LU::GetMatrix() const noexcept { return matrix_; }
+
+S21Matrix S21LU::GetL() const {
+  S21Matrix result = lower_.Transpose();
+  for (int k = 0; k < size_; k++) result.At(k, k) = 1.0;
+  return result;
+}
+
+S21Matrix S21LU::GetU() const { return upper_; }
+
+const std::vector<int>& S21LU::GetPivots() const noexcept { return pivots_; }
+
+int S21LU::GetRefactorsCount() const noexcept { return refactors_; }
+
+// S21Cholesky
+
+S21Cholesky::S21Cholesky(const S21Matrix& matrix) {
+  S21OperationTimer timer(S21Operation::kFactorize);
+  CheckSquare(matrix, "S21Cholesky::S21Cholesky");
+
+  size_ = matrix.GetRowsCount();
+  for (int i = 0; i < size_; i++) {
+    for (int j = i + 1; j < size_; j++) {
+      if (!(fabs(matrix.At(i, j) - matrix.At(j, i)) <= EPS))
+        throw std::invalid_argument(
+            "S21Cholesky::S21Cholesky: matrix is not symmetric exception");
+    }
+  }
+
+  matrix_ = matrix;
+  upper_.SetRowsCount(size_);
+  upper_.SetColsCount(size_);
+  if (!Factorize(matrix_))
+    throw std::invalid_argument(
+        "S21Cholesky::S21Cholesky: matrix is not positive definite exception");
+  timer.AddFlops(FactorizationFlops(size_) / 2);
+}
+
+// right-looking on the upper triangle of a copy, row k of the copy becomes
+// row k of L^T. the factor is written out only on success
+bool S21Cholesky::Factorize(const S21Matrix& matrix) {
+  S21Matrix work(matrix);
+  double* const* rows = work.GetMatrix();
+
+  for (int k = 0; k < size_; k++) {
+    double* pivotRow = rows[k];
+    if (!(pivotRow[k] > 0.0)) return false;
+
+    double pivot = sqrt(pivotRow[k]);
+    for (int j = k; j < size_; j++) pivotRow[j] /= pivot;
+
+    int remaining = size_ - k - 1;
+    ForRows(k + 1, size_, IsParallel(remaining, remaining / 2),
+            [&](int begin, int end) {
+      for (int i = begin; i < end; i++) {
+        double* row = rows[i];
+        double factor = pivotRow[i];
+        for (int j = i; j < size_; j++) row[j] -= factor * pivotRow[j];
+      }
+    });
+  }
+
+  double* const* upper = upper_.GetMatrix();
+  for (int k = 0; k < size_; k++) {
+    std::copy(rows[k] + k, rows[k] + size_, upper[k] + k);
+  }
+  return true;
+}
+
+// L * L^T + x * x^T by Givens rotations, a row of L^T at a time
+void S21Cholesky::UpdateFactor(double* x) {
+  double* const* upper = upper_.GetMatrix();
+
+  for (int k = 0; k < size_; k++) {
+    double xk = x[k];
+    if (xk == 0.0) continue;
+
+    double* u = upper[k];
+    double radius = sqrt(u[k] * u[k] + xk * xk);
+    double c = radius / u[k];
+    double s = xk / u[k];
+    u[k] = radius;
+    for (int j = k + 1; j < size_; j++) {
+      u[j] = (u[j] + s * x[j]) / c;
+      x[j] = c * x[j] - s * u[j];
+    }
+  }
+}
+
+// L * L^T - x * x^T by hyperbolic rotations. the result is positive
+// definite when L * p = x has |p| < 1, which is checked first; false leaves
+// the factor unchanged, unless rounding stops it halfway
+bool S21Cholesky::DowndateFactor(double* x) {
+  double* const* upper = upper_.GetMatrix();
+  std::vector<double> p(x, x + size_);
+  double norm = 0.0;
+
+  for (int k = 0; k < size_; k++) {
+    const double* u = upper[k];
+    double value = p[k] / u[k];
+    p[k] = value;
+    norm += value * value;
+    for (int j = k + 1; j < size_; j++) p[j] -= u[j] * value;
+  }
+  if (!(norm < 1.0)) return false;
+
+  for (int k = 0; k < size_; k++) {
+    double xk = x[k];
+    if (xk == 0.0) continue;
+
+    double* u = upper[k];
+    double squared = (u[k] - xk) * (u[k] + xk);
+    if (!(squared > 0.0)) return false;
+
+    double radius = sqrt(squared);
+    double c = radius / u[k];
+    double s = xk / u[k];
+    u[k] = radius;
+    for (int j = k + 1; j < size_; j++) {
+      u[j] = (u[j] - s * x[j]) / c;
+      x[j] = c * x[j] - s * u[j];
+    }
+  }
+  return true;
+}
+
+void S21Cholesky::Update(const S21Vector& x) {
+  S21OperationTimer timer(S21Operation::kUpdate);
+  CheckSize(x, size_, "S21Cholesky::Update");
+
+  std::vector<double> work(x.GetData(), x.GetData() + size_);
+  UpdateFactor(work.data());
+  for (int i = 0; i < size_; i++) {
+    double* row = matrix_.RowPtr(i);
+    for (int j = 0; j < size_; j++) row[j] += x(i) * x(j);
+  }
+  timer.AddFlops(4.0 * size_ * size_);
+}
+
+void S21Cholesky::Downdate(const S21Vector& x) {
+  S21OperationTimer timer(S21Operation::kUpdate);
+  CheckSize(x, size_, "S21Cholesky::Downdate");
+
+  std::vector<double> work(x.GetData(), x.GetData() + size_);
+  if (!DowndateFactor(work.data())) {
+    Factorize(matrix_);
+    throw std::invalid_argument(
+        "S21Cholesky::Downdate: matrix is not positive definite exception");
+  }
+  for (int i = 0; i < size_; i++) {
+    double* row = matrix_.RowPtr(i);
+    for (int j = 0; j < size_; j++) row[j] -= x(i) * x(j);
+  }
+  timer.AddFlops(5.0 * size_ * size_);
+}
+
+// delta * (e_i * e_j^T + e_j * e_i^T) is a * a^T - b * b^T with
+// a = sqrt(|delta| / 2) * (e_i + e_j) and b = sqrt(|delta| / 2) * (e_i - e_j)
+// (swapped for a negative delta), a single update or downdate on the
+// diagonal. the update goes first, so the downdate starts from a positive
+// definite matrix
+void S21Cholesky::SetElementAtIndex(int indexRows, int indexCols,
+                                    double value) {
+  S21OperationTimer timer(S21Operation::kUpdate);
+  CheckIndex(indexRows, size_, "S21Cholesky::SetElementAtIndex");
+  CheckIndex(indexCols, size_, "S21Cholesky::SetElementAtIndex");
+
+  double delta = value - matrix_(indexRows, indexCols);
+  if (delta == 0.0) return;
+
+  std::vector<double> a(size_, 0.0);
+  std::vector<double> b(size_, 0.0);
+  if (indexRows == indexCols) {
+    (delta > 0.0 ? a : b)[indexRows] = sqrt(fabs(delta));
+  } else {
+    double scale = sqrt(fabs(delta) / 2);
+    double sign = delta > 0.0 ? 1.0 : -1.0;
+    a[indexRows] = scale;
+    a[indexCols] = sign * scale;
+    b[indexRows] = scale;
+    b[indexCols] = -sign * scale;
+  }
+
+  if (indexRows != indexCols || delta > 0.0) UpdateFactor(a.data());
+  if ((indexRows != indexCols || delta < 0.0) && !DowndateFactor(b.data())) {
+    Factorize(matrix_);
+    throw std::invalid_argument(
+        "S21Cholesky::SetElementAtIndex: matrix is not positive definite "
+        "exception");
+  }
+  matrix_(indexRows, indexCols) = value;
+  matrix_(indexCols, indexRows) = value;
+  timer.AddFlops(9.0 * size_ * size_);
+}
+
+// L * y = b forward by the columns of L (the rows of L^T), L^T * x = y
+// backward by the rows of L^T
+void S21Cholesky::SolveInPlace(double* b) const {
+  double* const* upper = upper_.GetMatrix();
+
+  for (int k = 0; k < size_; k++) {
+    const double* u = upper[k];
+    double value = b[k] / u[k];
+    b[k] = value;
+    for (int j = k + 1; j < size_; j++) b[j] -= u[j] * value;
+  }
+  for (int k = size_ - 1; k >= 0; k--) {
+    const double* u = upper[k];
+    double value = b[k];
+    for (int j = k + 1; j < size_; j++) value -= u[j] * b[j];
+    b[k] = value / u[k];
+  }
+}
+
+S21Vector S21Cholesky::Solve(const S21Vector& b) const {
+  CheckSize(b, size_, "S21Cholesky::Solve");
+
+  S21Vector result(b);
+  SolveInPlace(result.GetData());
+  return result;
+}
+
+S21Matrix S21Cholesky::InverseMatrix() const {
+  S21OperationTimer timer(S21Operation::kInverseMatrix);
+
+  S21Matrix result = InverseByColumns(
+      size_, [this](double* column) { SolveInPlace(column); });
+  timer.AddFlops(2.0 * size_ * size_ * size_);
+  return result;
+}
+
+double S21Cholesky::Determinant() const noexcept {
+  double result = 1.0;
+  for (int k = 0; k < size_; k++) result *= upper_.At(k, k) * upper_.At(k, k);
+  return result;
+}
+
+int S21Cholesky::GetSize() const noexcept { return size_; }
+
+const S21Matrix& S21Cholesky::GetMatrix() const noexcept { return matrix_; }
+
+S21Matrix S21Cholesky::GetL() const { return upper_.Transpose(); }
+
+// S21Matrix
+
+// B = A^-1 becomes (A + u * v^T)^-1 = B - (B * u) * (v^T * B) / (1 + v^T *
+// B * u), two matrix-vector products and a rank-1 update of B
+void S21Matrix::UpdateInverse(const S21Vector& u, const S21Vector& v) {
+  S21OperationTimer timer(S21Operation::kUpdate);
+  CheckSquare(*this, "S21Matrix::UpdateInverse");
+  CheckSize(u, rows_, "S21Matrix::UpdateInverse");
+  CheckSize(v, rows_, "S21Matrix::UpdateInverse");
+
+  S21Vector bu(rows_);
+  S21Vector vb(rows_);
+  bu.Gemv(1.0, *this, false, u, 0.0);
+  vb.Gemv(1.0, *this, true, v, 0.0);
+
+  double denominator = 1.0 + v.Dot(bu);
+  if (!(fabs(denominator) > EPS))
+    throw std::invalid_argument(
+        "S21Matrix::UpdateInverse: singular matrix exception");
+
+  PrepareWrite();
+  const double* column = bu.GetData();
+  const double* row = vb.GetData();
+  ForRows(0, rows_, IsParallel(rows_, cols_), [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      double factor = column[i] / denominator;
+      double* target = matrix_[i];
+      for (int j = 0; j < cols_; j++) target[j] -= factor * row[j];
+    }
+  });
+  timer.AddFlops(6.0 * rows_ * cols_);
+}
+
+// Woodbury: (A + U * V^T)^-1 = B - (B * U) * C^-1 * (V^T * B) with the
+// k x k capacitance C = I + V^T * B * U, O(n^2 * k)
+void S21Matrix::UpdateInverse(const S21Matrix& u, const S21Matrix& v) {
+  S21OperationTimer timer(S21Operation::kUpdate);
+  CheckSquare(*this, "S21Matrix::UpdateInverse");
+
+  if (u.IsNullOrEmpty() || v.IsNullOrEmpty())
+    throw std::invalid_argument(
+        "S21Matrix::UpdateInverse: null matrix exception");
+
+  int rank = u.cols_;
+  if (u.rows_ != rows_ || v.rows_ != rows_ || v.cols_ != rank)
+    throw std::invalid_argument(
+        "S21Matrix::UpdateInverse: different matrix dimensions exception");
+
+  S21Matrix bu = Product(u);
+  S21Matrix vb(rank, cols_, uninit);
+  vb.Gemm(1.0, v, true, *this, false, 0.0);
+
+  S21Matrix capacitance(rank, rank);
+  for (int k = 0; k < rank; k++) capacitance.matrix_[k][k] = 1.0;
+  capacitance.Gemm(1.0, v, true, bu, false, 1.0);
+
+  S21Matrix correction;
+  try {
+    correction = S21LU(capacitance).InverseMatrix().Product(vb);
+  } catch (const std::invalid_argument&) {
+    throw std::invalid_argument(
+        "S21Matrix::UpdateInverse: singular matrix exception");
+  }
+  Gemm(-1.0, bu, false, correction, false, 1.0);
+  timer.AddFlops(6.0 * rows_ * cols_ * rank);
+}
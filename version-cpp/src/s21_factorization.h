@@ -0,0 +1,94 @@
+#ifndef SRC_S21_FACTORIZATION_H_
+#define SRC_S21_FACTORIZATION_H_
+
+#include <functional>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+#include "s21_vector.h"
+
+// factorizations that are kept up to date as their matrix changes. both
+// hold a copy of the matrix next to the factors: a rank-1 change,
+// A + alpha * u * v^T, is applied to the factors in O(n^2) instead of the
+// O(n^3) of factorizing again, and the held matrix is refactorized only
+// when an update would lose accuracy. a failed update keeps the matrix as
+// it was, and factors of it. setting one element, row or column is a rank-1
+// change
+
+// P * A = L * U with partial pivoting (row interchanges)
+class S21LU {
+ public:
+  explicit S21LU(const S21Matrix& matrix);
+
+  // A + alpha * u * v^T, a negative alpha downdates
+  void Update(double alpha, const S21Vector& u, const S21Vector& v);
+  void SetElementAtIndex(int indexRows, int indexCols, double value);
+  void SetRow(int indexRows, const S21Vector& values);
+  void SetCol(int indexCols, const S21Vector& values);
+
+  S21Vector Solve(const S21Vector& b) const;
+  S21Matrix InverseMatrix() const;
+  double Determinant() const noexcept;
+
+  int GetSize() const noexcept;
+  const S21Matrix& GetMatrix() const noexcept;
+  // unit lower triangular L, upper triangular U, row i of P * A is row
+  // GetPivots()[i] of A
+  S21Matrix GetL() const;
+  S21Matrix GetU() const;
+  const std::vector<int>& GetPivots() const noexcept;
+  // how many updates fell back to factorizing again
+  int GetRefactorsCount() const noexcept;
+
+ private:
+  bool Factorize();
+  bool UpdateFactors(double* x, double* y);
+  void Apply(std::vector<double>* x, std::vector<double>* y,
+             const std::function<void(S21Matrix*)>& change,
+             const char* method);
+  void SolveInPlace(double* b) const;
+
+  int size_;
+  S21Matrix matrix_;
+  // L is kept transposed (its diagonal of ones implied) and U as it is, so
+  // the columns of L and the rows of U an update walks are contiguous
+  S21Matrix lower_;
+  S21Matrix upper_;
+  std::vector<int> pivots_;
+  int sign_;
+  int refactors_;
+};
+
+// A = L * L^T of a symmetric positive definite matrix
+class S21Cholesky {
+ public:
+  explicit S21Cholesky(const S21Matrix& matrix);
+
+  // A + x * x^T
+  void Update(const S21Vector& x);
+  // A - x * x^T, throws when the result is not positive definite
+  void Downdate(const S21Vector& x);
+  // sets both (i, j) and (j, i), an update and a downdate
+  void SetElementAtIndex(int indexRows, int indexCols, double value);
+
+  S21Vector Solve(const S21Vector& b) const;
+  S21Matrix InverseMatrix() const;
+  double Determinant() const noexcept;
+
+  int GetSize() const noexcept;
+  const S21Matrix& GetMatrix() const noexcept;
+  S21Matrix GetL() const;
+
+ private:
+  bool Factorize(const S21Matrix& matrix);
+  void UpdateFactor(double* x);
+  bool DowndateFactor(double* x);
+  void SolveInPlace(double* b) const;
+
+  int size_;
+  S21Matrix matrix_;
+  // L^T, the rows of L^T are the columns an update walks
+  S21Matrix upper_;
+};
+
+#endif  // SRC_S21_FACTORIZATION_H_
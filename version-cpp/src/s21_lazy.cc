@@ -0,0 +1,781 @@
+#include "s21_lazy.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+#include "s21_matrix_product.h"
+#include "s21_matrix_stats.h"
+#include "s21_parallel.h"
+
+namespace {
+
+// fused kernels from kParallelSize elements are split over the thread pool
+// in blocks of kRowsBlock rows
+constexpr double kParallelSize = 1 << 16;
+constexpr int kRowsBlock = 16;
+
+void CheckNotNull(const S21LazyMatrix& matrix, const std::string& method) {
+  if (matrix.IsNull())
+    throw std::invalid_argument(method + ": null matrix exception");
+}
+
+void CheckEqualSize(const S21LazyMatrix& a, const S21LazyMatrix& b,
+                    const std::string& method) {
+  CheckNotNull(a, method);
+  CheckNotNull(b, method);
+  if (a.GetRowsCount() != b.GetRowsCount() ||
+      a.GetColsCount() != b.GetColsCount())
+    throw std::invalid_argument(method +
+                                ": different matrix dimensions exception");
+}
+
+}  // namespace
+
+// a node never changes once made, so the expressions can share it
+struct S21LazyMatrix::Node {
+  enum class Op {
+    kLeaf,
+    kSum,
+    kSub,
+    kMulNumber,
+    kMulMatrix,
+    kTranspose,
+    kProduct
+  };
+
+  Node(Op op, int rows, int cols, double num, std::shared_ptr<const Node> a,
+       std::shared_ptr<const Node> b)
+      : op(op),
+        rows(rows),
+        cols(cols),
+        num(num),
+        a(std::move(a)),
+        b(std::move(b)) {}
+  explicit Node(S21Matrix&& leaf)
+      : op(Op::kLeaf),
+        rows(leaf.GetRowsCount()),
+        cols(leaf.GetColsCount()),
+        num(0.0),
+        matrix(std::move(leaf)) {}
+
+  Op op;
+  int rows;
+  int cols;
+  double num;
+  std::shared_ptr<const Node> a;
+  std::shared_ptr<const Node> b;
+  S21Matrix matrix;
+};
+
+// one Evaluate call. the reachable nodes become entries in topological
+// order (the operands first), the rewrites work on the entries, then every
+// entry that needs a buffer becomes a step. a step runs once all its inputs
+// are computed: the steps of one level run in parallel, and a buffer is
+// released after the last level reading it
+class S21LazyPlan {
+ public:
+  explicit S21LazyPlan(const std::vector<S21LazyMatrix>& roots);
+
+  std::vector<S21Matrix> Run();
+  void Report(S21LazyReport* report) const noexcept;
+
+ private:
+  using Node = S21LazyMatrix::Node;
+  using Op = Node::Op;
+
+  // a row of a computed entry, a row of the transpose of one (gathered per
+  // block) or the result of an earlier instruction of the kernel
+  enum class Source { kNone, kRow, kTransposed, kTemp };
+
+  struct Operand {
+    Source source;
+    int index;
+  };
+
+  struct Instruction {
+    Op op;
+    double num;
+    Operand a;
+    Operand b;
+  };
+
+  struct Entry {
+    Op op;
+    int rows;
+    int cols;
+    double num = 0.0;
+    int a = -1;
+    int b = -1;
+    const S21Matrix* leaf = nullptr;
+    // a product is alpha * op(a) * op(b) + beta * c, c is optional
+    bool transA = false;
+    bool transB = false;
+    double alpha = 1.0;
+    int c = -1;
+    double beta = 0.0;
+    bool root = false;
+    int uses = 0;
+    int consumer = -1;
+    bool inlined = false;
+    int level = 0;
+    int lastLevel = 0;
+    int lastReaders = 0;
+    bool handedOver = false;
+    int slot = -1;
+  };
+
+  struct Step {
+    int entry;
+    int level;
+    std::vector<int> inputs;
+    // the fused kernel of an element-wise entry, the last instruction
+    // writes the result
+    std::vector<Instruction> code;
+    std::vector<int> transposed;
+  };
+
+  static bool IsElementWise(Op op) noexcept;
+  static void Apply(const Instruction& instruction, const double* a,
+                    const double* b, double* out, int cols) noexcept;
+
+  int Collect(const Node* root);
+  int Intern(const Node* node);
+  void FoldOperands();
+  void FoldOperand(int* index, bool* transposed, double* alpha);
+  void CountUses();
+  bool IsFoldable(int index) const noexcept;
+  void TakeOver(Entry* entry, Entry* product);
+  void FoldIntoProducts();
+  void MarkInlined();
+  void BuildSteps();
+  Operand Compile(int index, Step* step);
+  void AddInput(Step* step, int index) const;
+
+  bool CanHandOver(const Step& step, int index) const;
+  void Allocate(const Step& step);
+  void Release(int level);
+  const S21Matrix& Value(int index) const noexcept;
+  void Execute(const Step& step);
+  void RunProduct(const Entry& entry, S21Matrix* result) const;
+  void RunTranspose(const Entry& entry, S21Matrix* result) const;
+  void RunKernel(const Step& step, S21Matrix* result) const;
+
+  std::vector<Entry> entries_;
+  std::vector<int> roots_;
+  std::vector<Step> steps_;
+  std::vector<S21Matrix> values_;
+  std::vector<int> released_;
+  std::unordered_map<const Node*, int> indices_;
+  std::map<std::tuple<int, int, int, std::uint64_t>, int> keys_;
+  S21LazyReport report_ = {0, 0, 0, 0, 0, 0};
+};
+
+// constructors
+
+S21LazyMatrix::S21LazyMatrix(const S21Matrix& matrix)
+    : S21LazyMatrix(S21Matrix(matrix)) {}
+
+S21LazyMatrix::S21LazyMatrix(S21Matrix&& matrix) {
+  if (matrix.IsNullOrEmpty())
+    throw std::invalid_argument(
+        "S21LazyMatrix::S21LazyMatrix: null matrix exception");
+
+  node_ = std::make_shared<const Node>(std::move(matrix));
+}
+
+S21LazyMatrix::S21LazyMatrix(std::shared_ptr<const Node> node) noexcept
+    : node_(std::move(node)) {}
+
+S21LazyPlan::S21LazyPlan(const std::vector<S21LazyMatrix>& roots) {
+  for (const S21LazyMatrix& root : roots) {
+    CheckNotNull(root, "S21LazyMatrix::Evaluate");
+    roots_.push_back(Collect(root.node_.get()));
+  }
+
+  FoldOperands();
+  CountUses();
+  FoldIntoProducts();
+  CountUses();
+  MarkInlined();
+  BuildSteps();
+}
+
+// operators
+
+S21LazyMatrix S21LazyMatrix::operator+(const S21LazyMatrix& other) const {
+  CheckEqualSize(*this, other, "S21LazyMatrix::operator+");
+  return S21LazyMatrix(std::make_shared<const Node>(
+      Node::Op::kSum, GetRowsCount(), GetColsCount(), 0.0, node_,
+      other.node_));
+}
+
+S21LazyMatrix S21LazyMatrix::operator-(const S21LazyMatrix& other) const {
+  CheckEqualSize(*this, other, "S21LazyMatrix::operator-");
+  return S21LazyMatrix(std::make_shared<const Node>(
+      Node::Op::kSub, GetRowsCount(), GetColsCount(), 0.0, node_,
+      other.node_));
+}
+
+S21LazyMatrix S21LazyMatrix::operator*(const S21LazyMatrix& other) const {
+  return MulMatrix(other);
+}
+
+S21LazyMatrix S21LazyMatrix::operator*(double num) const {
+  CheckNotNull(*this, "S21LazyMatrix::operator*");
+  return S21LazyMatrix(
+      std::make_shared<const Node>(Node::Op::kMulNumber, GetRowsCount(),
+                                   GetColsCount(), num, node_, nullptr));
+}
+
+S21LazyMatrix operator*(double num, const S21LazyMatrix& other) {
+  return other * num;
+}
+
+// public functions
+
+S21LazyMatrix S21LazyMatrix::MulMatrix(const S21LazyMatrix& other) const {
+  CheckEqualSize(*this, other, "S21LazyMatrix::MulMatrix");
+  return S21LazyMatrix(std::make_shared<const Node>(
+      Node::Op::kMulMatrix, GetRowsCount(), GetColsCount(), 0.0, node_,
+      other.node_));
+}
+
+S21LazyMatrix S21LazyMatrix::Product(const S21LazyMatrix& other) const {
+  CheckNotNull(*this, "S21LazyMatrix::Product");
+  CheckNotNull(other, "S21LazyMatrix::Product");
+  if (GetColsCount() != other.GetRowsCount())
+    throw std::invalid_argument(
+        "S21LazyMatrix::Product: different matrix dimensions exception");
+
+  return S21LazyMatrix(std::make_shared<const Node>(
+      Node::Op::kProduct, GetRowsCount(), other.GetColsCount(), 0.0, node_,
+      other.node_));
+}
+
+S21LazyMatrix S21LazyMatrix::Transpose() const {
+  CheckNotNull(*this, "S21LazyMatrix::Transpose");
+  return S21LazyMatrix(
+      std::make_shared<const Node>(Node::Op::kTranspose, GetColsCount(),
+                                   GetRowsCount(), 0.0, node_, nullptr));
+}
+
+S21Matrix S21LazyMatrix::Evaluate(S21LazyReport* report) const {
+  return Evaluate(std::vector<S21LazyMatrix>{*this}, report).front();
+}
+
+std::vector<S21Matrix> S21LazyMatrix::Evaluate(
+    const std::vector<S21LazyMatrix>& roots, S21LazyReport* report) {
+  S21OperationTimer timer(S21Operation::kEvaluate);
+  S21LazyPlan plan(roots);
+  std::vector<S21Matrix> result = plan.Run();
+
+  if (report != nullptr) plan.Report(report);
+  return result;
+}
+
+int S21LazyMatrix::GetRowsCount() const noexcept {
+  return node_ != nullptr ? node_->rows : 0;
+}
+
+int S21LazyMatrix::GetColsCount() const noexcept {
+  return node_ != nullptr ? node_->cols : 0;
+}
+
+bool S21LazyMatrix::IsNull() const noexcept { return node_ == nullptr; }
+
+std::vector<S21Matrix> S21LazyPlan::Run() {
+  int levels = 0;
+  for (const Step& step : steps_) levels = std::max(levels, step.level);
+
+  for (int level = 1; level <= levels; level++) {
+    std::vector<const Step*> ready;
+    for (const Step& step : steps_) {
+      if (step.level == level) {
+        Allocate(step);
+        ready.push_back(&step);
+      }
+    }
+
+    if (ready.size() == 1) {
+      Execute(*ready.front());
+    } else {
+      S21TaskGroup group;
+      for (const Step* step : ready) {
+        group.Run([this, step]() { Execute(*step); });
+      }
+      group.Wait();
+    }
+    Release(level);
+  }
+
+  // a root listed twice is copied, the last one takes the buffer
+  std::vector<S21Matrix> result;
+  for (auto root = roots_.begin(); root != roots_.end(); ++root) {
+    const Entry& entry = entries_[*root];
+    if (entry.op == Op::kLeaf ||
+        std::find(root + 1, roots_.end(), *root) != roots_.end()) {
+      result.push_back(Value(*root));
+    } else {
+      result.push_back(std::move(values_[entry.slot]));
+    }
+  }
+  report_.steps = steps_.size();
+  return result;
+}
+
+void S21LazyPlan::Report(S21LazyReport* report) const noexcept {
+  *report = report_;
+}
+
+// private functions
+
+bool S21LazyPlan::IsElementWise(Op op) noexcept {
+  return op == Op::kSum || op == Op::kSub || op == Op::kMulNumber ||
+         op == Op::kMulMatrix;
+}
+
+// the operations of the eager methods, so fused results are the same bits
+void S21LazyPlan::Apply(const Instruction& instruction, const double* a,
+                        const double* b, double* out, int cols) noexcept {
+  switch (instruction.op) {
+    case Op::kSum:
+      for (int j = 0; j < cols; j++) out[j] = a[j] + b[j];
+      break;
+    case Op::kSub:
+      for (int j = 0; j < cols; j++) out[j] = a[j] - b[j];
+      break;
+    case Op::kMulMatrix:
+      for (int j = 0; j < cols; j++) out[j] = a[j] * b[j];
+      break;
+    default: {
+      double num = instruction.num;
+      for (int j = 0; j < cols; j++) out[j] = a[j] * num;
+    }
+  }
+}
+
+// post-order without recursion, long chains of operations are common
+int S21LazyPlan::Collect(const Node* root) {
+  std::vector<std::pair<const Node*, bool>> stack = {{root, false}};
+
+  while (!stack.empty()) {
+    auto [node, expanded] = stack.back();
+    stack.pop_back();
+
+    if (indices_.count(node) != 0) continue;
+    if (expanded) {
+      indices_.emplace(node, Intern(node));
+    } else {
+      stack.push_back({node, true});
+      if (node->b != nullptr) stack.push_back({node->b.get(), false});
+      if (node->a != nullptr) stack.push_back({node->a.get(), false});
+    }
+  }
+  return indices_.at(root);
+}
+
+// an operation on the same operands as an earlier entry is that entry.
+// sums and element-wise products are exact in either order, so their
+// operands are sorted first
+int S21LazyPlan::Intern(const Node* node) {
+  Entry entry;
+  entry.op = node->op;
+  entry.rows = node->rows;
+  entry.cols = node->cols;
+  entry.num = node->num;
+  report_.nodes++;
+
+  if (node->op == Op::kLeaf) {
+    entry.leaf = &node->matrix;
+  } else {
+    entry.a = indices_.at(node->a.get());
+    if (node->b != nullptr) entry.b = indices_.at(node->b.get());
+    if ((entry.op == Op::kSum || entry.op == Op::kMulMatrix) &&
+        entry.a > entry.b) {
+      std::swap(entry.a, entry.b);
+    }
+
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &entry.num, sizeof(bits));
+    auto key = std::make_tuple(static_cast<int>(entry.op), entry.a, entry.b,
+                               bits);
+    auto found = keys_.find(key);
+    if (found != keys_.end()) {
+      report_.merged++;
+      return found->second;
+    }
+    keys_.emplace(key, static_cast<int>(entries_.size()));
+  }
+  entries_.push_back(entry);
+  return static_cast<int>(entries_.size()) - 1;
+}
+
+// a transpose of a transpose is its operand, the transposes and scalar
+// factors of product operands become the Gemm flags and alpha
+void S21LazyPlan::FoldOperands() {
+  std::vector<int> alias(entries_.size());
+
+  for (std::size_t i = 0; i < entries_.size(); i++) {
+    Entry& entry = entries_[i];
+    alias[i] = static_cast<int>(i);
+    if (entry.a >= 0) entry.a = alias[entry.a];
+    if (entry.b >= 0) entry.b = alias[entry.b];
+
+    if (entry.op == Op::kTranspose && entries_[entry.a].op == Op::kTranspose) {
+      alias[i] = entries_[entry.a].a;
+      report_.folded++;
+    } else if (entry.op == Op::kProduct) {
+      FoldOperand(&entry.a, &entry.transA, &entry.alpha);
+      FoldOperand(&entry.b, &entry.transB, &entry.alpha);
+    }
+  }
+  for (int& root : roots_) root = alias[root];
+}
+
+void S21LazyPlan::FoldOperand(int* index, bool* transposed, double* alpha) {
+  while (entries_[*index].op == Op::kTranspose ||
+         entries_[*index].op == Op::kMulNumber) {
+    const Entry& operand = entries_[*index];
+    if (operand.op == Op::kTranspose) {
+      *transposed = !*transposed;
+    } else {
+      *alpha *= operand.num;
+    }
+    *index = operand.a;
+    report_.folded++;
+  }
+}
+
+// the references of the entries reachable from the roots, unreachable
+// entries keep 0. the operands come first, so one backward pass does it
+void S21LazyPlan::CountUses() {
+  for (Entry& entry : entries_) {
+    entry.uses = 0;
+    entry.root = false;
+  }
+  for (int root : roots_) {
+    entries_[root].uses++;
+    entries_[root].root = true;
+  }
+
+  for (int i = static_cast<int>(entries_.size()) - 1; i >= 0; i--) {
+    if (entries_[i].uses == 0) continue;
+    for (int input : {entries_[i].a, entries_[i].b, entries_[i].c}) {
+      if (input >= 0) {
+        entries_[input].uses++;
+        entries_[input].consumer = i;
+      }
+    }
+  }
+}
+
+bool S21LazyPlan::IsFoldable(int index) const noexcept {
+  const Entry& entry = entries_[index];
+  return entry.op == Op::kProduct && entry.uses == 1 && !entry.root;
+}
+
+void S21LazyPlan::TakeOver(Entry* entry, Entry* product) {
+  entry->op = Op::kProduct;
+  entry->a = product->a;
+  entry->b = product->b;
+  entry->transA = product->transA;
+  entry->transB = product->transB;
+  entry->alpha = product->alpha;
+  entry->c = product->c;
+  entry->beta = product->beta;
+  product->uses = 0;
+  report_.folded++;
+}
+
+// a product read only by a scale, a transpose or a sum is computed by the
+// Gemm of that entry: s * (a * b) scales alpha, (a * b)^T = b^T * a^T swaps
+// the operands, (a * b) + c accumulates into c
+void S21LazyPlan::FoldIntoProducts() {
+  for (Entry& entry : entries_) {
+    if (entry.uses == 0) continue;
+
+    if (entry.op == Op::kMulNumber && IsFoldable(entry.a)) {
+      double num = entry.num;
+      TakeOver(&entry, &entries_[entry.a]);
+      entry.alpha *= num;
+      entry.beta *= num;
+    } else if (entry.op == Op::kTranspose && IsFoldable(entry.a) &&
+               entries_[entry.a].c < 0) {
+      Entry& product = entries_[entry.a];
+      TakeOver(&entry, &product);
+      std::swap(entry.a, entry.b);
+      entry.transA = !product.transB;
+      entry.transB = !product.transA;
+    } else if (entry.op == Op::kSum || entry.op == Op::kSub) {
+      double sign = entry.op == Op::kSum ? 1.0 : -1.0;
+      int a = entry.a;
+      int b = entry.b;
+
+      if (IsFoldable(a) && entries_[a].c < 0) {
+        TakeOver(&entry, &entries_[a]);
+        entry.c = b;
+        entry.beta = sign;
+      } else if (IsFoldable(b) && entries_[b].c < 0) {
+        TakeOver(&entry, &entries_[b]);
+        entry.c = a;
+        entry.beta = 1.0;
+        entry.alpha *= sign;
+      }
+    }
+  }
+}
+
+// an element-wise entry or a transpose read once, by an element-wise entry,
+// is computed row by row inside the kernel of its consumer
+void S21LazyPlan::MarkInlined() {
+  for (Entry& entry : entries_) {
+    entry.inlined = entry.uses == 1 && !entry.root &&
+                    (IsElementWise(entry.op) || entry.op == Op::kTranspose) &&
+                    IsElementWise(entries_[entry.consumer].op);
+    if (entry.inlined) report_.fused++;
+  }
+}
+
+void S21LazyPlan::BuildSteps() {
+  for (int i = 0; i < static_cast<int>(entries_.size()); i++) {
+    Entry& entry = entries_[i];
+    if (entry.uses == 0 || entry.inlined || entry.op == Op::kLeaf) continue;
+
+    Step step = {i, 1, {}, {}, {}};
+    if (IsElementWise(entry.op)) {
+      Compile(i, &step);
+    } else {
+      for (int input : {entry.a, entry.b, entry.c}) {
+        if (input >= 0) AddInput(&step, input);
+      }
+    }
+    for (int input : step.inputs) {
+      step.level = std::max(step.level, entries_[input].level + 1);
+    }
+    entry.level = step.level;
+    steps_.push_back(std::move(step));
+  }
+
+  for (const Step& step : steps_) {
+    for (int input : step.inputs) {
+      Entry& entry = entries_[input];
+      if (step.level > entry.lastLevel) {
+        entry.lastLevel = step.level;
+        entry.lastReaders = 0;
+      }
+      if (step.level == entry.lastLevel) entry.lastReaders++;
+    }
+  }
+}
+
+// the instructions of entry index within the kernel of step, in evaluation
+// order. the entries that aren't inlined are read as rows
+S21LazyPlan::Operand S21LazyPlan::Compile(int index, Step* step) {
+  const Entry& entry = entries_[index];
+  Operand result = {Source::kNone, -1};
+
+  if (index != step->entry && !entry.inlined) {
+    AddInput(step, index);
+    result = {Source::kRow, index};
+  } else if (entry.op == Op::kTranspose) {
+    AddInput(step, entry.a);
+    step->transposed.push_back(entry.a);
+    result = {Source::kTransposed,
+              static_cast<int>(step->transposed.size()) - 1};
+  } else {
+    Instruction instruction = {entry.op, entry.num, Compile(entry.a, step),
+                               {Source::kNone, -1}};
+    if (entry.b >= 0) instruction.b = Compile(entry.b, step);
+    step->code.push_back(instruction);
+    result = {Source::kTemp, static_cast<int>(step->code.size()) - 1};
+  }
+  return result;
+}
+
+void S21LazyPlan::AddInput(Step* step, int index) const {
+  if (std::find(step->inputs.begin(), step->inputs.end(), index) ==
+      step->inputs.end()) {
+    step->inputs.push_back(index);
+  }
+}
+
+// an intermediate read for the last time, by this step alone, can become
+// its result: a kernel writes row i after reading row i of its inputs, and
+// Gemm accumulates into c in place. neither works when the buffer is also
+// read transposed or as a product operand
+bool S21LazyPlan::CanHandOver(const Step& step, int index) const {
+  const Entry& entry = entries_[step.entry];
+  const Entry& donor = entries_[index];
+  bool allowed = false;
+
+  if (IsElementWise(entry.op)) {
+    allowed = std::find(step.transposed.begin(), step.transposed.end(),
+                        index) == step.transposed.end();
+  } else if (entry.op == Op::kProduct) {
+    allowed = index == entry.c && index != entry.a && index != entry.b;
+  }
+  return allowed && donor.op != Op::kLeaf && !donor.root &&
+         !donor.handedOver && donor.lastLevel == step.level &&
+         donor.lastReaders == 1 && donor.rows == entry.rows &&
+         donor.cols == entry.cols;
+}
+
+// the result takes over an input buffer when it can, else a released
+// buffer of the same shape, else a new one. no element is initialized
+void S21LazyPlan::Allocate(const Step& step) {
+  Entry& entry = entries_[step.entry];
+  auto donor = std::find_if(
+      step.inputs.begin(), step.inputs.end(),
+      [this, &step](int index) { return CanHandOver(step, index); });
+
+  if (donor != step.inputs.end()) {
+    entry.slot = entries_[*donor].slot;
+    entries_[*donor].handedOver = true;
+    report_.reused++;
+    return;
+  }
+
+  auto released = std::find_if(
+      released_.begin(), released_.end(), [this, &entry](int slot) {
+        return values_[slot].GetRowsCount() == entry.rows &&
+               values_[slot].GetColsCount() == entry.cols;
+      });
+  if (released != released_.end()) {
+    entry.slot = *released;
+    released_.erase(released);
+    report_.reused++;
+  } else {
+    entry.slot = static_cast<int>(values_.size());
+    values_.emplace_back(entry.rows, entry.cols, S21Matrix::uninit);
+  }
+}
+
+void S21LazyPlan::Release(int level) {
+  for (const Entry& entry : entries_) {
+    if (entry.slot >= 0 && entry.lastLevel == level && !entry.root &&
+        !entry.handedOver) {
+      released_.push_back(entry.slot);
+    }
+  }
+}
+
+const S21Matrix& S21LazyPlan::Value(int index) const noexcept {
+  const Entry& entry = entries_[index];
+  return entry.leaf != nullptr ? *entry.leaf : values_[entry.slot];
+}
+
+// the steps of a level run concurrently: each writes its own buffer, and
+// values_ doesn't grow while they run
+void S21LazyPlan::Execute(const Step& step) {
+  const Entry& entry = entries_[step.entry];
+  S21Matrix* result = &values_[entry.slot];
+
+  if (entry.op == Op::kProduct) {
+    RunProduct(entry, result);
+  } else if (entry.op == Op::kTranspose) {
+    RunTranspose(entry, result);
+  } else {
+    RunKernel(step, result);
+  }
+}
+
+// a plain product keeps the Strassen choice of S21Matrix::Product
+void S21LazyPlan::RunProduct(const Entry& entry, S21Matrix* result) const {
+  const S21Matrix& a = Value(entry.a);
+  const S21Matrix& b = Value(entry.b);
+  int k = entry.transA ? a.GetRowsCount() : a.GetColsCount();
+  double beta = 0.0;
+
+  if (entry.c >= 0) {
+    const S21Matrix& c = Value(entry.c);
+    if (&c != result) {
+      for (int i = 0; i < entry.rows; i++) {
+        std::copy_n(c.RowPtr(i), entry.cols, result->RowPtr(i));
+      }
+    }
+    beta = entry.beta;
+  }
+
+  if (beta == 0.0 && entry.alpha == 1.0 && !entry.transA && !entry.transB &&
+      S21PreferStrassen(entry.rows, k, entry.cols)) {
+    S21MultiplyStrassen(a.GetMatrix(), b.GetMatrix(), result->GetMatrix(),
+                        entry.rows, k, entry.cols);
+  } else {
+    result->Gemm(entry.alpha, a, entry.transA, b, entry.transB, beta);
+  }
+}
+
+void S21LazyPlan::RunTranspose(const Entry& entry, S21Matrix* result) const {
+  double* const* source = Value(entry.a).GetMatrix();
+  double* const* out = result->GetMatrix();
+
+  for (int i = 0; i < entry.rows; i++) {
+    for (int j = 0; j < entry.cols; j++) {
+      out[i][j] = source[j][i];
+    }
+  }
+}
+
+// row i of every instruction goes to a scratch row, the last one to the
+// result, so the intermediates never leave the cache. transposed operands
+// are gathered a block of rows at a time, reading their columns in runs
+void S21LazyPlan::RunKernel(const Step& step, S21Matrix* result) const {
+  int rows = result->GetRowsCount();
+  int cols = result->GetColsCount();
+  double* const* out = result->GetMatrix();
+  std::size_t last = step.code.size() - 1;
+  std::size_t blocks =
+      static_cast<std::size_t>((rows + kRowsBlock - 1) / kRowsBlock);
+
+  auto run = [&](std::size_t block) {
+    int begin = static_cast<int>(block) * kRowsBlock;
+    int end = std::min(rows, begin + kRowsBlock);
+    std::vector<double> temps(last * cols);
+    std::vector<double> columns(step.transposed.size() * kRowsBlock * cols);
+
+    for (std::size_t t = 0; t < step.transposed.size(); t++) {
+      double* const* source = Value(step.transposed[t]).GetMatrix();
+      double* gathered = columns.data() + t * kRowsBlock * cols;
+      for (int j = 0; j < cols; j++) {
+        for (int i = begin; i < end; i++) {
+          gathered[(i - begin) * cols + j] = source[j][i];
+        }
+      }
+    }
+
+    auto row = [&](const Operand& operand, int i) -> const double* {
+      const double* pointer = nullptr;
+      if (operand.source == Source::kRow) {
+        pointer = Value(operand.index).GetMatrix()[i];
+      } else if (operand.source == Source::kTransposed) {
+        pointer = columns.data() +
+                  (operand.index * kRowsBlock + i - begin) * cols;
+      } else if (operand.source == Source::kTemp) {
+        pointer = temps.data() + operand.index * cols;
+      }
+      return pointer;
+    };
+
+    for (int i = begin; i < end; i++) {
+      for (std::size_t k = 0; k <= last; k++) {
+        const Instruction& instruction = step.code[k];
+        double* target = k == last ? out[i] : temps.data() + k * cols;
+        Apply(instruction, row(instruction.a, i), row(instruction.b, i),
+              target, cols);
+      }
+    }
+  };
+
+  if (static_cast<double>(rows) * cols >= kParallelSize) {
+    S21ThreadPool::GetInstance().ParallelFor(blocks, run);
+  } else {
+    for (std::size_t block = 0; block < blocks; block++) run(block);
+  }
+}
@@ -0,0 +1,72 @@
+#ifndef SRC_S21_LAZY_H_
+#define SRC_S21_LAZY_H_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// deferred evaluation. the operations of S21LazyMatrix only record a node of
+// an expression graph (the nodes share their operands, so it is a DAG) and
+// check the shapes right away; Evaluate optimizes the whole graph first:
+// - equal subexpressions are computed once
+// - transposes, scalar factors and a sum around a product fold into one
+//   Gemm call (alpha * op(a) * op(b) + beta * c)
+// - element-wise operations run fused, row by row, without full size
+//   intermediates
+// - dead intermediates hand their buffers over to later steps
+// - independent steps run in parallel on the thread pool
+// like S21Matrix, operator* multiplies element-wise and Product is the
+// matrix product. a leaf keeps a copy of its matrix (cheap for copy-on-write
+// ones), so the graph never refers to the caller's matrices
+
+// what Evaluate made of the graph
+struct S21LazyReport {
+  std::size_t nodes;    // reachable from the roots
+  std::size_t merged;   // common subexpressions dropped
+  std::size_t folded;   // transposes, scalars and sums folded into products
+  std::size_t fused;    // element-wise nodes computed inside a fused kernel
+  std::size_t steps;    // kernels run: products, fused and transposes
+  std::size_t reused;   // buffers taken over from dead intermediates
+};
+
+class S21LazyMatrix {
+ public:
+  S21LazyMatrix() noexcept = default;
+  explicit S21LazyMatrix(const S21Matrix& matrix);
+  explicit S21LazyMatrix(S21Matrix&& matrix);
+
+  S21LazyMatrix operator+(const S21LazyMatrix& other) const;
+  S21LazyMatrix operator-(const S21LazyMatrix& other) const;
+  S21LazyMatrix operator*(const S21LazyMatrix& other) const;
+  S21LazyMatrix operator*(double num) const;
+
+  S21LazyMatrix MulMatrix(const S21LazyMatrix& other) const;
+  S21LazyMatrix Product(const S21LazyMatrix& other) const;
+  S21LazyMatrix Transpose() const;
+
+  // runs the graph, the nodes stay valid for further expressions
+  S21Matrix Evaluate(S21LazyReport* report = nullptr) const;
+  // one optimized graph for several results, their shared subexpressions
+  // are computed once
+  static std::vector<S21Matrix> Evaluate(
+      const std::vector<S21LazyMatrix>& roots,
+      S21LazyReport* report = nullptr);
+
+  int GetRowsCount() const noexcept;
+  int GetColsCount() const noexcept;
+  bool IsNull() const noexcept;
+
+ private:
+  friend class S21LazyPlan;
+  struct Node;
+
+  explicit S21LazyMatrix(std::shared_ptr<const Node> node) noexcept;
+
+  std::shared_ptr<const Node> node_;
+};
+
+S21LazyMatrix operator*(double num, const S21LazyMatrix& other);
+
+#endif  // SRC_S21_LAZY_H_
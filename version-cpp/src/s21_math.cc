@@ -0,0 +1,24 @@
+#include "s21_math.h"
+
+namespace {
+
+// in and out may be the same row (Apply), so they aren't __restrict__
+template <class Function>
+void BatchKernel(const double* in, double* out, int size) noexcept {
+  Function function;
+  for (int i = 0; i < size; i++) out[i] = function(in[i]);
+}
+
+}  // namespace
+
+void S21Exp::Batch(const double* in, double* out, int size) noexcept {
+  BatchKernel<S21Exp>(in, out, size);
+}
+
+void S21Log::Batch(const double* in, double* out, int size) noexcept {
+  BatchKernel<S21Log>(in, out, size);
+}
+
+void S21Sqrt::Batch(const double* in, double* out, int size) noexcept {
+  BatchKernel<S21Sqrt>(in, out, size);
+}
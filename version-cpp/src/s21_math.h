@@ -0,0 +1,162 @@
+#ifndef SRC_S21_MATH_H_
+#define SRC_S21_MATH_H_
+
+#include <math.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+// element-wise functors for S21Matrix::Apply, Map and Zip. they are inline
+// and branch-free (selects instead of branches, no libm calls), so the row
+// loops vectorize wherever they are instantiated. a functor can also provide
+// a Batch(in, out, size) kernel, which the row loops call on whole rows
+// instead: exp, log and sqrt do, their kernels are compiled into the library
+// without errno and floating point traps, which otherwise keep gcc from
+// vectorizing sqrt and the selects
+
+namespace s21_math_detail {
+
+constexpr double kShift = 0x1.8p52;
+
+inline std::uint64_t Bits(double value) noexcept {
+  std::uint64_t result;
+  std::memcpy(&result, &value, sizeof(result));
+  return result;
+}
+
+inline double FromBits(std::uint64_t bits) noexcept {
+  double result;
+  std::memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+// 2^n for an integral n in [-1022, 1023]
+inline double Pow2(double n) noexcept {
+  return FromBits((Bits(n + kShift) - Bits(kShift) + 1023) << 52);
+}
+
+}  // namespace s21_math_detail
+
+// exp(x) = 2^n * exp(r), n = round(x / ln2), |r| <= ln2 / 2, exp(r) by its
+// Taylor series to degree 13. 2^n is applied as two halves so the
+// subnormal results are reached as well. within 2 ulp of the exact result
+struct S21Exp {
+  double operator()(double x) const noexcept {
+    using namespace s21_math_detail;
+    constexpr double kLog2e = 1.4426950408889634;
+    constexpr double kLn2Hi = 6.93147180369123816490e-01;
+    constexpr double kLn2Lo = 1.90821492927058770002e-10;
+
+    // NaN passes through the clamp
+    double clamped = std::min(std::max(x, -746.0), 710.0);
+    double n = (clamped * kLog2e + kShift) - kShift;
+    double r = (clamped - n * kLn2Hi) - n * kLn2Lo;
+
+    double p = 1.0 / 6227020800.0;
+    p = p * r + 1.0 / 479001600.0;
+    p = p * r + 1.0 / 39916800.0;
+    p = p * r + 1.0 / 3628800.0;
+    p = p * r + 1.0 / 362880.0;
+    p = p * r + 1.0 / 40320.0;
+    p = p * r + 1.0 / 5040.0;
+    p = p * r + 1.0 / 720.0;
+    p = p * r + 1.0 / 120.0;
+    p = p * r + 1.0 / 24.0;
+    p = p * r + 1.0 / 6.0;
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+
+    double half = (n * 0.5 + kShift) - kShift;
+    return p * Pow2(half) * Pow2(n - half);
+  }
+  static void Batch(const double* in, double* out, int size) noexcept;
+};
+
+// log(x) = k ln2 + log(m), m in [sqrt(1/2), sqrt(2)), log(m) = 2 atanh(s)
+// with s = (m - 1) / (m + 1) by its series to s^21. subnormals are scaled
+// into the normal range first. within 2 ulp of the exact result
+struct S21Log {
+  double operator()(double x) const noexcept {
+    using namespace s21_math_detail;
+    constexpr double kLn2Hi = 6.93147180369123816490e-01;
+    constexpr double kLn2Lo = 1.90821492927058770002e-10;
+    constexpr std::uint64_t kSqrtHalf = 0x3FE6A09E667F3BCDull;
+    constexpr std::uint64_t kBias = 2048ull << 52;
+    constexpr double kInfinity = std::numeric_limits<double>::infinity();
+
+    bool tiny = x < std::numeric_limits<double>::min();
+    double y = tiny ? x * 0x1p54 : x;
+
+    // k + 2048 (kept positive, the shifts are logical), y = 2^k m
+    std::uint64_t biased = (Bits(y) + kBias - kSqrtHalf) >> 52;
+    double m = FromBits(Bits(y) + kBias - (biased << 52));
+    double k = (FromBits(biased + Bits(kShift)) - kShift) - 2048.0 -
+               (tiny ? 54.0 : 0.0);
+
+    double f = m - 1.0;
+    double s = f / (2.0 + f);
+    double z = s * s;
+    double series = 2.0 / 21.0;
+    series = series * z + 2.0 / 19.0;
+    series = series * z + 2.0 / 17.0;
+    series = series * z + 2.0 / 15.0;
+    series = series * z + 2.0 / 13.0;
+    series = series * z + 2.0 / 11.0;
+    series = series * z + 2.0 / 9.0;
+    series = series * z + 2.0 / 7.0;
+    series = series * z + 2.0 / 5.0;
+    series = series * z + 2.0 / 3.0;
+    series *= z;
+
+    // 2s + s * series, with 2s = f - s f
+    double result = k * kLn2Hi + ((f - s * (f - series)) + k * kLn2Lo);
+    double special = x == 0.0 ? -kInfinity : x == kInfinity ? x : NAN;
+    return x > 0.0 && x < kInfinity ? result : special;
+  }
+  static void Batch(const double* in, double* out, int size) noexcept;
+};
+
+struct S21Sqrt {
+  double operator()(double x) const noexcept { return sqrt(x); }
+  static void Batch(const double* in, double* out, int size) noexcept;
+};
+
+struct S21Abs {
+  double operator()(double x) const noexcept { return fabs(x); }
+};
+
+struct S21Clamp {
+  double operator()(double x) const noexcept {
+    return std::min(std::max(x, min), max);
+  }
+  double min;
+  double max;
+};
+
+struct S21Max {
+  double operator()(double a, double b) const noexcept {
+    return std::max(a, b);
+  }
+};
+
+struct S21Min {
+  double operator()(double a, double b) const noexcept {
+    return std::min(a, b);
+  }
+};
+
+// whether Function has a Batch kernel
+template <class Function, class = void>
+struct S21HasBatch : std::false_type {};
+
+template <class Function>
+struct S21HasBatch<Function,
+                   std::void_t<decltype(Function::Batch(
+                       std::declval<const double*>(),
+                       std::declval<double*>(), 0))>> : std::true_type {};
+
+#endif  // SRC_S21_MATH_H_
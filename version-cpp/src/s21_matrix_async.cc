@@ -0,0 +1,68 @@
+#include <string>
+#include <utility>
+
+#include "s21_async.h"
+#include "s21_matrix_oop.h"
+
+// every task owns copies of its operands, the results are moved out
+
+S21Future<S21Matrix> S21Matrix::SumMatrixAsync(const S21Matrix& other) const {
+  return S21Async([result = *this, other]() mutable {
+    result.SumMatrix(other);
+    return std::move(result);
+  });
+}
+
+S21Future<S21Matrix> S21Matrix::SubMatrixAsync(const S21Matrix& other) const {
+  return S21Async([result = *this, other]() mutable {
+    result.SubMatrix(other);
+    return std::move(result);
+  });
+}
+
+S21Future<S21Matrix> S21Matrix::MulNumberAsync(double num) const {
+  return S21Async([result = *this, num]() mutable {
+    result.MulNumber(num);
+    return std::move(result);
+  });
+}
+
+S21Future<S21Matrix> S21Matrix::MulMatrixAsync(const S21Matrix& other) const {
+  return S21Async([result = *this, other]() mutable {
+    result.MulMatrix(other);
+    return std::move(result);
+  });
+}
+
+S21Future<S21Matrix> S21Matrix::ProductAsync(const S21Matrix& other) const {
+  return S21Async(
+      [matrix = *this, other]() { return matrix.Product(other); });
+}
+
+S21Future<S21Matrix> S21Matrix::TransposeAsync() const {
+  return S21Async([matrix = *this]() { return matrix.Transpose(); });
+}
+
+S21Future<S21Matrix> S21Matrix::CalcComplementsAsync() const {
+  return S21Async([matrix = *this]() { return matrix.CalcComplements(); });
+}
+
+S21Future<double> S21Matrix::DeterminantAsync() const {
+  return S21Async([matrix = *this]() { return matrix.Determinant(); });
+}
+
+S21Future<S21Matrix> S21Matrix::InverseMatrixAsync() const {
+  return S21Async([matrix = *this]() { return matrix.InverseMatrix(); });
+}
+
+S21Future<S21Matrix> S21Matrix::FromCsvAsync(const std::string& path,
+                                             char delimiter) {
+  return S21Async(
+      [path, delimiter]() { return S21Matrix::FromCsv(path, delimiter); });
+}
+
+S21Future<void> S21Matrix::ToCsvAsync(const std::string& path,
+                                      char delimiter) const {
+  return S21Async(
+      [matrix = *this, path, delimiter]() { matrix.ToCsv(path, delimiter); });
+}
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+
+#include "s21_matrix_oop.h"
+#include "s21_matrix_stats.h"
+#include "s21_parallel.h"
+
+namespace {
+
+// matrices from kParallelSize elements are split over the thread pool in
+// blocks of kRowsBlock rows
+constexpr double kParallelSize = 1 << 16;
+constexpr int kRowsBlock = 16;
+
+// matrix = operation(matrix, other) in one pass, other is rows x cols,
+// 1 x cols, rows x 1 or 1 x 1: a single row is reused for every row of the
+// matrix, the single element of a row of a single column stays in a
+// register, so the operand is never expanded. other may be the matrix itself
+template <class Operation>
+void Broadcast(double* const* matrix, int rows, int cols,
+               double* const* other, int otherRows, int otherCols,
+               const Operation& operation) {
+  std::size_t blocks =
+      static_cast<std::size_t>((rows + kRowsBlock - 1) / kRowsBlock);
+  auto run = [&](std::size_t block) {
+    int begin = static_cast<int>(block) * kRowsBlock;
+    int end = std::min(rows, begin + kRowsBlock);
+
+    for (int i = begin; i < end; i++) {
+      double* row = matrix[i];
+      const double* operand = other[otherRows == 1 ? 0 : i];
+
+      if (otherCols == 1) {
+        double value = operand[0];
+        for (int j = 0; j < cols; j++) row[j] = operation(row[j], value);
+      } else {
+        for (int j = 0; j < cols; j++) row[j] = operation(row[j], operand[j]);
+      }
+    }
+  };
+
+  if (static_cast<double>(rows) * cols >= kParallelSize) {
+    S21ThreadPool::GetInstance().ParallelFor(blocks, run);
+  } else {
+    for (std::size_t block = 0; block < blocks; block++) run(block);
+  }
+}
+
+}  // namespace
+
+// S21Matrix
+
+void S21Matrix::SumBroadcast(const S21Matrix& other) {
+  S21OperationTimer timer(S21Operation::kBroadcast);
+
+  if (IsNullOrEmpty() || other.IsNullOrEmpty())
+    throw std::invalid_argument(
+        "S21Matrix::SumBroadcast: null matrix exception");
+
+  if (!IsBroadcastable(other))
+    throw std::invalid_argument(
+        "S21Matrix::SumBroadcast: different matrix dimensions exception");
+
+  PrepareWrite();
+  Broadcast(matrix_, rows_, cols_, other.matrix_, other.rows_, other.cols_,
+            std::plus<double>());
+  timer.AddFlops(1.0 * rows_ * cols_);
+}
+
+void S21Matrix::SubBroadcast(const S21Matrix& other) {
+  S21OperationTimer timer(S21Operation::kBroadcast);
+
+  if (IsNullOrEmpty() || other.IsNullOrEmpty())
+    throw std::invalid_argument(
+        "S21Matrix::SubBroadcast: null matrix exception");
+
+  if (!IsBroadcastable(other))
+    throw std::invalid_argument(
+        "S21Matrix::SubBroadcast: different matrix dimensions exception");
+
+  PrepareWrite();
+  Broadcast(matrix_, rows_, cols_, other.matrix_, other.rows_, other.cols_,
+            std::minus<double>());
+  timer.AddFlops(1.0 * rows_ * cols_);
+}
+
+void S21Matrix::MulBroadcast(const S21Matrix& other) {
+  S21OperationTimer timer(S21Operation::kBroadcast);
+
+  if (IsNullOrEmpty() || other.IsNullOrEmpty())
+    throw std::invalid_argument(
+        "S21Matrix::MulBroadcast: null matrix exception");
+
+  if (!IsBroadcastable(other))
+    throw std::invalid_argument(
+        "S21Matrix::MulBroadcast: different matrix dimensions exception");
+
+  PrepareWrite();
+  Broadcast(matrix_, rows_, cols_, other.matrix_, other.rows_, other.cols_,
+            std::multiplies<double>());
+  timer.AddFlops(1.0 * rows_ * cols_);
+}
+
+// an exact division, not a multiplication by the reciprocal
+void S21Matrix::DivBroadcast(const S21Matrix& other) {
+  S21OperationTimer timer(S21Operation::kBroadcast);
+
+  if (IsNullOrEmpty() || other.IsNullOrEmpty())
+    throw std::invalid_argument(
+        "S21Matrix::DivBroadcast: null matrix exception");
+
+  if (!IsBroadcastable(other))
+    throw std::invalid_argument(
+        "S21Matrix::DivBroadcast: different matrix dimensions exception");
+
+  PrepareWrite();
+  Broadcast(matrix_, rows_, cols_, other.matrix_, other.rows_, other.cols_,
+            std::divides<double>());
+  timer.AddFlops(1.0 * rows_ * cols_);
+}
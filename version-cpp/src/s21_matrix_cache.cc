@@ -0,0 +1,366 @@
+#include "s21_matrix_cache.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+namespace {
+
+constexpr std::size_t kShardsCount = 16;
+// the list and index nodes of an entry, roughly
+constexpr std::size_t kEntryOverhead = 128;
+
+constexpr std::uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr std::uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr std::uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+constexpr std::uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr std::uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+inline std::uint64_t Rotate(std::uint64_t value, int bits) noexcept {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+inline std::uint64_t Round(std::uint64_t accumulator,
+                           std::uint64_t input) noexcept {
+  return Rotate(accumulator + input * kPrime2, 31) * kPrime1;
+}
+
+inline std::uint64_t MergeRound(std::uint64_t hash,
+                                std::uint64_t lane) noexcept {
+  return (hash ^ Round(0, lane)) * kPrime1 + kPrime4;
+}
+
+inline std::uint64_t Bits(double value) noexcept {
+  std::uint64_t result = 0;
+  std::memcpy(&result, &value, sizeof(result));
+  return result;
+}
+
+// XXH64 over a stream of doubles fed a row at a time (on little-endian
+// machines the same value as XXH64 of their bytes). the four lanes are
+// independent multiply-rotate chains, so they overlap in the pipeline; the
+// 64-bit multiplies have no SSE2/AVX2 vector form, so this beats a vector
+// hash of the same strength
+class Xxh64 {
+ public:
+  explicit Xxh64(std::uint64_t seed) noexcept
+      : seed_(seed),
+        lanes_{seed + kPrime1 + kPrime2, seed + kPrime2, seed,
+               seed - kPrime1} {}
+
+  void Update(const double* values, int count) noexcept {
+    int i = 0;
+
+    total_ += static_cast<std::uint64_t>(count);
+    while (pendingCount_ > 0 && pendingCount_ < 4 && i < count) {
+      pending_[pendingCount_++] = Bits(values[i++]);
+    }
+    if (pendingCount_ == 4) {
+      for (int lane = 0; lane < 4; lane++) {
+        lanes_[lane] = Round(lanes_[lane], pending_[lane]);
+      }
+      pendingCount_ = 0;
+    }
+    for (; i + 4 <= count; i += 4) {
+      lanes_[0] = Round(lanes_[0], Bits(values[i]));
+      lanes_[1] = Round(lanes_[1], Bits(values[i + 1]));
+      lanes_[2] = Round(lanes_[2], Bits(values[i + 2]));
+      lanes_[3] = Round(lanes_[3], Bits(values[i + 3]));
+    }
+    while (i < count) pending_[pendingCount_++] = Bits(values[i++]);
+  }
+
+  std::uint64_t Digest() const noexcept {
+    std::uint64_t result = seed_ + kPrime5;
+
+    if (total_ >= 4) {
+      result = Rotate(lanes_[0], 1) + Rotate(lanes_[1], 7) +
+               Rotate(lanes_[2], 12) + Rotate(lanes_[3], 18);
+      for (std::uint64_t lane : lanes_) result = MergeRound(result, lane);
+    }
+    result += total_ * sizeof(double);
+    for (int i = 0; i < pendingCount_; i++) {
+      result = Rotate(result ^ Round(0, pending_[i]), 27) * kPrime1 + kPrime4;
+    }
+
+    result ^= result >> 33;
+    result *= kPrime2;
+    result ^= result >> 29;
+    result *= kPrime3;
+    result ^= result >> 32;
+    return result;
+  }
+
+ private:
+  std::uint64_t seed_;
+  std::uint64_t lanes_[4];
+  std::uint64_t pending_[4] = {0, 0, 0, 0};
+  int pendingCount_ = 0;
+  std::uint64_t total_ = 0;
+};
+
+struct Key {
+  S21CachedOperation operation;
+  std::uint64_t hash;
+  int rows;
+  int cols;
+
+  bool operator==(const Key& other) const noexcept {
+    return operation == other.operation && hash == other.hash &&
+           rows == other.rows && cols == other.cols;
+  }
+};
+
+struct KeyHash {
+  std::size_t operator()(const Key& key) const noexcept {
+    return static_cast<std::size_t>(key.hash) ^
+           static_cast<std::size_t>(key.operation);
+  }
+};
+
+// the matrices are shared, so a hit is checked and copied out after the
+// shard is unlocked
+struct Entry {
+  Key key;
+  std::shared_ptr<const S21Matrix> operand;
+  std::shared_ptr<const S21Matrix> matrix;
+  double value;
+  std::size_t bytes;
+};
+
+// the entries in recency order, the most recent first
+struct alignas(64) Shard {
+  std::mutex mutex;
+  std::list<Entry> entries;
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+  std::size_t bytes = 0;
+};
+
+Shard shards[kShardsCount];
+
+std::atomic<std::uint64_t> hits{0};
+std::atomic<std::uint64_t> misses{0};
+std::atomic<std::uint64_t> insertions{0};
+std::atomic<std::uint64_t> evictions{0};
+
+// the low bits pick the bucket of the shard's index, the shard comes from
+// the high ones
+Shard& ShardOf(std::uint64_t hash) noexcept {
+  return shards[(hash >> 60) % kShardsCount];
+}
+
+Key MakeKey(S21CachedOperation operation, const S21Matrix& operand) {
+  return {operation, operand.ContentHash(), operand.GetRowsCount(),
+          operand.GetColsCount()};
+}
+
+std::size_t ElementsBytes(const S21Matrix& matrix) noexcept {
+  return static_cast<std::size_t>(matrix.GetRowsCount()) *
+         static_cast<std::size_t>(matrix.GetColsCount()) * sizeof(double);
+}
+
+// the stored operand never shares the elements of a copy-on-write one: a
+// hit is confirmed against it, whatever the caller writes later
+std::shared_ptr<S21Matrix> PrivateCopy(const S21Matrix& matrix) {
+  auto result = std::make_shared<S21Matrix>(matrix);
+  result->SetCopyOnWrite(false);
+  return result;
+}
+
+bool SameElements(const S21Matrix& a, const S21Matrix& b) noexcept {
+  bool result = a.IsEqualSize(b);
+
+  for (int i = 0; i < a.GetRowsCount() && result; i++) {
+    result = std::memcmp(a.RowPtr(i), b.RowPtr(i),
+                         sizeof(double) * a.GetColsCount()) == 0;
+  }
+  return result;
+}
+
+// drops the least recently used entries past budget, they are handed to
+// dropped to be freed after the shard is unlocked
+void Trim(Shard* shard, std::size_t budget, std::vector<Entry>* dropped) {
+  while (shard->bytes > budget && !shard->entries.empty()) {
+    Entry& last = shard->entries.back();
+    shard->bytes -= last.bytes;
+    shard->index.erase(last.key);
+    dropped->push_back(std::move(last));
+    shard->entries.pop_back();
+    evictions.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+// the entry of key moved to the front, nullptr when missing
+const Entry* Touch(Shard* shard, const Key& key) {
+  const Entry* result = nullptr;
+  auto found = shard->index.find(key);
+
+  if (found != shard->index.end()) {
+    shard->entries.splice(shard->entries.begin(), shard->entries,
+                          found->second);
+    result = &*found->second;
+  }
+  return result;
+}
+
+bool Find(const Key& key, const S21Matrix& operand, Entry* result) {
+  Shard& shard = ShardOf(key.hash);
+  bool hit = false;
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const Entry* entry = Touch(&shard, key);
+    if (entry != nullptr) {
+      *result = *entry;
+      hit = true;
+    }
+  }
+
+  hit = hit && SameElements(*result->operand, operand);
+  (hit ? hits : misses).fetch_add(1, std::memory_order_relaxed);
+  return hit;
+}
+
+std::size_t ShardBudget() noexcept {
+  return S21MatrixCache::GetBudget() / kShardsCount;
+}
+
+// another thread may have stored the same result meanwhile, the first one
+// stays
+void Store(Entry entry) {
+  std::vector<Entry> dropped;
+  Shard& shard = ShardOf(entry.key.hash);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+
+  if (Touch(&shard, entry.key) == nullptr) {
+    shard.bytes += entry.bytes;
+    shard.entries.push_front(std::move(entry));
+    shard.index.emplace(shard.entries.front().key, shard.entries.begin());
+    insertions.fetch_add(1, std::memory_order_relaxed);
+    Trim(&shard, ShardBudget(), &dropped);
+  }
+}
+
+bool BudgetFromEnvironment() {
+  const char* variable = std::getenv("S21_MATRIX_CACHE_BYTES");
+  if (variable != nullptr && std::atoll(variable) > 0) {
+    S21MatrixCache::SetBudget(static_cast<std::size_t>(std::atoll(variable)));
+  }
+  return true;
+}
+
+const bool kEnvironmentChecked = BudgetFromEnvironment();
+
+}  // namespace
+
+// XXH64 of the elements in row-major order, seeded with the shape. the hash
+// is kept until the next write (PrepareWrite clears it), 0 stands for not
+// computed, so a real 0 is mapped to 1
+std::uint64_t S21Matrix::ContentHash() const {
+  std::uint64_t result = __atomic_load_n(&hash_, __ATOMIC_RELAXED);
+
+  if (result == 0) {
+    Xxh64 hash((static_cast<std::uint64_t>(rows_) << 32) |
+               static_cast<std::uint32_t>(cols_));
+    for (int i = 0; i < rows_ && matrix_ != nullptr; i++) {
+      hash.Update(matrix_[i], cols_);
+    }
+    result = std::max<std::uint64_t>(hash.Digest(), 1);
+    __atomic_store_n(&hash_, result, __ATOMIC_RELAXED);
+  }
+  return result;
+}
+
+void S21MatrixCache::SetBudget(std::size_t bytes) {
+  budget_.store(bytes, std::memory_order_relaxed);
+
+  for (Shard& shard : shards) {
+    std::vector<Entry> dropped;
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Trim(&shard, bytes / kShardsCount, &dropped);
+  }
+}
+
+std::size_t S21MatrixCache::GetBudget() noexcept {
+  return budget_.load(std::memory_order_relaxed);
+}
+
+void S21MatrixCache::Clear() {
+  for (Shard& shard : shards) {
+    std::list<Entry> entries;
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.index.clear();
+    shard.entries.swap(entries);
+    shard.bytes = 0;
+  }
+}
+
+S21CacheStats S21MatrixCache::GetStats() {
+  S21CacheStats result = {hits.load(std::memory_order_relaxed),
+                          misses.load(std::memory_order_relaxed),
+                          insertions.load(std::memory_order_relaxed),
+                          evictions.load(std::memory_order_relaxed),
+                          0,
+                          0};
+
+  for (Shard& shard : shards) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    result.entries += shard.entries.size();
+    result.bytes += shard.bytes;
+  }
+  return result;
+}
+
+void S21MatrixCache::ResetStats() noexcept {
+  hits.store(0, std::memory_order_relaxed);
+  misses.store(0, std::memory_order_relaxed);
+  insertions.store(0, std::memory_order_relaxed);
+  evictions.store(0, std::memory_order_relaxed);
+}
+
+bool S21MatrixCache::FindValue(S21CachedOperation operation,
+                               const S21Matrix& operand, double* value) {
+  Entry entry;
+  bool result = Find(MakeKey(operation, operand), operand, &entry);
+
+  if (result) *value = entry.value;
+  return result;
+}
+
+std::shared_ptr<const S21Matrix> S21MatrixCache::FindMatrix(
+    S21CachedOperation operation, const S21Matrix& operand) {
+  Entry entry;
+  bool found = Find(MakeKey(operation, operand), operand, &entry);
+
+  return found ? entry.matrix : nullptr;
+}
+
+// an entry over the shard budget isn't copied at all
+void S21MatrixCache::StoreValue(S21CachedOperation operation,
+                                const S21Matrix& operand, double value) {
+  std::size_t bytes = kEntryOverhead + ElementsBytes(operand);
+
+  if (bytes <= ShardBudget()) {
+    Store({MakeKey(operation, operand), PrivateCopy(operand), nullptr, value,
+           bytes});
+  }
+}
+
+void S21MatrixCache::StoreMatrix(S21CachedOperation operation,
+                                 const S21Matrix& operand,
+                                 const S21Matrix& value) {
+  std::size_t bytes =
+      kEntryOverhead + ElementsBytes(operand) + ElementsBytes(value);
+
+  if (bytes <= ShardBudget()) {
+    Store({MakeKey(operation, operand), PrivateCopy(operand),
+           std::make_shared<S21Matrix>(value), 0.0, bytes});
+  }
+}
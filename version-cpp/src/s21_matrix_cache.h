@@ -0,0 +1,67 @@
+#ifndef SRC_S21_MATRIX_CACHE_H_
+#define SRC_S21_MATRIX_CACHE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+class S21Matrix;
+
+// memoized results of the expensive operations, keyed by the content of the
+// operand: its shape and the XXH64 hash of its elements, which a matrix
+// keeps until its next write (S21Matrix::ContentHash). a hit is confirmed
+// against a stored copy of the operand, so a hash collision never returns a
+// wrong result. off by default: SetBudget(bytes) or the
+// S21_MATRIX_CACHE_BYTES environment variable turns it on, the least
+// recently used entries are evicted past the budget. the entries are split
+// over shards with a lock each, each shard holds a share of the budget, so
+// an entry bigger than that share is never kept
+
+enum class S21CachedOperation {
+  kDeterminant,
+  kCalcComplements,
+  kInverseMatrix
+};
+
+struct S21CacheStats {
+  std::uint64_t hits;
+  std::uint64_t misses;
+  std::uint64_t insertions;
+  std::uint64_t evictions;
+  std::size_t entries;
+  std::size_t bytes;
+};
+
+class S21MatrixCache {
+ public:
+  // below this size computing is cheaper than hashing and locking
+  static constexpr int kMinSize = 4;
+
+  static bool IsEnabled() noexcept {
+    return budget_.load(std::memory_order_relaxed) != 0;
+  }
+  // 0 turns the cache off and drops the entries
+  static void SetBudget(std::size_t bytes);
+  static std::size_t GetBudget() noexcept;
+  static void Clear();
+
+  static S21CacheStats GetStats();
+  static void ResetStats() noexcept;
+
+  // used by S21Matrix, the Find functions count the hits and misses.
+  // FindMatrix returns nullptr on a miss
+  static bool FindValue(S21CachedOperation operation, const S21Matrix& operand,
+                        double* value);
+  static std::shared_ptr<const S21Matrix> FindMatrix(
+      S21CachedOperation operation, const S21Matrix& operand);
+  static void StoreValue(S21CachedOperation operation,
+                         const S21Matrix& operand, double value);
+  static void StoreMatrix(S21CachedOperation operation,
+                          const S21Matrix& operand, const S21Matrix& value);
+
+ private:
+  inline static std::atomic<std::size_t> budget_{0};
+};
+
+#endif  // SRC_S21_MATRIX_CACHE_H_
@@ -0,0 +1,427 @@
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+#include "s21_matrix_stats.h"
+#include "s21_parallel.h"
+
+namespace {
+
+// text smaller than this is parsed by the calling thread alone
+constexpr std::size_t kMinChunkBytes = 1 << 20;
+constexpr std::size_t kMaxValueChars = 32;
+
+struct TextChunk {
+  const char* begin;
+  const char* end;
+  std::size_t firstLine;
+  std::size_t linesCount;
+};
+
+struct MarketHeader {
+  bool coordinate;
+  bool pattern;
+  bool symmetric;
+  bool skew;
+};
+
+std::string ReadFile(const std::string& path, const std::string& where) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file)
+    throw std::runtime_error(where + ": unable to open file exception");
+
+  std::string text(static_cast<std::size_t>(file.tellg()), '\0');
+  file.seekg(0);
+  file.read(text.data(), static_cast<std::streamsize>(text.size()));
+
+  if (!file)
+    throw std::runtime_error(where + ": unable to read file exception");
+  return text;
+}
+
+void WriteFile(const std::string& path, const std::vector<std::string>& parts,
+               const std::string& where) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file)
+    throw std::runtime_error(where + ": unable to open file exception");
+
+  for (const std::string& part : parts) {
+    file.write(part.data(), static_cast<std::streamsize>(part.size()));
+  }
+
+  if (!file)
+    throw std::runtime_error(where + ": unable to write file exception");
+}
+
+// callers never pass pos past end, the check is for the compiler: without
+// it a profile-guided build can't bound end - pos and warns on memchr
+const char* LineEnd(const char* pos, const char* end) {
+  if (pos >= end) return end;
+
+  const char* found =
+      static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+  return found ? found : end;
+}
+
+bool IsBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+const char* SkipBlanks(const char* pos, const char* end) {
+  while (pos < end && IsBlank(*pos)) pos++;
+  return pos;
+}
+
+bool IsCsvDataLine(const char* begin, const char* end) {
+  return SkipBlanks(begin, end) != end;
+}
+
+bool IsMarketDataLine(const char* begin, const char* end) {
+  const char* pos = SkipBlanks(begin, end);
+  return pos != end && *pos != '%';
+}
+
+// splits [begin, end) into line-aligned chunks and counts the data lines in
+// each of them, so every chunk knows the index of its first data line
+std::vector<TextChunk> SplitLines(const char* begin, const char* end,
+                                  bool (*isDataLine)(const char*,
+                                                     const char*)) {
+  S21ThreadPool& pool = S21ThreadPool::GetInstance();
+  std::size_t size = static_cast<std::size_t>(end - begin);
+  std::size_t chunksCount = std::max<std::size_t>(
+      1, std::min(size / kMinChunkBytes, pool.GetThreadsCount() * 4));
+
+  std::vector<TextChunk> chunks;
+  const char* chunkBegin = begin;
+  for (std::size_t i = 1; i <= chunksCount && chunkBegin < end; i++) {
+    const char* chunkEnd = end;
+    if (i < chunksCount) {
+      chunkEnd = std::max(chunkBegin, begin + size / chunksCount * i);
+      chunkEnd = std::min(end, LineEnd(chunkEnd, end) + 1);
+    }
+    chunks.push_back({chunkBegin, chunkEnd, 0, 0});
+    chunkBegin = chunkEnd;
+  }
+  if (chunks.empty()) chunks.push_back({end, end, 0, 0});
+
+  pool.ParallelFor(chunks.size(), [&chunks, isDataLine](std::size_t index) {
+    TextChunk& chunk = chunks[index];
+    for (const char* pos = chunk.begin; pos < chunk.end;) {
+      const char* lineEnd = LineEnd(pos, chunk.end);
+      if (isDataLine(pos, lineEnd)) chunk.linesCount++;
+      pos = lineEnd + 1;
+    }
+  });
+
+  for (std::size_t i = 1; i < chunks.size(); i++) {
+    chunks[i].firstLine = chunks[i - 1].firstLine + chunks[i - 1].linesCount;
+  }
+  return chunks;
+}
+
+// calls callback(lineIndex, lineBegin, lineEnd) for every data line of every
+// chunk, chunks are processed in parallel
+template <typename Callback>
+void ForEachDataLine(const std::vector<TextChunk>& chunks,
+                     bool (*isDataLine)(const char*, const char*),
+                     const Callback& callback) {
+  S21ThreadPool::GetInstance().ParallelFor(
+      chunks.size(), [&chunks, isDataLine, &callback](std::size_t index) {
+        const TextChunk& chunk = chunks[index];
+        std::size_t line = chunk.firstLine;
+
+        for (const char* pos = chunk.begin; pos < chunk.end;) {
+          const char* lineEnd = LineEnd(pos, chunk.end);
+          if (isDataLine(pos, lineEnd)) callback(line++, pos, lineEnd);
+          pos = lineEnd + 1;
+        }
+      });
+}
+
+const char* ParseValue(const char* pos, const char* end, double* value) {
+  pos = SkipBlanks(pos, end);
+  if (pos < end && *pos == '+') pos++;
+
+  std::from_chars_result parsed = std::from_chars(pos, end, *value);
+  return parsed.ec == std::errc() ? parsed.ptr : nullptr;
+}
+
+const char* ParseIndex(const char* pos, const char* end, long long* value) {
+  pos = SkipBlanks(pos, end);
+
+  std::from_chars_result parsed = std::from_chars(pos, end, *value);
+  return parsed.ec == std::errc() ? parsed.ptr : nullptr;
+}
+
+void AppendValue(std::string* out, double value) {
+  char buffer[kMaxValueChars];
+  std::to_chars_result written =
+      std::to_chars(buffer, buffer + kMaxValueChars, value);
+  out->append(buffer, written.ptr);
+}
+
+// formats items [0, count) into consecutive strings in parallel, keeping
+// their order for the final write
+template <typename Formatter>
+std::vector<std::string> FormatParallel(std::size_t count,
+                                        std::size_t valuesPerItem,
+                                        const Formatter& formatter) {
+  S21ThreadPool& pool = S21ThreadPool::GetInstance();
+  std::size_t bytes = count * valuesPerItem * kMaxValueChars;
+  std::size_t partsCount = std::max<std::size_t>(
+      1, std::min({count, bytes / kMinChunkBytes, pool.GetThreadsCount() * 4}));
+
+  std::vector<std::string> parts(partsCount);
+  pool.ParallelFor(partsCount, [&](std::size_t part) {
+    std::size_t first = count * part / partsCount;
+    std::size_t last = count * (part + 1) / partsCount;
+
+    parts[part].reserve((last - first) * valuesPerItem * 8);
+    for (std::size_t i = first; i < last; i++) {
+      formatter(&parts[part], i);
+    }
+  });
+  return parts;
+}
+
+std::string ToLower(std::string value) {
+  std::transform(value.begin(), value.end(), value.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return value;
+}
+
+MarketHeader ParseMarketHeader(const char* begin, const char* end) {
+  const std::string where = "S21Matrix::FromMatrixMarket";
+  std::istringstream line(std::string(begin, end));
+  std::string banner, object, format, field, symmetry;
+  line >> banner >> object >> format >> field >> symmetry;
+
+  if (banner != "%%MatrixMarket" || ToLower(object) != "matrix")
+    throw std::invalid_argument(where + ": invalid header exception");
+
+  format = ToLower(format);
+  field = ToLower(field);
+  symmetry = ToLower(symmetry);
+
+  if (format != "array" && format != "coordinate")
+    throw std::invalid_argument(where + ": unsupported format exception");
+
+  if (field != "real" && field != "double" && field != "integer" &&
+      (field != "pattern" || format != "coordinate"))
+    throw std::invalid_argument(where + ": unsupported field exception");
+
+  if (symmetry != "general" && symmetry != "symmetric" &&
+      symmetry != "skew-symmetric")
+    throw std::invalid_argument(where + ": unsupported symmetry exception");
+
+  return {format == "coordinate", field == "pattern", symmetry == "symmetric",
+          symmetry == "skew-symmetric"};
+}
+
+// position of the index-th stored value of an array file: values go column
+// by column, symmetric files keep only the lower triangle (skew ones without
+// the diagonal), so the column is found by a binary search over the column
+// start offsets
+void MarketArrayPosition(std::size_t index, int rows,
+                         const MarketHeader& header, int* row, int* col) {
+  if (!header.symmetric && !header.skew) {
+    *row = static_cast<int>(index % rows);
+    *col = static_cast<int>(index / rows);
+  } else {
+    long long offset = header.skew ? 1 : 0;
+    long long size = rows - offset;
+    long long position = static_cast<long long>(index);
+    long long low = 0;
+    long long high = size - 1;
+
+    while (low < high) {
+      long long middle = (low + high + 1) / 2;
+      if (middle * size - middle * (middle - 1) / 2 <= position) {
+        low = middle;
+      } else {
+        high = middle - 1;
+      }
+    }
+    position -= low * size - low * (low - 1) / 2;
+    *row = static_cast<int>(low + offset + position);
+    *col = static_cast<int>(low);
+  }
+}
+
+}  // namespace
+
+// public functions (import, export)
+
+S21Matrix S21Matrix::FromCsv(const std::string& path, char delimiter) {
+  S21OperationTimer timer(S21Operation::kImport);
+  const std::string where = "S21Matrix::FromCsv";
+  if (IsBlank(delimiter) || delimiter == '\n')
+    throw std::invalid_argument(where + ": invalid delimiter exception");
+
+  std::string text = ReadFile(path, where);
+  const char* begin = text.data();
+  const char* end = begin + text.size();
+
+  std::vector<TextChunk> chunks = SplitLines(begin, end, IsCsvDataLine);
+  std::size_t rows = chunks.back().firstLine + chunks.back().linesCount;
+  if (rows == 0) throw std::invalid_argument(where + ": empty file exception");
+
+  const char* firstLine = begin;
+  while (!IsCsvDataLine(firstLine, LineEnd(firstLine, end))) {
+    firstLine = LineEnd(firstLine, end) + 1;
+  }
+  const char* firstLineEnd = LineEnd(firstLine, end);
+  int cols = 1 + static_cast<int>(
+                     std::count(firstLine, firstLineEnd, delimiter));
+
+  S21Matrix result(static_cast<int>(rows), cols, S21Matrix::uninit);
+
+  ForEachDataLine(chunks, IsCsvDataLine, [&](std::size_t line, const char* pos,
+                                             const char* lineEnd) {
+    double* row = result.matrix_[line];
+
+    for (int j = 0; j < cols; j++) {
+      pos = ParseValue(pos, lineEnd, &row[j]);
+      if (!pos)
+        throw std::invalid_argument(where + ": malformed value exception");
+
+      pos = SkipBlanks(pos, lineEnd);
+      if (j + 1 < cols) {
+        if (pos == lineEnd || *pos != delimiter)
+          throw std::invalid_argument(where +
+                                      ": inconsistent row length exception");
+        pos++;
+      }
+    }
+
+    if (pos != lineEnd)
+      throw std::invalid_argument(where +
+                                  ": inconsistent row length exception");
+  });
+  return result;
+}
+
+void S21Matrix::ToCsv(const std::string& path, char delimiter) const {
+  S21OperationTimer timer(S21Operation::kExport);
+
+  if (IsNullOrEmpty())
+    throw std::invalid_argument("S21Matrix::ToCsv: null matrix exception");
+
+  if (IsBlank(delimiter) || delimiter == '\n')
+    throw std::invalid_argument(
+        "S21Matrix::ToCsv: invalid delimiter exception");
+
+  std::vector<std::string> parts = FormatParallel(
+      static_cast<std::size_t>(rows_), static_cast<std::size_t>(cols_),
+      [this, delimiter](std::string* out, std::size_t i) {
+        for (int j = 0; j < cols_; j++) {
+          if (j > 0) out->push_back(delimiter);
+          AppendValue(out, matrix_[i][j]);
+        }
+        out->push_back('\n');
+      });
+  WriteFile(path, parts, "S21Matrix::ToCsv");
+}
+
+S21Matrix S21Matrix::FromMatrixMarket(const std::string& path) {
+  S21OperationTimer timer(S21Operation::kImport);
+  const std::string where = "S21Matrix::FromMatrixMarket";
+  std::string text = ReadFile(path, where);
+  const char* pos = text.data();
+  const char* end = pos + text.size();
+
+  MarketHeader header = ParseMarketHeader(pos, LineEnd(pos, end));
+  pos = std::min(end, LineEnd(pos, end) + 1);
+  while (pos < end && !IsMarketDataLine(pos, LineEnd(pos, end))) {
+    pos = std::min(end, LineEnd(pos, end) + 1);
+  }
+
+  long long rows = 0, cols = 0, entries = 0;
+  const char* sizeEnd = LineEnd(pos, end);
+  const char* parsed = ParseIndex(pos, sizeEnd, &rows);
+  if (parsed) parsed = ParseIndex(parsed, sizeEnd, &cols);
+  if (parsed && header.coordinate)
+    parsed = ParseIndex(parsed, sizeEnd, &entries);
+
+  if (!parsed || SkipBlanks(parsed, sizeEnd) != sizeEnd || rows < 1 ||
+      cols < 1 || rows > std::numeric_limits<int>::max() ||
+      cols > std::numeric_limits<int>::max() || entries < 0)
+    throw std::invalid_argument(where + ": invalid size line exception");
+
+  if ((header.symmetric || header.skew) && rows != cols)
+    throw std::invalid_argument(where + ": matrix is not square exception");
+
+  if (!header.coordinate) {
+    entries = rows * cols;
+    if (header.symmetric) entries = rows * (rows + 1) / 2;
+    if (header.skew) entries = rows * (rows - 1) / 2;
+  }
+
+  pos = std::min(end, sizeEnd + 1);
+  std::vector<TextChunk> chunks = SplitLines(pos, end, IsMarketDataLine);
+
+  if (chunks.back().firstLine + chunks.back().linesCount !=
+      static_cast<std::size_t>(entries))
+    throw std::invalid_argument(where + ": wrong number of entries exception");
+
+  S21Matrix result(static_cast<int>(rows), static_cast<int>(cols));
+
+  ForEachDataLine(chunks, IsMarketDataLine, [&](std::size_t line,
+                                                const char* linePos,
+                                                const char* lineEnd) {
+    long long i = 0, j = 0;
+    double value = 1.0;
+
+    if (header.coordinate) {
+      linePos = ParseIndex(linePos, lineEnd, &i);
+      if (linePos) linePos = ParseIndex(linePos, lineEnd, &j);
+      if (!linePos || i < 1 || i > rows || j < 1 || j > cols)
+        throw std::invalid_argument(where + ": index out of range exception");
+      i--;
+      j--;
+    } else {
+      int row = 0, col = 0;
+      MarketArrayPosition(line, static_cast<int>(rows), header, &row, &col);
+      i = row;
+      j = col;
+    }
+
+    if (!header.pattern) linePos = ParseValue(linePos, lineEnd, &value);
+    if (!linePos || SkipBlanks(linePos, lineEnd) != lineEnd)
+      throw std::invalid_argument(where + ": malformed value exception");
+
+    result.matrix_[i][j] = value;
+    if (header.symmetric) result.matrix_[j][i] = value;
+    if (header.skew) result.matrix_[j][i] = -value;
+  });
+  return result;
+}
+
+void S21Matrix::ToMatrixMarket(const std::string& path) const {
+  S21OperationTimer timer(S21Operation::kExport);
+
+  if (IsNullOrEmpty())
+    throw std::invalid_argument(
+        "S21Matrix::ToMatrixMarket: null matrix exception");
+
+  std::vector<std::string> parts = FormatParallel(
+      static_cast<std::size_t>(cols_), static_cast<std::size_t>(rows_),
+      [this](std::string* out, std::size_t j) {
+        for (int i = 0; i < rows_; i++) {
+          AppendValue(out, matrix_[i][j]);
+          out->push_back('\n');
+        }
+      });
+
+  std::string header = "%%MatrixMarket matrix array real general\n" +
+                       std::to_string(rows_) + " " + std::to_string(cols_) +
+                       "\n";
+  parts.insert(parts.begin(), header);
+  WriteFile(path, parts, "S21Matrix::ToMatrixMarket");
+}
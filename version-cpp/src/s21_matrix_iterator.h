@@ -0,0 +1,137 @@
+#ifndef SRC_S21_MATRIX_ITERATOR_H_
+#define SRC_S21_MATRIX_ITERATOR_H_
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+// random access iterator over the elements of a matrix in row-major order,
+// on top of its row pointer table (the rows aren't contiguous with each
+// other). Value is double or const double. stepping is an increment and a
+// compare, jumps divide by the row length
+template <class Value>
+class S21MatrixIterator {
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::remove_const_t<Value>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = Value*;
+  using reference = Value&;
+
+  S21MatrixIterator() noexcept = default;
+  S21MatrixIterator(double* const* rows, int cols, int row, int col) noexcept
+      : rows_(rows), cols_(cols), row_(row), col_(col) {}
+
+  // iterator to const_iterator
+  template <class Other,
+            class = std::enable_if_t<std::is_const_v<Value> &&
+                                     !std::is_const_v<Other>>>
+  S21MatrixIterator(const S21MatrixIterator<Other>& other) noexcept
+      : rows_(other.rows_),
+        cols_(other.cols_),
+        row_(other.row_),
+        col_(other.col_) {}
+
+  reference operator*() const noexcept { return rows_[row_][col_]; }
+  pointer operator->() const noexcept { return &rows_[row_][col_]; }
+  reference operator[](difference_type n) const noexcept {
+    return *(*this + n);
+  }
+
+  S21MatrixIterator& operator++() noexcept {
+    if (++col_ == cols_) {
+      col_ = 0;
+      row_++;
+    }
+    return *this;
+  }
+  S21MatrixIterator operator++(int) noexcept {
+    S21MatrixIterator result = *this;
+    ++*this;
+    return result;
+  }
+  S21MatrixIterator& operator--() noexcept {
+    if (col_-- == 0) {
+      col_ = cols_ - 1;
+      row_--;
+    }
+    return *this;
+  }
+  S21MatrixIterator operator--(int) noexcept {
+    S21MatrixIterator result = *this;
+    --*this;
+    return result;
+  }
+
+  S21MatrixIterator& operator+=(difference_type n) noexcept {
+    difference_type index = Index() + n;
+    row_ = static_cast<int>(index / cols_);
+    col_ = static_cast<int>(index % cols_);
+    return *this;
+  }
+  S21MatrixIterator& operator-=(difference_type n) noexcept {
+    return *this += -n;
+  }
+  S21MatrixIterator operator+(difference_type n) const noexcept {
+    S21MatrixIterator result = *this;
+    return result += n;
+  }
+  S21MatrixIterator operator-(difference_type n) const noexcept {
+    S21MatrixIterator result = *this;
+    return result += -n;
+  }
+  friend S21MatrixIterator operator+(difference_type n,
+                                     const S21MatrixIterator& it) noexcept {
+    return it + n;
+  }
+
+  // iterators and const_iterators compare and subtract with each other
+  template <class Other>
+  difference_type operator-(
+      const S21MatrixIterator<Other>& other) const noexcept {
+    return Index() - other.Index();
+  }
+
+  template <class Other>
+  bool operator==(const S21MatrixIterator<Other>& other) const noexcept {
+    return row_ == other.row_ && col_ == other.col_;
+  }
+  template <class Other>
+  bool operator!=(const S21MatrixIterator<Other>& other) const noexcept {
+    return !(*this == other);
+  }
+  template <class Other>
+  bool operator<(const S21MatrixIterator<Other>& other) const noexcept {
+    return Index() < other.Index();
+  }
+  template <class Other>
+  bool operator>(const S21MatrixIterator<Other>& other) const noexcept {
+    return other < *this;
+  }
+  template <class Other>
+  bool operator<=(const S21MatrixIterator<Other>& other) const noexcept {
+    return !(other < *this);
+  }
+  template <class Other>
+  bool operator>=(const S21MatrixIterator<Other>& other) const noexcept {
+    return !(*this < other);
+  }
+
+  int GetRow() const noexcept { return row_; }
+  int GetCol() const noexcept { return col_; }
+
+ private:
+  template <class Other>
+  friend class S21MatrixIterator;
+
+  difference_type Index() const noexcept {
+    return static_cast<difference_type>(row_) * cols_ + col_;
+  }
+
+  double* const* rows_ = nullptr;
+  int cols_ = 1;
+  int row_ = 0;
+  int col_ = 0;
+};
+
+#endif  // SRC_S21_MATRIX_ITERATOR_H_
@@ -1,23 +1,207 @@
 #include "s21_matrix_oop.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "s21_allocator.h"
+#include "s21_matrix_cache.h"
+#include "s21_matrix_stats.h"
+#include "s21_parallel.h"
+
+namespace {
+
+// flops of the cofactor expansion in Determinant: every one of the n minors
+// costs its own expansion, then a multiply by the element, by the sign and
+// an add
+double DeterminantFlops(int size) {
+  double result = 0;
+  if (size >= 2) result = 3;
+  for (int n = 3; n <= size; n++) result = n * (result + 3);
+  return result;
+}
+
+double ComplementsFlops(int size) {
+  return 1.0 * size * size * (DeterminantFlops(size - 1) + 1);
+}
+
+struct Tolerance {
+  double absolute;
+  double relative;
+  std::uint64_t ulps;
+};
+
+// doubles mapped to unsigned integers in the same order, adjacent doubles
+// differ by one
+std::uint64_t OrderedBits(double value) noexcept {
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits >> 63 ? ~bits : bits | 0x8000000000000000ull;
+}
+
+// exact test: NaN is never close, equal infinities are
+bool Close(double a, double b, const Tolerance& tolerance) noexcept {
+  double difference = fabs(a - b);
+  std::uint64_t x = OrderedBits(a);
+  std::uint64_t y = OrderedBits(b);
+  std::uint64_t distance = x > y ? x - y : y - x;
+
+  return a == b || difference <= tolerance.absolute ||
+         difference <= tolerance.relative * std::max(fabs(a), fabs(b)) ||
+         (difference == difference && distance <= tolerance.ulps);
+}
+
+// the first column of [0, size) that isn't close, or size. a tight
+// early-exit loop checks the absolute and relative bounds only (a compare
+// and a well predicted branch per element, a loop newer compilers
+// vectorize), the element it stops at is rechecked exactly, which also
+// covers the ULP bound, and the scan resumes after it if it's close after all
+template <bool kRelative>
+bool WithinBound(double a, double b, const Tolerance& tolerance) noexcept {
+  double bound = tolerance.absolute;
+  if (kRelative) {
+    bound = std::max(bound, tolerance.relative * std::max(fabs(a), fabs(b)));
+  }
+  return fabs(a - b) <= bound;
+}
+
+template <bool kRelative>
+int RowMismatch(const double* a, const double* b, int size,
+                const Tolerance& tolerance) noexcept {
+  int result = size;
+
+  for (int j = 0; j < size && result == size; j++) {
+    while (j < size && WithinBound<kRelative>(a[j], b[j], tolerance)) j++;
+    if (j < size && !Close(a[j], b[j], tolerance)) result = j;
+  }
+  return result;
+}
+
+int RowMismatch(const double* a, const double* b, int size,
+                const Tolerance& tolerance) noexcept {
+  return tolerance.relative > 0 ? RowMismatch<true>(a, b, size, tolerance)
+                                : RowMismatch<false>(a, b, size, tolerance);
+}
+
+// row-major index of the first element that isn't close, or -1
+long long FirstMismatch(double* const* a, double* const* b, int rows,
+                        int cols, const Tolerance& tolerance) noexcept {
+  long long result = -1;
+
+  for (int i = 0; i < rows && result < 0; i++) {
+    int j = RowMismatch(a[i], b[i], cols, tolerance);
+    if (j < cols) result = static_cast<long long>(i) * cols + j;
+  }
+  return result;
+}
+
+// the same scan split over row blocks on the thread pool: a block stops as
+// soon as an earlier mismatch is known, so the result doesn't depend on the
+// scheduling
+constexpr int kMismatchRowsBlock = 16;
+
+long long ParallelFirstMismatch(double* const* a, double* const* b, int rows,
+                                int cols, const Tolerance& tolerance) {
+  long long none = static_cast<long long>(rows) * cols;
+  std::atomic<long long> best(none);
+  std::size_t blocks = static_cast<std::size_t>(
+      (rows + kMismatchRowsBlock - 1) / kMismatchRowsBlock);
+
+  S21ThreadPool::GetInstance().ParallelFor(blocks, [&](std::size_t block) {
+    int end = std::min(rows, static_cast<int>(block + 1) * kMismatchRowsBlock);
+
+    for (int i = static_cast<int>(block) * kMismatchRowsBlock; i < end; i++) {
+      long long rowStart = static_cast<long long>(i) * cols;
+      if (rowStart >= best.load(std::memory_order_relaxed)) break;
+
+      int j = RowMismatch(a[i], b[i], cols, tolerance);
+      if (j < cols) {
+        long long current = best.load(std::memory_order_relaxed);
+        while (rowStart + j < current &&
+               !best.compare_exchange_weak(current, rowStart + j,
+                                           std::memory_order_relaxed)) {
+        }
+        break;
+      }
+    }
+  });
+  return best.load() < none ? best.load() : -1;
+}
+
+// Apply, Map and Zip go parallel from this many elements, in blocks of rows
+constexpr double kParallelMapSize = 1 << 16;
+constexpr int kMapRowsBlock = 16;
+
+// FindMismatch goes parallel from this many elements
+constexpr double kParallelMismatchSize = 1 << 20;
+
+// the cofactor expansion forks its minors as tasks from this size, smaller
+// ones cost less than a task, CalcComplements forks its elements
+constexpr int kParallelDeterminantSize = 7;
+constexpr int kParallelComplementsSize = 5;
+
+long long Mismatch(double* const* a, double* const* b, int rows, int cols,
+                   const Tolerance& tolerance, bool parallel) {
+  return parallel && static_cast<double>(rows) * cols >= kParallelMismatchSize
+             ? ParallelFirstMismatch(a, b, rows, cols, tolerance)
+             : FirstMismatch(a, b, rows, cols, tolerance);
+}
+
+// the cache only pays off from S21MatrixCache::kMinSize
+bool UsesCache(const S21Matrix& matrix) noexcept {
+  return matrix.GetRowsCount() >= S21MatrixCache::kMinSize &&
+         S21MatrixCache::IsEnabled();
+}
+
+Tolerance MakeTolerance(const char* method, double absTol, double relTol,
+                        std::int64_t maxUlps) {
+  if (!(absTol >= 0) || !(relTol >= 0) || maxUlps < 0)
+    throw std::invalid_argument(std::string("S21Matrix::") + method +
+                                ": negative tolerance exception");
+
+  return {absTol, relTol, static_cast<std::uint64_t>(maxUlps)};
+}
+
+}  // namespace
+
 // constructors, destructor
 
 S21Matrix::S21Matrix() noexcept { InitMatrix(); }
 
 S21Matrix::S21Matrix(int rows, int cols) {
-  CreateMatrix(rows, cols);
-  SetMatrix(0.0f);
+  S21OperationTimer timer(S21Operation::kCreate);
+  CreateMatrix(rows, cols, true);
+}
+
+S21Matrix::S21Matrix(int rows, int cols, Uninitialized) {
+  S21OperationTimer timer(S21Operation::kCreate);
+  CreateMatrix(rows, cols, false);
 }
 
+// a copy of a copy-on-write matrix shares its elements, any other copy is
+// deep and copies the rows straight into uninitialized storage
 S21Matrix::S21Matrix(const S21Matrix& other) {
-  CreateMatrix(other.cols_, other.rows_);
-  SetMatrix(other);
+  S21OperationTimer timer(S21Operation::kCopy);
+  InitMatrix();
+  if (other.refs_ != nullptr) {
+    ShareMatrix(other);
+  } else {
+    CreateMatrix(other.rows_, other.cols_, false);
+    CopyElements(other);
+  }
+  hash_ = __atomic_load_n(&other.hash_, __ATOMIC_RELAXED);
 }
 
 S21Matrix::S21Matrix(S21Matrix&& other) noexcept {
   cols_ = other.cols_;
   rows_ = other.rows_;
   matrix_ = other.matrix_;
+  refs_ = other.refs_;
+  placed_ = other.placed_;
+  hash_ = __atomic_load_n(&other.hash_, __ATOMIC_RELAXED);
   other.InitMatrix();
 }
 
@@ -29,6 +213,7 @@ double& S21Matrix::operator()(int i, int j) {
   if (!Contains(i, j))
     throw std::out_of_range("S21Matrix: index out of range exception");
 
+  PrepareWrite();
   return matrix_[i][j];
 }
 
@@ -48,7 +233,15 @@ bool S21Matrix::operator!=(const S21Matrix& other) const noexcept {
 }
 
 S21Matrix S21Matrix::operator=(const S21Matrix& other) {
-  CopyMatrix(other, other.rows_, other.cols_);
+  S21OperationTimer timer(S21Operation::kCopy);
+  if (this != &other) {
+    if (other.refs_ != nullptr) {
+      ShareMatrix(other);
+    } else {
+      CopyMatrix(other, other.rows_, other.cols_);
+    }
+    hash_ = __atomic_load_n(&other.hash_, __ATOMIC_RELAXED);
+  }
   return *this;
 }
 
@@ -104,26 +297,59 @@ S21Matrix S21Matrix::operator*=(double num) {
 // public functions (lib)
 
 bool S21Matrix::EqMatrix(const S21Matrix& other) const noexcept {
-  bool result = true;
-
-  if (IsEqualSize(other)) {
-    if (!IsNullOrEmpty() && !other.IsNullOrEmpty()) {
-      for (int i = 0; i < rows_; i++) {
-        for (int j = 0; j < cols_; j++) {
-          if (fabs(matrix_[i][j] - other.matrix_[i][j]) > EPS) {
-            result = false;
-            break;
-          }
-        }
-      }
-    }
-  } else {
-    result = false;
+  S21OperationTimer timer(S21Operation::kEqMatrix);
+  bool result = IsEqualSize(other);
+
+  if (result && !IsNullOrEmpty() && !other.IsNullOrEmpty()) {
+    result = Mismatch(matrix_, other.matrix_, rows_, cols_, {EPS, 0.0, 0},
+                      false) < 0;
   }
   return result;
 }
 
+// a and b are close when |a - b| <= absTol, when |a - b| <= relTol times the
+// larger magnitude, or when at most maxUlps doubles lie between them
+bool S21Matrix::ApproxEqual(const S21Matrix& other, double absTol,
+                            double relTol, std::int64_t maxUlps) const {
+  S21OperationTimer timer(S21Operation::kEqMatrix);
+  Tolerance tolerance = MakeTolerance("ApproxEqual", absTol, relTol, maxUlps);
+  bool result = IsEqualSize(other);
+
+  if (result && !IsNullOrEmpty() && !other.IsNullOrEmpty()) {
+    result =
+        Mismatch(matrix_, other.matrix_, rows_, cols_, tolerance, false) < 0;
+  }
+  return result;
+}
+
+// the first element out of tolerance in row-major order, stored in
+// indexRows and indexCols when there is one
+bool S21Matrix::FindMismatch(const S21Matrix& other, int* indexRows,
+                             int* indexCols, double absTol, double relTol,
+                             std::int64_t maxUlps) const {
+  S21OperationTimer timer(S21Operation::kEqMatrix);
+  Tolerance tolerance =
+      MakeTolerance("FindMismatch", absTol, relTol, maxUlps);
+
+  if (!IsEqualSize(other))
+    throw std::invalid_argument(
+        "S21Matrix::FindMismatch: different matrix dimensions exception");
+
+  long long first = -1;
+  if (!IsNullOrEmpty() && !other.IsNullOrEmpty()) {
+    first = Mismatch(matrix_, other.matrix_, rows_, cols_, tolerance, true);
+  }
+
+  if (first >= 0) {
+    if (indexRows != nullptr) *indexRows = static_cast<int>(first / cols_);
+    if (indexCols != nullptr) *indexCols = static_cast<int>(first % cols_);
+  }
+  return first >= 0;
+}
+
 void S21Matrix::SumMatrix(const S21Matrix& other) {
+  S21OperationTimer timer(S21Operation::kSumMatrix);
+
   if (IsNullOrEmpty() || other.IsNullOrEmpty())
     throw std::invalid_argument("S21Matrix::SumMatrix: null matrix exception");
 
@@ -131,14 +357,18 @@ void S21Matrix::SumMatrix(const S21Matrix& other) {
     throw std::invalid_argument(
         "S21Matrix::SumMatrix: different matrix dimensions exception");
 
+  PrepareWrite();
   for (int i = 0; i < rows_; i++) {
     for (int j = 0; j < cols_; j++) {
       matrix_[i][j] += other.matrix_[i][j];
     }
   }
+  timer.AddFlops(1.0 * rows_ * cols_);
 }
 
 void S21Matrix::SubMatrix(const S21Matrix& other) {
+  S21OperationTimer timer(S21Operation::kSubMatrix);
+
   if (IsNullOrEmpty() || other.IsNullOrEmpty())
     throw std::invalid_argument("S21Matrix::SubMatrix: null matrix exception");
 
@@ -146,25 +376,33 @@ void S21Matrix::SubMatrix(const S21Matrix& other) {
     throw std::invalid_argument(
         "S21Matrix::SubMatrix: different matrix dimensions exception");
 
+  PrepareWrite();
   for (int i = 0; i < rows_; i++) {
     for (int j = 0; j < cols_; j++) {
       matrix_[i][j] -= other.matrix_[i][j];
     }
   }
+  timer.AddFlops(1.0 * rows_ * cols_);
 }
 
 void S21Matrix::MulNumber(const double num) {
+  S21OperationTimer timer(S21Operation::kMulNumber);
+
   if (IsNullOrEmpty())
     throw std::invalid_argument("S21Matrix::MulNumber: null matrix exception");
 
+  PrepareWrite();
   for (int i = 0; i < rows_; i++) {
     for (int j = 0; j < cols_; j++) {
       matrix_[i][j] *= num;
     }
   }
+  timer.AddFlops(1.0 * rows_ * cols_);
 }
 
 void S21Matrix::MulMatrix(const S21Matrix& other) {
+  S21OperationTimer timer(S21Operation::kMulMatrix);
+
   if (IsNullOrEmpty() || other.IsNullOrEmpty())
     throw std::invalid_argument("S21Matrix::MulMatrix: null matrix exception");
 
@@ -172,18 +410,22 @@ void S21Matrix::MulMatrix(const S21Matrix& other) {
     throw std::invalid_argument(
         "S21Matrix::MulMatrix: different matrix dimensions exception");
 
+  PrepareWrite();
   for (int i = 0; i < rows_; i++) {
     for (int j = 0; j < cols_; j++) {
       matrix_[i][j] *= other.matrix_[i][j];
     }
   }
+  timer.AddFlops(1.0 * rows_ * cols_);
 }
 
 S21Matrix S21Matrix::Transpose() const {
+  S21OperationTimer timer(S21Operation::kTranspose);
+
   if (IsNullOrEmpty())
     throw std::invalid_argument("S21Matrix::Transpose: null matrix exception");
 
-  S21Matrix result = S21Matrix(cols_, rows_);
+  S21Matrix result(cols_, rows_, uninit);
 
   for (int i = 0; i < result.rows_; i++) {
     for (int j = 0; j < result.cols_; j++) {
@@ -194,6 +436,8 @@ S21Matrix S21Matrix::Transpose() const {
 }
 
 S21Matrix S21Matrix::CalcComplements() const {
+  S21OperationTimer timer(S21Operation::kCalcComplements);
+
   if (IsNullOrEmpty())
     throw std::invalid_argument(
         "S21Matrix::CalcComplements: null matrix exception");
@@ -202,19 +446,25 @@ S21Matrix S21Matrix::CalcComplements() const {
     throw std::invalid_argument(
         "S21Matrix::CalcComplements: matrix is not square exception");
 
-  S21Matrix result = S21Matrix(*this);
+  bool cached = UsesCache(*this);
+  if (cached) {
+    std::shared_ptr<const S21Matrix> found = S21MatrixCache::FindMatrix(
+        S21CachedOperation::kCalcComplements, *this);
+    if (found != nullptr) return *found;
+  }
 
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      S21Matrix buffer = CalcMinorElements(*this, i, j);
-      double determinant = buffer.Determinant();
-      result.matrix_[i][j] = pow(-1, i + j) * determinant;
-    }
+  S21Matrix result = CalcCofactors();
+  if (cached) {
+    S21MatrixCache::StoreMatrix(S21CachedOperation::kCalcComplements, *this,
+                                result);
   }
+  timer.AddFlops(ComplementsFlops(rows_));
   return result;
 }
 
 double S21Matrix::Determinant() const {
+  S21OperationTimer timer(S21Operation::kDeterminant);
+
   if (IsNullOrEmpty())
     throw std::invalid_argument(
         "S21Matrix::Determinant: null matrix exception");
@@ -223,26 +473,23 @@ double S21Matrix::Determinant() const {
     throw std::invalid_argument(
         "S21Matrix::Determinant: matrix is not square exception");
 
-  double result = 0.0f;
-
-  if (rows_ == 1) {
-    result = matrix_[0][0];
-  } else if (rows_ == 2) {
-    result = matrix_[0][0] * matrix_[1][1] - matrix_[0][1] * matrix_[1][0];
-  } else {
-    int sign = 1;
-
-    for (int i = 0; i < cols_; i++) {
-      S21Matrix buffer = CalcMinorElements(*this, 0, i);
-      double minor_result = buffer.Determinant();
-      result += matrix_[0][i] * minor_result * sign;
-      sign = -1 * sign;
+  double result = 0.0;
+  bool cached = UsesCache(*this);
+  if (!cached || !S21MatrixCache::FindValue(S21CachedOperation::kDeterminant,
+                                            *this, &result)) {
+    result = CalcDeterminant();
+    if (cached) {
+      S21MatrixCache::StoreValue(S21CachedOperation::kDeterminant, *this,
+                                 result);
     }
+    timer.AddFlops(DeterminantFlops(rows_));
   }
   return result;
 }
 
 S21Matrix S21Matrix::InverseMatrix() const {
+  S21OperationTimer timer(S21Operation::kInverseMatrix);
+
   if (IsNullOrEmpty())
     throw std::invalid_argument(
         "S21Matrix::InverseMatrix: null matrix exception");
@@ -251,18 +498,103 @@ S21Matrix S21Matrix::InverseMatrix() const {
     throw std::invalid_argument(
         "S21Matrix::InverseMatrix: matrix is not square exception");
 
-  double determinant = Determinant();
+  bool cached = UsesCache(*this);
+  if (cached) {
+    std::shared_ptr<const S21Matrix> found = S21MatrixCache::FindMatrix(
+        S21CachedOperation::kInverseMatrix, *this);
+    if (found != nullptr) return *found;
+  }
+
+  // uncached, only the inverse is stored
+  double determinant = CalcDeterminant();
 
   if (fabs(determinant) <= EPS)
     throw std::invalid_argument(
         "S21Matrix::InverseMatrix: zero determinant exception");
 
-  S21Matrix mComplements = CalcComplements();
+  S21Matrix mComplements = CalcCofactors();
   S21Matrix mTransposed = mComplements.Transpose();
   mTransposed.MulNumber(1.0f / determinant);
+  if (cached) {
+    S21MatrixCache::StoreMatrix(S21CachedOperation::kInverseMatrix, *this,
+                                mTransposed);
+  }
+  timer.AddFlops(DeterminantFlops(rows_) + ComplementsFlops(rows_) +
+                 rows_ * rows_ + 1);
   return mTransposed;
 }
 
+S21Matrix S21Matrix::Product(const S21Matrix& other,
+                             S21ProductAlgorithm algorithm) const {
+  S21OperationTimer timer(S21Operation::kProduct);
+
+  if (IsNullOrEmpty() || other.IsNullOrEmpty())
+    throw std::invalid_argument("S21Matrix::Product: null matrix exception");
+
+  if (cols_ != other.rows_)
+    throw std::invalid_argument(
+        "S21Matrix::Product: different matrix dimensions exception");
+
+  // both kernels overwrite every element of the result
+  S21Matrix result(rows_, other.cols_, uninit);
+
+  if (algorithm == S21ProductAlgorithm::kStrassen ||
+      (algorithm == S21ProductAlgorithm::kAuto &&
+       S21PreferStrassen(rows_, cols_, other.cols_))) {
+    S21MultiplyStrassen(matrix_, other.matrix_, result.matrix_, rows_, cols_,
+                        other.cols_);
+  } else {
+    S21Gemm(1.0, matrix_, false, other.matrix_, false, 0.0, result.matrix_,
+            rows_, cols_, other.cols_);
+  }
+  timer.AddFlops(2.0 * rows_ * cols_ * other.cols_);
+  return result;
+}
+
+// *this = alpha * op(a) * op(b) + beta * *this, without temporaries unless
+// an operand is *this itself
+void S21Matrix::Gemm(double alpha, const S21Matrix& a, bool transA,
+                     const S21Matrix& b, bool transB, double beta) {
+  S21OperationTimer timer(S21Operation::kGemm);
+
+  if (IsNullOrEmpty() || a.IsNullOrEmpty() || b.IsNullOrEmpty())
+    throw std::invalid_argument("S21Matrix::Gemm: null matrix exception");
+
+  int m = transA ? a.cols_ : a.rows_;
+  int k = transA ? a.rows_ : a.cols_;
+  int n = transB ? b.rows_ : b.cols_;
+
+  if (k != (transB ? b.cols_ : b.rows_) || m != rows_ || n != cols_)
+    throw std::invalid_argument(
+        "S21Matrix::Gemm: different matrix dimensions exception");
+
+  PrepareWrite();
+  S21Matrix copy;
+  const double* const* aMatrix = a.matrix_;
+  const double* const* bMatrix = b.matrix_;
+  if (&a == this || &b == this) {
+    copy.CreateMatrix(rows_, cols_, false);
+    copy.CopyElements(*this);
+    if (&a == this) aMatrix = copy.matrix_;
+    if (&b == this) bMatrix = copy.matrix_;
+  }
+
+  S21Gemm(alpha, aMatrix, transA, bMatrix, transB, beta, matrix_, m, k, n);
+  timer.AddFlops(2.0 * m * k * n + (beta != 0.0 ? 1.0 * m * n : 0.0));
+}
+
+S21Vector S21Matrix::Product(const S21Vector& x) const {
+  if (IsNullOrEmpty())
+    throw std::invalid_argument("S21Matrix::Product: null matrix exception");
+
+  if (cols_ != x.GetSize())
+    throw std::invalid_argument(
+        "S21Matrix::Product: different matrix dimensions exception");
+
+  S21Vector result(rows_);
+  result.Gemv(1.0, *this, false, x, 0.0);
+  return result;
+}
 // getters, setters
 
 int S21Matrix::GetRowsCount() const noexcept { return rows_; }
@@ -279,21 +611,50 @@ double S21Matrix::GetElementAtIndex(int indexRows, int indexCols) const {
   return matrix_[indexRows][indexCols];
 }
 
+S21Vector S21Matrix::GetRow(int indexRows) const {
+  if (!Contains(indexRows, 0))
+    throw std::out_of_range("S21Matrix::GetRow: index out of range exception");
+
+  S21Vector result(cols_);
+  std::copy_n(matrix_[indexRows], cols_, result.GetData());
+  return result;
+}
+
+S21Vector S21Matrix::GetCol(int indexCols) const {
+  if (!Contains(0, indexCols))
+    throw std::out_of_range("S21Matrix::GetCol: index out of range exception");
+
+  S21Vector result(rows_);
+  for (int i = 0; i < rows_; i++) {
+    result.GetData()[i] = matrix_[i][indexCols];
+  }
+  return result;
+}
+
 void S21Matrix::SetRowsCount(int newValue) {
+  S21OperationTimer timer(S21Operation::kResize);
+
   if (rows_ != newValue) {
+    bool copyOnWrite = IsCopyOnWrite();
     S21Matrix copy = S21Matrix(*this);
     CopyMatrix(copy, newValue, cols_);
+    SetCopyOnWrite(copyOnWrite);
   }
 }
 
 void S21Matrix::SetColsCount(int newValue) {
+  S21OperationTimer timer(S21Operation::kResize);
+
   if (cols_ != newValue) {
+    bool copyOnWrite = IsCopyOnWrite();
     S21Matrix copy = S21Matrix(*this);
     CopyMatrix(copy, rows_, newValue);
+    SetCopyOnWrite(copyOnWrite);
   }
 }
 
 void S21Matrix::SetMatrix(double value) {
+  PrepareWrite();
   for (int i = 0; i < rows_; i++) {
     for (int j = 0; j < cols_; j++) {
       matrix_[i][j] = value;
@@ -303,6 +664,7 @@ void S21Matrix::SetMatrix(double value) {
 
 void S21Matrix::SetMatrix(double valueMin, double valueIncrement) {
   double value = valueMin;
+  PrepareWrite();
   for (int i = 0; i < rows_; i++) {
     for (int j = 0; j < cols_; j++) {
       if (matrix_[i] != nullptr) {
@@ -313,12 +675,17 @@ void S21Matrix::SetMatrix(double valueMin, double valueIncrement) {
   }
 }
 
+// the overlap is copied, only the elements outside of it are zeroed
 void S21Matrix::SetMatrix(const S21Matrix& matrix) {
-  SetMatrix(0.0f);
+  PrepareWrite();
+  if (&matrix != this && matrix_ != nullptr) {
+    int rows = std::min(rows_, std::max(matrix.rows_, 0));
+    int cols = std::min(cols_, std::max(matrix.cols_, 0));
 
-  for (int i = 0; i < matrix.rows_ && i < rows_; i++) {
-    for (int j = 0; j < matrix.cols_ && j < cols_; j++) {
-      matrix_[i][j] = matrix.matrix_[i][j];
+    for (int i = 0; i < rows_; i++) {
+      int copied = i < rows ? cols : 0;
+      if (copied > 0) std::copy_n(matrix.matrix_[i], copied, matrix_[i]);
+      std::fill(matrix_[i] + copied, matrix_[i] + cols_, 0.0);
     }
   }
 }
@@ -328,9 +695,54 @@ void S21Matrix::SetElementAtIndex(int indexRows, int indexCols, double value) {
     throw std::out_of_range(
         "S21Matrix::SetElementAtIndex: index out of range exception");
 
+  PrepareWrite();
   matrix_[indexRows][indexCols] = value;
 }
 
+void S21Matrix::SetRow(int indexRows, const S21Vector& row) {
+  if (!Contains(indexRows, 0))
+    throw std::out_of_range("S21Matrix::SetRow: index out of range exception");
+
+  if (row.GetSize() != cols_)
+    throw std::invalid_argument(
+        "S21Matrix::SetRow: different dimensions exception");
+
+  PrepareWrite();
+  std::copy_n(row.GetData(), cols_, matrix_[indexRows]);
+}
+
+void S21Matrix::SetCol(int indexCols, const S21Vector& col) {
+  if (!Contains(0, indexCols))
+    throw std::out_of_range("S21Matrix::SetCol: index out of range exception");
+
+  if (col.GetSize() != rows_)
+    throw std::invalid_argument(
+        "S21Matrix::SetCol: different dimensions exception");
+
+  PrepareWrite();
+  for (int i = 0; i < rows_; i++) {
+    matrix_[i][indexCols] = col.GetData()[i];
+  }
+}
+
+// copy-on-write
+
+void S21Matrix::SetCopyOnWrite(bool enabled) {
+  if (enabled && refs_ == nullptr) {
+    refs_ = new std::atomic<int>(1);
+  } else if (!enabled && refs_ != nullptr) {
+    Detach();
+    delete refs_;
+    refs_ = nullptr;
+  }
+}
+
+bool S21Matrix::IsCopyOnWrite() const noexcept { return refs_ != nullptr; }
+
+bool S21Matrix::IsShared() const noexcept {
+  return refs_ != nullptr && refs_->load(std::memory_order_acquire) > 1;
+}
+
 // public functions (helpers)
 
 void S21Matrix::PrintMatrix() const noexcept {
@@ -342,11 +754,11 @@ void S21Matrix::PrintMatrix() const noexcept {
   }
 }
 
+// indices in range imply rows_ and cols_ > 0, so of IsNullOrEmpty only the
+// pointer check is left
 bool S21Matrix::Contains(int indexRows, int indexCols) const noexcept {
-  return (!IsNullOrEmpty() && (indexRows >= 0 && indexRows < rows_) &&
-          (indexCols >= 0 && indexCols < cols_))
-             ? true
-             : false;
+  return matrix_ != nullptr && indexRows >= 0 && indexRows < rows_ &&
+         indexCols >= 0 && indexCols < cols_;
 }
 
 bool S21Matrix::IsSquare() const noexcept {
@@ -361,50 +773,243 @@ bool S21Matrix::IsEqualSize(const S21Matrix& other) const noexcept {
   return (rows_ == other.rows_ && cols_ == other.cols_) ? true : false;
 }
 
+// every dimension of other is the same or 1
+bool S21Matrix::IsBroadcastable(const S21Matrix& other) const noexcept {
+  return (other.rows_ == rows_ || other.rows_ == 1) &&
+         (other.cols_ == cols_ || other.cols_ == 1);
+}
+
 // private functions (helpers)
 
 void S21Matrix::InitMatrix() noexcept {
   cols_ = 0;
   rows_ = 0;
   matrix_ = nullptr;
+  refs_ = nullptr;
+  placed_ = false;
+  hash_ = 0;
 }
 
-void S21Matrix::CreateMatrix(int rows, int cols) {
+void S21Matrix::CreateMatrix(int rows, int cols, bool zeroed) {
   rows_ = rows;
   cols_ = cols;
-  AllocateMatrix();
+  AllocateMatrix(zeroed);
 }
 
-void S21Matrix::AllocateMatrix() {
+// one allocation per row, the heap recycles them warm. a matrix large enough
+// for the allocator's placement keeps its rows in a single mapped block
+// instead, so the huge pages and the NUMA policy cover all of it
+void S21Matrix::AllocateMatrix(bool zeroed) {
   if (rows_ > 0 && cols_ > 0) {
-    matrix_ = new double*[rows_];
-
-    for (int i = 0; i < rows_; i++) {
-      matrix_[i] = new double[cols_];
+    placed_ = S21Allocator::IsPlaced(ElementsBytes());
+    int blocks = placed_ ? 1 : rows_;
+    std::size_t bytes = placed_ ? ElementsBytes() : sizeof(double) * cols_;
+    matrix_ = static_cast<double**>(
+        S21Allocator::Allocate(sizeof(double*) * rows_));
+
+    for (int i = 0; i < blocks; i++) {
+      try {
+        matrix_[i] = static_cast<double*>(
+            zeroed ? S21Allocator::AllocateZeroed(bytes)
+                   : S21Allocator::Allocate(bytes));
+      } catch (...) {
+        for (int j = 0; j < i; j++) {
+          S21Allocator::Deallocate(matrix_[j], bytes);
+        }
+        S21Allocator::Deallocate(matrix_, sizeof(double*) * rows_);
+        InitMatrix();
+        throw;
+      }
+    }
+    if (placed_) {
+      for (int i = 1; i < rows_; i++) matrix_[i] = matrix_[i - 1] + cols_;
+      if (S21Allocator::GetPlacement().numa == S21NumaPlacement::kFirstTouch)
+        TouchRows();
     }
   } else {
     matrix_ = nullptr;
+    placed_ = false;
   }
 }
 
+std::size_t S21Matrix::ElementsBytes() const noexcept {
+  return sizeof(double) * static_cast<std::size_t>(rows_) * cols_;
+}
+
+// zeroes the fresh pages in the row blocks of the parallel kernels, each
+// page lands on the node of the worker touching it
+void S21Matrix::TouchRows() {
+  int rows = rows_;
+  std::size_t blocks =
+      static_cast<std::size_t>((rows + kMapRowsBlock - 1) / kMapRowsBlock);
+
+  S21ThreadPool::GetInstance().ParallelFor(blocks, [&](std::size_t block) {
+    int begin = static_cast<int>(block) * kMapRowsBlock;
+    int end = std::min(rows, begin + kMapRowsBlock);
+    std::fill(matrix_[begin], matrix_[end - 1] + cols_, 0.0);
+  });
+}
+
+// shared elements are released with their last reference
 void S21Matrix::DeleteMatrix() {
-  if (matrix_ != nullptr) {
-    for (int i = 0; i < rows_; i++) {
-      if (matrix_[i] != nullptr) {
-        delete[] matrix_[i];
+  bool owner = refs_ == nullptr ||
+               refs_->fetch_sub(1, std::memory_order_acq_rel) == 1;
+
+  if (owner) {
+    delete refs_;
+    if (matrix_ != nullptr) {
+      if (placed_) {
+        S21Allocator::Deallocate(matrix_[0], ElementsBytes());
+      } else {
+        for (int i = 0; i < rows_; i++) {
+          S21Allocator::Deallocate(matrix_[i], sizeof(double) * cols_);
+        }
       }
+      S21Allocator::Deallocate(matrix_, sizeof(double*) * rows_);
     }
-    delete[] matrix_;
-    InitMatrix();
   }
+  InitMatrix();
+}
+
+// body(begin, end) for every block of rows, timed as one Map operation
+void S21Matrix::ForEachRowsBlock(
+    const std::function<void(int, int)>& body) const {
+  S21OperationTimer timer(S21Operation::kMap);
+  int rows = rows_;
+  std::size_t blocks =
+      static_cast<std::size_t>((rows + kMapRowsBlock - 1) / kMapRowsBlock);
+  auto run = [&](std::size_t block) {
+    int begin = static_cast<int>(block) * kMapRowsBlock;
+    body(begin, std::min(rows, begin + kMapRowsBlock));
+  };
+
+  if (static_cast<double>(rows_) * cols_ >= kParallelMapSize) {
+    S21ThreadPool::GetInstance().ParallelFor(blocks, run);
+  } else {
+    for (std::size_t block = 0; block < blocks; block++) run(block);
+  }
+  timer.AddFlops(static_cast<double>(rows_) * cols_);
 }
 
 void S21Matrix::CopyMatrix(const S21Matrix& copy, int newRows, int newCols) {
   DeleteMatrix();
-  CreateMatrix(newRows, newCols);
+  CreateMatrix(newRows, newCols, false);
   SetMatrix(copy);
 }
 
+// other is the same size
+void S21Matrix::CopyElements(const S21Matrix& other) {
+  for (int i = 0; i < rows_ && matrix_ != nullptr; i++) {
+    std::copy_n(other.matrix_[i], cols_, matrix_[i]);
+  }
+}
+
+// drops the own elements for a reference to other's, the count is raised
+// first, so other may be this matrix or share its elements already
+void S21Matrix::ShareMatrix(const S21Matrix& other) {
+  int rows = other.rows_;
+  int cols = other.cols_;
+  double** matrix = other.matrix_;
+  std::atomic<int>* refs = other.refs_;
+  bool placed = other.placed_;
+
+  refs->fetch_add(1, std::memory_order_relaxed);
+  DeleteMatrix();
+  rows_ = rows;
+  cols_ = cols;
+  matrix_ = matrix;
+  refs_ = refs;
+  placed_ = placed;
+}
+
+// a private copy of shared elements, the old ones lose a reference when
+// copy goes out of scope
+void S21Matrix::Detach() {
+  if (IsShared()) {
+    S21Matrix copy;
+    copy.CreateMatrix(rows_, cols_, false);
+    copy.CopyElements(*this);
+    copy.refs_ = new std::atomic<int>(1);
+    std::swap(matrix_, copy.matrix_);
+    std::swap(refs_, copy.refs_);
+    std::swap(placed_, copy.placed_);
+  }
+}
+
+// the elements of CalcComplements for a square matrix, uncached. from
+// kParallelComplementsSize every element is a task
+S21Matrix S21Matrix::CalcCofactors() const {
+  // the minors of a 1 x 1 matrix are empty
+  if (rows_ == 1)
+    throw std::invalid_argument(
+        "S21Matrix::CalcComplements: null minor exception");
+
+  S21Matrix result(rows_, cols_, uninit);
+
+  if (rows_ >= kParallelComplementsSize &&
+      S21ThreadPool::GetInstance().GetThreadsCount() > 1) {
+    S21TaskGroup group;
+    for (int i = 0; i < rows_; i++) {
+      for (int j = 0; j < cols_; j++) {
+        group.Run([this, &result, i, j]() {
+          double determinant = CalcMinorElements(*this, i, j).CalcDeterminant();
+          result.matrix_[i][j] = pow(-1, i + j) * determinant;
+        });
+      }
+    }
+    group.Wait();
+  } else {
+    for (int i = 0; i < rows_; i++) {
+      for (int j = 0; j < cols_; j++) {
+        S21Matrix buffer = CalcMinorElements(*this, i, j);
+        double determinant = buffer.CalcDeterminant();
+        result.matrix_[i][j] = pow(-1, i + j) * determinant;
+      }
+    }
+  }
+  return result;
+}
+
+// the cofactor expansion along the first row, the minors below
+// kParallelDeterminantSize run on the calling thread. the bigger ones are
+// forked: the expansion is a tree of uneven subtrees, the idle workers steal
+// what is left of it. the terms are added in the same order either way
+double S21Matrix::CalcDeterminant() const {
+  double result = 0.0f;
+
+  if (rows_ == 1) {
+    result = matrix_[0][0];
+  } else if (rows_ == 2) {
+    result = matrix_[0][0] * matrix_[1][1] - matrix_[0][1] * matrix_[1][0];
+  } else if (rows_ >= kParallelDeterminantSize &&
+             S21ThreadPool::GetInstance().GetThreadsCount() > 1) {
+    std::vector<double> minors(cols_);
+    S21TaskGroup group;
+    int sign = 1;
+
+    for (int i = 0; i < cols_; i++) {
+      group.Run([this, &minors, i]() {
+        minors[i] = CalcMinorElements(*this, 0, i).CalcDeterminant();
+      });
+    }
+    group.Wait();
+    for (int i = 0; i < cols_; i++) {
+      result += matrix_[0][i] * minors[i] * sign;
+      sign = -1 * sign;
+    }
+  } else {
+    int sign = 1;
+
+    for (int i = 0; i < cols_; i++) {
+      S21Matrix buffer = CalcMinorElements(*this, 0, i);
+      double minor_result = buffer.CalcDeterminant();
+      result += matrix_[0][i] * minor_result * sign;
+      sign = -1 * sign;
+    }
+  }
+  return result;
+}
+
 S21Matrix S21Matrix::CalcMinorElements(const S21Matrix& origin, int indexRows,
                                        int indexCols) const {
   S21Matrix result;
@@ -412,7 +1017,7 @@ S21Matrix S21Matrix::CalcMinorElements(const S21Matrix& origin, int indexRows,
   if (!origin.IsNullOrEmpty() && origin.IsSquare()) {
     int elemRows = 0;
     int elemCols = 0;
-    result = S21Matrix(origin.rows_ - 1, origin.cols_ - 1);
+    result.CreateMatrix(origin.rows_ - 1, origin.cols_ - 1, false);
 
     if (!result.IsNullOrEmpty()) {
       for (int i = 0; i < origin.rows_; i++) {
@@ -3,15 +3,40 @@
 
 #include <math.h>
 
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <exception>
+#include <functional>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "s21_async.h"
+#include "s21_math.h"
+#include "s21_matrix_iterator.h"
+#include "s21_matrix_product.h"
+#include "s21_random.h"
+#include "s21_vector.h"
 
 class S21Matrix {
 #define EPS 1e-7
 
  public:
+  using iterator = S21MatrixIterator<double>;
+  using const_iterator = S21MatrixIterator<const double>;
+
+  // tag for a matrix whose elements are left uninitialized, for a caller
+  // that writes every one of them: S21Matrix(rows, cols, S21Matrix::uninit)
+  struct Uninitialized {
+    explicit Uninitialized() = default;
+  };
+  static constexpr Uninitialized uninit{};
+
   S21Matrix() noexcept;
   S21Matrix(int rows, int cols);
+  S21Matrix(int rows, int cols, Uninitialized);
   S21Matrix(const S21Matrix& other);
   S21Matrix(S21Matrix&& other) noexcept;
   ~S21Matrix();
@@ -33,19 +58,81 @@ class S21Matrix {
   S21Matrix operator*=(double num);
 
   bool EqMatrix(const S21Matrix& other) const noexcept;
+  bool ApproxEqual(const S21Matrix& other, double absTol = EPS,
+                   double relTol = 0.0, std::int64_t maxUlps = 0) const;
+  bool FindMismatch(const S21Matrix& other, int* indexRows, int* indexCols,
+                    double absTol = EPS, double relTol = 0.0,
+                    std::int64_t maxUlps = 0) const;
   void SumMatrix(const S21Matrix& other);
   void SubMatrix(const S21Matrix& other);
   void MulNumber(const double num);
   void MulMatrix(const S21Matrix& other);
+  // other is the same size, a 1 x cols row or a rows x 1 column repeated
+  // over the matrix, or a 1 x 1 scalar, combined in one pass
+  void SumBroadcast(const S21Matrix& other);
+  void SubBroadcast(const S21Matrix& other);
+  void MulBroadcast(const S21Matrix& other);
+  void DivBroadcast(const S21Matrix& other);
   S21Matrix Transpose() const;
   S21Matrix CalcComplements() const;
   double Determinant() const;
   S21Matrix InverseMatrix() const;
+  S21Matrix Product(
+      const S21Matrix& other,
+      S21ProductAlgorithm algorithm = S21ProductAlgorithm::kAuto) const;
+  void Gemm(double alpha, const S21Matrix& a, bool transA, const S21Matrix& b,
+            bool transB, double beta);
+  S21Vector Product(const S21Vector& x) const;
+  // *this is the inverse of a matrix A and becomes the inverse of
+  // A + u * v^T (Sherman-Morrison) or, with n x k u and v, of A + u * v^T
+  // (Woodbury), in O(n^2 * k) instead of inverting again
+  void UpdateInverse(const S21Vector& u, const S21Vector& v);
+  void UpdateInverse(const S21Matrix& u, const S21Matrix& v);
+
+  // asynchronous variants on the thread pool. the operands are copied by the
+  // call (cheap for copy-on-write matrices), so they may change or go away
+  // while the operation runs; its errors are thrown by S21Future::Get
+  S21Future<S21Matrix> SumMatrixAsync(const S21Matrix& other) const;
+  S21Future<S21Matrix> SubMatrixAsync(const S21Matrix& other) const;
+  S21Future<S21Matrix> MulNumberAsync(double num) const;
+  S21Future<S21Matrix> MulMatrixAsync(const S21Matrix& other) const;
+  S21Future<S21Matrix> ProductAsync(const S21Matrix& other) const;
+  S21Future<S21Matrix> TransposeAsync() const;
+  S21Future<S21Matrix> CalcComplementsAsync() const;
+  S21Future<double> DeterminantAsync() const;
+  S21Future<S21Matrix> InverseMatrixAsync() const;
+
+  // reductions: compensated sums, Min/Max/ArgMax skip NaN elements
+  double Trace() const;
+  double Sum() const;
+  S21Vector RowSums() const;
+  S21Vector ColSums() const;
+  double FrobeniusNorm() const;
+  double Norm1() const;
+  double NormInf() const;
+  double Min() const;
+  double Max() const;
+  void ArgMax(int* indexRows, int* indexCols) const;
+
+  // element-wise: Apply replaces every element by function(element), Map
+  // returns the results as a new matrix, Zip returns function(a, b) of the
+  // elements of *this and other. large matrices are split over the thread
+  // pool, so function must be safe to call concurrently; an exception from it
+  // leaves Apply with part of the elements updated. the functors of
+  // s21_math.h (S21Exp, S21Log, S21Sqrt, ...) vectorize
+  template <class Function>
+  void Apply(const Function& function);
+  template <class Function>
+  S21Matrix Map(const Function& function) const;
+  template <class Function>
+  S21Matrix Zip(const S21Matrix& other, const Function& function) const;
 
   int GetRowsCount() const noexcept;
   int GetColsCount() const noexcept;
   double** GetMatrix() const noexcept;
   double GetElementAtIndex(int indexRows, int indexCols) const;
+  S21Vector GetRow(int indexRows) const;
+  S21Vector GetCol(int indexCols) const;
 
   void SetRowsCount(int newValue);
   void SetColsCount(int newValue);
@@ -53,28 +140,248 @@ class S21Matrix {
   void SetMatrix(double valueMin, double valueIncrement);
   void SetMatrix(const S21Matrix& matrix);
   void SetElementAtIndex(int indexRows, int indexCols, double value);
+  void SetRow(int indexRows, const S21Vector& row);
+  void SetCol(int indexCols, const S21Vector& col);
 
   void PrintMatrix() const noexcept;
 
+  // unchecked access for hot loops: the indices are only checked (assert) in
+  // debug builds. a row is contiguous, [RowPtr(i), RowPtr(i) + cols). the
+  // mutable overloads may take a private copy of shared elements, see
+  // SetCopyOnWrite, so they can throw std::bad_alloc. what they return, like
+  // the reference of operator(), is only good for writes until the matrix
+  // is next copied or assigned: a copy-on-write matrix shares its elements
+  // with the copy then, so take a new one after copying
+  double& At(int i, int j);
+  const double& At(int i, int j) const noexcept;
+  double* RowPtr(int i);
+  const double* RowPtr(int i) const noexcept;
+  double* RowBegin(int i);
+  double* RowEnd(int i);
+  const double* RowBegin(int i) const noexcept;
+  const double* RowEnd(int i) const noexcept;
+
+  // all the elements in row-major order
+  iterator begin();
+  iterator end();
+  const_iterator begin() const noexcept;
+  const_iterator end() const noexcept;
+  const_iterator cbegin() const noexcept;
+  const_iterator cend() const noexcept;
+
+  static S21Matrix Random(int rows, int cols,
+                          const S21Distribution& distribution,
+                          std::uint64_t seed = 0);
+  static S21Matrix FromCsv(const std::string& path, char delimiter = ',');
+  void ToCsv(const std::string& path, char delimiter = ',') const;
+  static S21Matrix FromMatrixMarket(const std::string& path);
+  void ToMatrixMarket(const std::string& path) const;
+  static S21Future<S21Matrix> FromCsvAsync(const std::string& path,
+                                           char delimiter = ',');
+  S21Future<void> ToCsvAsync(const std::string& path,
+                             char delimiter = ',') const;
+
+  // copy-on-write, opt-in: copies of such a matrix share its elements until
+  // one of them is written, the writer then takes a private copy (and stays
+  // copy-on-write). the reference count is atomic, so the copies can be
+  // handed to other threads as read-only snapshots. writes through
+  // GetMatrix(), or through a reference, pointer or iterator taken before
+  // the matrix was copied, bypass the copy and reach every sharer
+  void SetCopyOnWrite(bool enabled);
+  bool IsCopyOnWrite() const noexcept;
+  bool IsShared() const noexcept;
+
+  // XXH64 of the shape and the elements, the key of S21MatrixCache. it is
+  // kept until the next write, so repeated lookups don't hash again; like
+  // the copy-on-write, writes through GetMatrix() go unnoticed
+  std::uint64_t ContentHash() const;
+
   bool Contains(int indexRows, int indexCols) const noexcept;
   bool IsSquare() const noexcept;
   bool IsEqualSize(const S21Matrix& other) const noexcept;
+  bool IsBroadcastable(const S21Matrix& other) const noexcept;
   bool IsNullOrEmpty() const noexcept;
 
  private:
   void InitMatrix() noexcept;
-  void CreateMatrix(int rows, int cols);
-  void AllocateMatrix();
+  void CreateMatrix(int rows, int cols, bool zeroed);
+  void AllocateMatrix(bool zeroed);
+  std::size_t ElementsBytes() const noexcept;
+  void TouchRows();
   void DeleteMatrix();
   void CopyMatrix(const S21Matrix& copy, int newRows, int newCols);
+  void CopyElements(const S21Matrix& other);
+  void ShareMatrix(const S21Matrix& other);
+  void PrepareWrite();
+  void Detach();
+  S21Matrix CalcCofactors() const;
+  double CalcDeterminant() const;
   S21Matrix CalcMinorElements(const S21Matrix& origin, int indexRows,
                               int indexCols) const;
+  void ForEachRowsBlock(const std::function<void(int, int)>& body) const;
+  template <class Function>
+  void MapRows(const S21Matrix& source, const Function& function);
+  template <class Function>
+  void ZipRows(const S21Matrix& a, const S21Matrix& b,
+               const Function& function);
 
   int rows_;
   int cols_;
   double** matrix_;
+  // the reference count of copy-on-write storage, nullptr when off
+  std::atomic<int>* refs_ = nullptr;
+  // the rows are one block, allocated under the placement. recorded, since
+  // the placement may have changed by the time it is released
+  bool placed_ = false;
+  // the ContentHash, 0 until computed. const methods of one matrix may run
+  // concurrently, so they access it with the __atomic builtins; writes use
+  // plain accesses, which don't keep element loops from being optimized
+  mutable std::uint64_t hash_ = 0;
 };
 
 S21Matrix operator*(const double num, const S21Matrix& other);
 
+// inline, so element loops compile down to plain loads and stores
+
+// shared elements are copied before the first write, the content hash is
+// dropped
+inline void S21Matrix::PrepareWrite() {
+  if (hash_ != 0) hash_ = 0;
+  if (refs_ != nullptr) Detach();
+}
+
+inline double& S21Matrix::At(int i, int j) {
+  assert(Contains(i, j));
+  PrepareWrite();
+  return matrix_[i][j];
+}
+
+inline const double& S21Matrix::At(int i, int j) const noexcept {
+  assert(Contains(i, j));
+  return matrix_[i][j];
+}
+
+inline double* S21Matrix::RowPtr(int i) {
+  assert(Contains(i, 0));
+  PrepareWrite();
+  return matrix_[i];
+}
+
+inline const double* S21Matrix::RowPtr(int i) const noexcept {
+  assert(Contains(i, 0));
+  return matrix_[i];
+}
+
+inline double* S21Matrix::RowBegin(int i) { return RowPtr(i); }
+
+inline double* S21Matrix::RowEnd(int i) { return RowPtr(i) + cols_; }
+
+inline const double* S21Matrix::RowBegin(int i) const noexcept {
+  return RowPtr(i);
+}
+
+inline const double* S21Matrix::RowEnd(int i) const noexcept {
+  return RowPtr(i) + cols_;
+}
+
+// an empty matrix has begin() == end()
+inline S21Matrix::iterator S21Matrix::begin() {
+  PrepareWrite();
+  return iterator(matrix_, cols_, 0, 0);
+}
+
+inline S21Matrix::iterator S21Matrix::end() {
+  PrepareWrite();
+  return iterator(matrix_, cols_, IsNullOrEmpty() ? 0 : rows_, 0);
+}
+
+inline S21Matrix::const_iterator S21Matrix::begin() const noexcept {
+  return const_iterator(matrix_, cols_, 0, 0);
+}
+
+inline S21Matrix::const_iterator S21Matrix::end() const noexcept {
+  return const_iterator(matrix_, cols_, IsNullOrEmpty() ? 0 : rows_, 0);
+}
+
+inline S21Matrix::const_iterator S21Matrix::cbegin() const noexcept {
+  return begin();
+}
+
+inline S21Matrix::const_iterator S21Matrix::cend() const noexcept {
+  return end();
+}
+
+template <class Function>
+void S21Matrix::Apply(const Function& function) {
+  if (IsNullOrEmpty())
+    throw std::invalid_argument("S21Matrix::Apply: null matrix exception");
+
+  PrepareWrite();
+  MapRows(*this, function);
+}
+
+template <class Function>
+S21Matrix S21Matrix::Map(const Function& function) const {
+  if (IsNullOrEmpty())
+    throw std::invalid_argument("S21Matrix::Map: null matrix exception");
+
+  S21Matrix result(rows_, cols_, uninit);
+  result.MapRows(*this, function);
+  return result;
+}
+
+template <class Function>
+S21Matrix S21Matrix::Zip(const S21Matrix& other,
+                         const Function& function) const {
+  if (IsNullOrEmpty() || other.IsNullOrEmpty())
+    throw std::invalid_argument("S21Matrix::Zip: null matrix exception");
+
+  if (!IsEqualSize(other))
+    throw std::invalid_argument(
+        "S21Matrix::Zip: different matrix dimensions exception");
+
+  S21Matrix result(rows_, cols_, uninit);
+  result.ZipRows(*this, other, function);
+  return result;
+}
+
+// source may be *this. the rows go to the functor's Batch kernel when it has
+// one, else through a plain loop the compiler vectorizes for inline functors
+template <class Function>
+void S21Matrix::MapRows(const S21Matrix& source, const Function& function) {
+  double* const* in = source.matrix_;
+  double* const* out = matrix_;
+  int cols = cols_;
+
+  ForEachRowsBlock([in, out, cols, &function](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      if constexpr (S21HasBatch<Function>::value) {
+        Function::Batch(in[i], out[i], cols);
+      } else {
+        const double* row = in[i];
+        double* result = out[i];
+        for (int j = 0; j < cols; j++) result[j] = function(row[j]);
+      }
+    }
+  });
+}
+
+template <class Function>
+void S21Matrix::ZipRows(const S21Matrix& a, const S21Matrix& b,
+                        const Function& function) {
+  double* const* left = a.matrix_;
+  double* const* right = b.matrix_;
+  double* const* out = matrix_;
+  int cols = cols_;
+
+  ForEachRowsBlock([left, right, out, cols, &function](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      const double* rowA = left[i];
+      const double* rowB = right[i];
+      double* result = out[i];
+      for (int j = 0; j < cols; j++) result[j] = function(rowA[j], rowB[j]);
+    }
+  });
+}
+
 #endif  // SRC_S21_MATRIX_OOP_H_
\ No newline at end of file
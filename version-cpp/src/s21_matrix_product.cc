@@ -0,0 +1,454 @@
+#include "s21_matrix_product.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
+#include "s21_allocator.h"
+#include "s21_parallel.h"
+
+namespace {
+
+// the classical kernel walks c in kBlockK x kBlockN panels of b (128 x 512
+// doubles, half a megabyte: resident in L2 while every row of c passes over
+// it), four rows of c at a time share each row of the panel
+constexpr int kBlockK = 128;
+constexpr int kBlockN = 512;
+constexpr int kRowsBlock = 32;
+constexpr int kTile = 16;
+constexpr double kParallelFlops = 1 << 22;
+constexpr int kDefaultStrassenCutoff = 64;
+constexpr int kStrassenSizeFactor = 16;
+
+struct TableView {
+  double* const* table;
+
+  double* Row(int i) const { return table[i]; }
+};
+
+// a row pointer table read as the operand or as its transpose
+struct ConstTableView {
+  const double* const* table;
+  bool transposed;
+
+  double At(int i, int p) const {
+    return transposed ? table[p][i] : table[i][p];
+  }
+  void Pack(int kk, int kEnd, int jj, int width, double* panel) const {
+    if (transposed) {
+      // turned around in kTile x kTile tiles, so both the reads and the
+      // writes stay within a few cache lines
+      for (int jTile = 0; jTile < width; jTile += kTile) {
+        int jEnd = std::min(width, jTile + kTile);
+        for (int pTile = kk; pTile < kEnd; pTile += kTile) {
+          int pEnd = std::min(kEnd, pTile + kTile);
+          for (int j = jTile; j < jEnd; j++) {
+            const double* column = table[jj + j];
+            for (int p = pTile; p < pEnd; p++) {
+              panel[(p - kk) * width + j] = column[p];
+            }
+          }
+        }
+      }
+    } else {
+      for (int p = kk; p < kEnd; p++) {
+        std::copy_n(table[p] + jj, width, panel + (p - kk) * width);
+      }
+    }
+  }
+};
+
+struct StridedView {
+  double* data;
+  std::ptrdiff_t stride;
+  int rows;
+  int cols;
+
+  double* Row(int i) const { return data + i * stride; }
+  double At(int i, int p) const { return data[i * stride + p]; }
+  void Pack(int kk, int kEnd, int jj, int width, double* panel) const {
+    for (int p = kk; p < kEnd; p++) {
+      std::copy_n(Row(p) + jj, width, panel + (p - kk) * width);
+    }
+  }
+  StridedView Quadrant(int indexRows, int indexCols) const {
+    int halfRows = rows / 2;
+    int halfCols = cols / 2;
+    return {data + indexRows * halfRows * stride + indexCols * halfCols,
+            stride, halfRows, halfCols};
+  }
+};
+
+// c = alpha * a * b + beta * c for the rows [rowBegin, rowEnd). every
+// kBlockK x kBlockN panel of b is packed into a contiguous per-thread
+// buffer first, which is also where a transposed b is turned around
+template <class AView, class BView, class CView>
+void MultiplyRows(double alpha, const AView& a, const BView& b, double beta,
+                  const CView& c, int rowBegin, int rowEnd, int k, int n) {
+  thread_local std::vector<double> buffer(kBlockK * kBlockN);
+  double* panel = buffer.data();
+
+  for (int i = rowBegin; i < rowEnd; i++) {
+    if (beta == 0.0) {
+      std::fill_n(c.Row(i), n, 0.0);
+    } else if (beta != 1.0) {
+      std::transform(c.Row(i), c.Row(i) + n, c.Row(i),
+                     [beta](double value) { return beta * value; });
+    }
+  }
+
+  for (int kk = 0; kk < k; kk += kBlockK) {
+    int kEnd = std::min(k, kk + kBlockK);
+
+    for (int jj = 0; jj < n; jj += kBlockN) {
+      int width = std::min(n, jj + kBlockN) - jj;
+      int i = rowBegin;
+
+      b.Pack(kk, kEnd, jj, width, panel);
+      for (; i + 4 <= rowEnd; i += 4) {
+        double* __restrict__ c0 = c.Row(i) + jj;
+        double* __restrict__ c1 = c.Row(i + 1) + jj;
+        double* __restrict__ c2 = c.Row(i + 2) + jj;
+        double* __restrict__ c3 = c.Row(i + 3) + jj;
+
+        for (int p = kk; p < kEnd; p++) {
+          const double* __restrict__ bRow = panel + (p - kk) * width;
+          double a0 = alpha * a.At(i, p);
+          double a1 = alpha * a.At(i + 1, p);
+          double a2 = alpha * a.At(i + 2, p);
+          double a3 = alpha * a.At(i + 3, p);
+
+          for (int j = 0; j < width; j++) {
+            c0[j] += a0 * bRow[j];
+            c1[j] += a1 * bRow[j];
+            c2[j] += a2 * bRow[j];
+            c3[j] += a3 * bRow[j];
+          }
+        }
+      }
+
+      for (; i < rowEnd; i++) {
+        double* __restrict__ cRow = c.Row(i) + jj;
+
+        for (int p = kk; p < kEnd; p++) {
+          const double* __restrict__ bRow = panel + (p - kk) * width;
+          double value = alpha * a.At(i, p);
+
+          for (int j = 0; j < width; j++) {
+            cRow[j] += value * bRow[j];
+          }
+        }
+      }
+    }
+  }
+}
+
+template <class AView, class BView, class CView>
+void Multiply(double alpha, const AView& a, const BView& b, double beta,
+              const CView& c, int m, int k, int n) {
+  // every task packs the panels of b once, so the rows are split into a
+  // couple of blocks per thread rather than many small ones
+  S21ThreadPool& pool = S21ThreadPool::GetInstance();
+  int threads = static_cast<int>(pool.GetThreadsCount());
+  int rowsBlock = std::max(kRowsBlock, (m / (2 * threads) + 3) / 4 * 4);
+  int blocks = (m + rowsBlock - 1) / rowsBlock;
+
+  if (blocks < 2 || 2.0 * m * k * n < kParallelFlops) {
+    MultiplyRows(alpha, a, b, beta, c, 0, m, k, n);
+  } else {
+    pool.ParallelFor(static_cast<std::size_t>(blocks), [&](std::size_t block) {
+      int begin = static_cast<int>(block) * rowsBlock;
+      MultiplyRows(alpha, a, b, beta, c, begin, std::min(m, begin + rowsBlock),
+                   k, n);
+    });
+  }
+}
+
+// stack-like workspace: Take hands out consecutive blocks, Release rewinds
+// to a mark, so every level reuses the space of its finished siblings
+class Arena {
+ public:
+  // at least one element, an allocator may fail empty requests
+  explicit Arena(std::size_t count)
+      : data_(static_cast<double*>(
+            S21Allocator::Allocate(sizeof(double) * std::max<std::size_t>(
+                                                         count, 1)))),
+        count_(std::max<std::size_t>(count, 1)),
+        used_(0) {}
+  Arena(const Arena& other) = delete;
+  Arena& operator=(const Arena& other) = delete;
+  ~Arena() { S21Allocator::Deallocate(data_, sizeof(double) * count_); }
+
+  StridedView Take(int rows, int cols) {
+    StridedView result = {data_ + used_, cols, rows, cols};
+    used_ += static_cast<std::size_t>(rows) * cols;
+    return result;
+  }
+  std::size_t Mark() const noexcept { return used_; }
+  void Release(std::size_t mark) noexcept { used_ = mark; }
+
+ private:
+  double* data_;
+  std::size_t count_;
+  std::size_t used_;
+};
+
+void Add(const StridedView& result, const StridedView& a,
+         const StridedView& b) {
+  for (int i = 0; i < result.rows; i++) {
+    double* row = result.Row(i);
+    const double* aRow = a.Row(i);
+    const double* bRow = b.Row(i);
+
+    for (int j = 0; j < result.cols; j++) {
+      row[j] = aRow[j] + bRow[j];
+    }
+  }
+}
+
+void Sub(const StridedView& result, const StridedView& a,
+         const StridedView& b) {
+  for (int i = 0; i < result.rows; i++) {
+    double* row = result.Row(i);
+    const double* aRow = a.Row(i);
+    const double* bRow = b.Row(i);
+
+    for (int j = 0; j < result.cols; j++) {
+      row[j] = aRow[j] - bRow[j];
+    }
+  }
+}
+
+// Winograd's schedule with three temporaries (x, y, z) per level, the seven
+// products are written straight into the quadrants of c:
+//   m1 = a11 b11, m2 = a12 b21, m3 = (a12 - s2) b22, m4 = a22 (t2 - b21),
+//   m5 = s1 t1, m6 = s2 t2, m7 = (a11 - a21)(b22 - b12),
+//   s1 = a21 + a22, s2 = s1 - a11, t1 = b12 - b11, t2 = b22 - t1
+void Strassen(const StridedView& a, const StridedView& b,
+              const StridedView& c, int levels, Arena* arena) {
+  if (levels == 0) {
+    Multiply(1.0, a, b, 0.0, c, a.rows, a.cols, b.cols);
+    return;
+  }
+
+  std::size_t mark = arena->Mark();
+  StridedView x = arena->Take(a.rows / 2, a.cols / 2);
+  StridedView y = arena->Take(b.rows / 2, b.cols / 2);
+  StridedView z = arena->Take(c.rows / 2, c.cols / 2);
+  StridedView a11 = a.Quadrant(0, 0), a12 = a.Quadrant(0, 1);
+  StridedView a21 = a.Quadrant(1, 0), a22 = a.Quadrant(1, 1);
+  StridedView b11 = b.Quadrant(0, 0), b12 = b.Quadrant(0, 1);
+  StridedView b21 = b.Quadrant(1, 0), b22 = b.Quadrant(1, 1);
+  StridedView c11 = c.Quadrant(0, 0), c12 = c.Quadrant(0, 1);
+  StridedView c21 = c.Quadrant(1, 0), c22 = c.Quadrant(1, 1);
+  levels--;
+
+  Sub(x, a11, a21);
+  Sub(y, b22, b12);
+  Strassen(x, y, c21, levels, arena);  // m7
+  Add(x, a21, a22);
+  Sub(y, b12, b11);
+  Strassen(x, y, c22, levels, arena);  // m5
+  Sub(x, x, a11);
+  Sub(y, b22, y);
+  Strassen(x, y, c12, levels, arena);  // m6
+  Sub(x, a12, x);
+  Strassen(x, b22, c11, levels, arena);  // m3
+  Strassen(a11, b11, z, levels, arena);  // m1
+
+  Add(c12, z, c12);    // m1 + m6
+  Add(c21, c12, c21);  // m1 + m6 + m7
+  Add(c12, c12, c22);  // m1 + m6 + m5
+  Add(c22, c21, c22);  // c22 = m1 + m6 + m7 + m5
+  Add(c12, c12, c11);  // c12 = m1 + m6 + m5 + m3
+
+  Sub(y, y, b21);
+  Strassen(a22, y, c11, levels, arena);    // m4
+  Sub(c21, c21, c11);                      // c21 = m1 + m6 + m7 - m4
+  Strassen(a12, b21, c11, levels, arena);  // m2
+  Add(c11, z, c11);                        // c11 = m1 + m2
+
+  arena->Release(mark);
+}
+
+// the doubles the temporaries of Strassen(levels) on m x k by k x n take
+std::size_t StrassenWorkspace(std::size_t m, std::size_t k, std::size_t n,
+                              int levels) {
+  std::size_t result = 0;
+
+  for (int level = 1; level <= levels; level++) {
+    result += (m >> level) * (k >> level) + (k >> level) * (n >> level) +
+              (m >> level) * (n >> level);
+  }
+  return result;
+}
+
+// one level of Strassen with the seven products forked as tasks. instead of
+// the three shared temporaries, every product prepares its operands in an
+// arena of its own (a fourth of a matrix per operand, for the products
+// running at the moment), m1, m2 and m4 get buffers until the quadrants of
+// c are free. the operands and the sums are formed in the order of
+// Strassen, so the result is the same to the bit
+void ForkStrassen(const StridedView& a, const StridedView& b,
+                  const StridedView& c, int levels) {
+  int m = a.rows / 2;
+  int k = a.cols / 2;
+  int n = b.cols / 2;
+  StridedView a11 = a.Quadrant(0, 0), a12 = a.Quadrant(0, 1);
+  StridedView a21 = a.Quadrant(1, 0), a22 = a.Quadrant(1, 1);
+  StridedView b11 = b.Quadrant(0, 0), b12 = b.Quadrant(0, 1);
+  StridedView b21 = b.Quadrant(1, 0), b22 = b.Quadrant(1, 1);
+  StridedView c11 = c.Quadrant(0, 0), c12 = c.Quadrant(0, 1);
+  StridedView c21 = c.Quadrant(1, 0), c22 = c.Quadrant(1, 1);
+  levels--;
+
+  Arena products(3 * static_cast<std::size_t>(m) * n);
+  StridedView m1 = products.Take(m, n);
+  StridedView m2 = products.Take(m, n);
+  StridedView m4 = products.Take(m, n);
+  std::size_t workspace = StrassenWorkspace(m, k, n, levels);
+  std::size_t xCount = static_cast<std::size_t>(m) * k;
+  std::size_t yCount = static_cast<std::size_t>(k) * n;
+
+  // prepare(x, y) forms the operands, then x y goes to destination
+  auto fork = [&](S21TaskGroup& group, bool useX, bool useY,
+                  const StridedView& left, const StridedView& right,
+                  const StridedView& destination, auto prepare) {
+    group.Run([=]() {
+      Arena arena((useX ? xCount : 0) + (useY ? yCount : 0) + workspace);
+      StridedView x = useX ? arena.Take(m, k) : left;
+      StridedView y = useY ? arena.Take(k, n) : right;
+      prepare(x, y);
+      Strassen(x, y, destination, levels, &arena);
+    });
+  };
+  auto none = [](const StridedView&, const StridedView&) {};
+
+  S21TaskGroup group;
+  fork(group, true, true, a, b, c21,
+       [=](const StridedView& x, const StridedView& y) {
+         Sub(x, a11, a21);
+         Sub(y, b22, b12);
+       });  // m7
+  fork(group, true, true, a, b, c22,
+       [=](const StridedView& x, const StridedView& y) {
+         Add(x, a21, a22);
+         Sub(y, b12, b11);
+       });  // m5
+  fork(group, true, true, a, b, c12,
+       [=](const StridedView& x, const StridedView& y) {
+         Add(x, a21, a22);
+         Sub(x, x, a11);
+         Sub(y, b12, b11);
+         Sub(y, b22, y);
+       });  // m6
+  fork(group, true, false, a, b22, c11,
+       [=](const StridedView& x, const StridedView&) {
+         Add(x, a21, a22);
+         Sub(x, x, a11);
+         Sub(x, a12, x);
+       });  // m3
+  fork(group, false, false, a11, b11, m1, none);
+  fork(group, false, true, a22, b, m4,
+       [=](const StridedView&, const StridedView& y) {
+         Sub(y, b12, b11);
+         Sub(y, b22, y);
+         Sub(y, y, b21);
+       });
+  fork(group, false, false, a12, b21, m2, none);
+  group.Wait();
+
+  Add(c12, m1, c12);
+  Add(c21, c12, c21);
+  Add(c12, c12, c22);
+  Add(c22, c21, c22);
+  Add(c12, c12, c11);
+  Sub(c21, c21, m4);
+  Add(c11, m1, m2);
+}
+
+int RoundUp(int value, int unit) { return (value + unit - 1) / unit * unit; }
+
+void CopyPadded(const double* const* source, int rows, int cols,
+                const StridedView& destination) {
+  for (int i = 0; i < destination.rows; i++) {
+    double* row = destination.Row(i);
+    int copied = i < rows ? cols : 0;
+
+    std::copy_n(source[i < rows ? i : 0], copied, row);
+    std::fill(row + copied, row + destination.cols, 0.0);
+  }
+}
+
+}  // namespace
+
+void S21Gemm(double alpha, const double* const* a, bool transA,
+             const double* const* b, bool transB, double beta,
+             double* const* c, int m, int k, int n) {
+  Multiply(alpha, ConstTableView{a, transA}, ConstTableView{b, transB}, beta,
+           TableView{c}, m, k, n);
+}
+
+void S21MultiplyStrassen(const double* const* a, const double* const* b,
+                         double* const* c, int m, int k, int n) {
+  int cutoff = S21StrassenCutoff();
+  int smallest = std::min({m, k, n});
+  int levels = 0;
+
+  while ((smallest >> (levels + 1)) >= cutoff) levels++;
+
+  if (levels == 0) {
+    S21Gemm(1.0, a, false, b, false, 0.0, c, m, k, n);
+    return;
+  }
+
+  // every dimension is padded to a multiple of 2^levels, so all the
+  // quadrants split evenly down to the leaves
+  int unit = 1 << levels;
+  int paddedM = RoundUp(m, unit);
+  int paddedK = RoundUp(k, unit);
+  int paddedN = RoundUp(n, unit);
+  // with workers the top level forks, its products allocate their own
+  // workspace
+  bool fork = S21ThreadPool::GetInstance().GetThreadsCount() > 1;
+  std::size_t count =
+      static_cast<std::size_t>(paddedM) * paddedK +
+      static_cast<std::size_t>(paddedK) * paddedN +
+      static_cast<std::size_t>(paddedM) * paddedN +
+      (fork ? 0 : StrassenWorkspace(paddedM, paddedK, paddedN, levels));
+
+  Arena arena(count);
+  StridedView paddedA = arena.Take(paddedM, paddedK);
+  StridedView paddedB = arena.Take(paddedK, paddedN);
+  StridedView paddedC = arena.Take(paddedM, paddedN);
+
+  CopyPadded(a, m, k, paddedA);
+  CopyPadded(b, k, n, paddedB);
+  if (fork) {
+    ForkStrassen(paddedA, paddedB, paddedC, levels);
+  } else {
+    Strassen(paddedA, paddedB, paddedC, levels, &arena);
+  }
+
+  for (int i = 0; i < m; i++) {
+    std::copy_n(paddedC.Row(i), n, c[i]);
+  }
+}
+
+int S21StrassenCutoff() noexcept {
+  static const int cutoff = []() {
+    const char* variable = std::getenv("S21_MATRIX_STRASSEN_CUTOFF");
+    int result = kDefaultStrassenCutoff;
+
+    if (variable != nullptr && std::atoi(variable) > 0) {
+      result = std::atoi(variable);
+    }
+    return result;
+  }();
+  return cutoff;
+}
+
+bool S21PreferStrassen(int m, int k, int n) noexcept {
+  return std::min({m, k, n}) >= kStrassenSizeFactor * S21StrassenCutoff();
+}
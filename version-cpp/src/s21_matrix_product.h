@@ -0,0 +1,31 @@
+#ifndef SRC_S21_MATRIX_PRODUCT_H_
+#define SRC_S21_MATRIX_PRODUCT_H_
+
+// matrix product kernels behind S21Matrix::Product and S21Matrix::Gemm,
+// working on row pointer tables: c (m x n) = op(a) (m x k) * op(b) (k x n)
+
+enum class S21ProductAlgorithm { kAuto, kClassical, kStrassen };
+
+// c = alpha * op(a) * op(b) + beta * c, op transposes the operand when its
+// flag is set: a is then stored k x m, b n x k. cache-blocked classical
+// kernel, rows of c are split over the thread pool. c must not overlap a or
+// b. beta == 0 overwrites c without reading it, like BLAS
+void S21Gemm(double alpha, const double* const* a, bool transA,
+             const double* const* b, bool transB, double beta,
+             double* const* c, int m, int k, int n);
+
+// Strassen-Winograd recursion (7 half-size products, 15 additions per
+// level) down to the classical kernel at the cutoff size. the operands are
+// copied, zero-padded, into one workspace arena that also holds the
+// temporaries of every level, so the recursion itself doesn't allocate
+void S21MultiplyStrassen(const double* const* a, const double* const* b,
+                         double* const* c, int m, int k, int n);
+
+// the leaf size of the recursion: 64, or the S21_MATRIX_STRASSEN_CUTOFF
+// environment variable. kAuto picks Strassen once every dimension reaches
+// 16 times the cutoff (1024 by default), below that the extra additions and
+// the rounding error aren't worth it
+int S21StrassenCutoff() noexcept;
+bool S21PreferStrassen(int m, int k, int n) noexcept;
+
+#endif  // SRC_S21_MATRIX_PRODUCT_H_
@@ -0,0 +1,349 @@
+#include <math.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+#include "s21_matrix_stats.h"
+#include "s21_parallel.h"
+
+namespace {
+
+// matrices from kParallelSize elements are reduced on the thread pool. the
+// rows (columns for the column reductions) are always cut into the same
+// blocks and the partial results are combined in a fixed order, so the
+// results don't depend on the number of threads
+constexpr double kParallelSize = 1 << 16;
+constexpr int kRowsBlock = 16;
+constexpr int kColsBlock = 512;
+constexpr int kLanes = 8;
+constexpr double kInfinity = std::numeric_limits<double>::infinity();
+
+// calls body(begin, end) for every blockSize slice of [0, size), on the
+// thread pool when parallel is set
+template <class Body>
+void ForEachBlock(int size, int blockSize, bool parallel, const Body& body) {
+  std::size_t blocks =
+      static_cast<std::size_t>((size + blockSize - 1) / blockSize);
+  auto run = [&](std::size_t block) {
+    int begin = static_cast<int>(block) * blockSize;
+    body(begin, std::min(size, begin + blockSize));
+  };
+
+  if (parallel) {
+    S21ThreadPool::GetInstance().ParallelFor(blocks, run);
+  } else {
+    for (std::size_t block = 0; block < blocks; block++) run(block);
+  }
+}
+
+struct Identity {
+  double operator()(double value) const noexcept { return value; }
+};
+
+struct Absolute {
+  double operator()(double value) const noexcept { return fabs(value); }
+};
+
+bool IsLarge(int rows, int cols) {
+  return static_cast<double>(rows) * cols >= kParallelSize;
+}
+
+// halves the range until kLanes values are left, so the rounding error
+// grows with the log of count instead of count
+double PairwiseSum(const double* values, std::size_t count) {
+  double result = 0;
+
+  if (count <= kLanes) {
+    for (std::size_t i = 0; i < count; i++) result += values[i];
+  } else {
+    result = PairwiseSum(values, count / 2) +
+             PairwiseSum(values + count / 2, count - count / 2);
+  }
+  return result;
+}
+
+// sum of transform(a[i]): blocks of kSumBlock elements are added plainly in
+// kLanes independent accumulators, which pipeline and vectorize, and the
+// block sums are accumulated with Kahan compensation, so the error no longer
+// grows with size. compensating every element would put its four dependent
+// operations on the critical path
+constexpr int kSumBlock = 128;
+
+template <class Transform>
+double SumKernel(const double* a, int size, const Transform& transform) {
+  double result = 0;
+  double error = 0;
+
+  for (int begin = 0; begin < size; begin += kSumBlock) {
+    int end = std::min(size, begin + kSumBlock);
+    double lanes[kLanes] = {};
+    int i = begin;
+
+    for (; i + kLanes <= end; i += kLanes) {
+      for (int lane = 0; lane < kLanes; lane++) {
+        lanes[lane] += transform(a[i + lane]);
+      }
+    }
+    for (; i < end; i++) lanes[0] += transform(a[i]);
+
+    double value = PairwiseSum(lanes, kLanes) - error;
+    double sum = result + value;
+    error = (sum - result) - value;
+    result = sum;
+  }
+  return result - error;
+}
+
+// largest (kMax) or smallest transform(a[i]), NaN elements are skipped
+template <bool kMax, class Transform = Identity>
+double ExtremumKernel(const double* a, int size,
+                      const Transform& transform = Transform()) {
+  double lanes[kLanes];
+  int i = 0;
+
+  std::fill_n(lanes, kLanes, kMax ? -kInfinity : kInfinity);
+  for (; i + kLanes <= size; i += kLanes) {
+    for (int lane = 0; lane < kLanes; lane++) {
+      double value = transform(a[i + lane]);
+      lanes[lane] = (kMax ? value > lanes[lane] : value < lanes[lane])
+                        ? value
+                        : lanes[lane];
+    }
+  }
+  for (; i < size; i++) {
+    double value = transform(a[i]);
+    lanes[0] = (kMax ? value > lanes[0] : value < lanes[0]) ? value : lanes[0];
+  }
+
+  double result = lanes[0];
+  for (int lane = 1; lane < kLanes; lane++) {
+    result = kMax ? std::max(result, lanes[lane])
+                  : std::min(result, lanes[lane]);
+  }
+  return result;
+}
+
+// result[i] = sum of transform over row i
+template <class Transform>
+void RowReduce(double* const* matrix, int rows, int cols,
+               const Transform& transform, double* result) {
+  ForEachBlock(rows, kRowsBlock, IsLarge(rows, cols), [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      result[i] = SumKernel(matrix[i], cols, transform);
+    }
+  });
+}
+
+// result[j] = sum of transform over column j. a block of columns is
+// accumulated row by row, so the matrix is read along its rows and the
+// columns vectorize: groups of kSumRows rows are added plainly, the group
+// sums with Kahan compensation, like the blocks of SumKernel
+constexpr int kSumRows = 16;
+
+template <class Transform>
+void ColReduce(double* const* matrix, int rows, int cols,
+               const Transform& transform, double* result) {
+  ForEachBlock(cols, kColsBlock, IsLarge(rows, cols), [&](int begin, int end) {
+    double* __restrict__ sums = result + begin;
+    double partials[kColsBlock];
+    double errors[kColsBlock] = {};
+    int width = end - begin;
+
+    std::fill_n(sums, width, 0.0);
+    for (int first = 0; first < rows; first += kSumRows) {
+      std::fill_n(partials, width, 0.0);
+      for (int i = first; i < std::min(rows, first + kSumRows); i++) {
+        const double* __restrict__ row = matrix[i] + begin;
+        for (int j = 0; j < width; j++) partials[j] += transform(row[j]);
+      }
+      for (int j = 0; j < width; j++) {
+        double value = partials[j] - errors[j];
+        double sum = sums[j] + value;
+        errors[j] = (sum - sums[j]) - value;
+        sums[j] = sum;
+      }
+    }
+    for (int j = 0; j < width; j++) sums[j] -= errors[j];
+  });
+}
+
+template <bool kMax>
+void RowExtrema(double* const* matrix, int rows, int cols, double* result) {
+  ForEachBlock(rows, kRowsBlock, IsLarge(rows, cols), [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      result[i] = ExtremumKernel<kMax>(matrix[i], cols);
+    }
+  });
+}
+
+}  // namespace
+
+// S21Matrix
+
+double S21Matrix::Trace() const {
+  S21OperationTimer timer(S21Operation::kReduce);
+
+  if (IsNullOrEmpty())
+    throw std::invalid_argument("S21Matrix::Trace: null matrix exception");
+
+  if (!IsSquare())
+    throw std::invalid_argument(
+        "S21Matrix::Trace: matrix is not square exception");
+
+  double result = 0;
+  double error = 0;
+  for (int i = 0; i < rows_; i++) {
+    double value = matrix_[i][i] - error;
+    double sum = result + value;
+    error = (sum - result) - value;
+    result = sum;
+  }
+  timer.AddFlops(rows_);
+  return result - error;
+}
+
+double S21Matrix::Sum() const {
+  S21OperationTimer timer(S21Operation::kReduce);
+
+  if (IsNullOrEmpty())
+    throw std::invalid_argument("S21Matrix::Sum: null matrix exception");
+
+  std::vector<double> sums(rows_);
+  RowReduce(matrix_, rows_, cols_, Identity(), sums.data());
+  timer.AddFlops(static_cast<double>(rows_) * cols_);
+  return PairwiseSum(sums.data(), sums.size());
+}
+
+S21Vector S21Matrix::RowSums() const {
+  S21OperationTimer timer(S21Operation::kReduce);
+
+  if (IsNullOrEmpty())
+    throw std::invalid_argument("S21Matrix::RowSums: null matrix exception");
+
+  S21Vector result(rows_);
+  RowReduce(matrix_, rows_, cols_, Identity(), result.GetData());
+  timer.AddFlops(static_cast<double>(rows_) * cols_);
+  return result;
+}
+
+S21Vector S21Matrix::ColSums() const {
+  S21OperationTimer timer(S21Operation::kReduce);
+
+  if (IsNullOrEmpty())
+    throw std::invalid_argument("S21Matrix::ColSums: null matrix exception");
+
+  S21Vector result(cols_);
+  ColReduce(matrix_, rows_, cols_, Identity(), result.GetData());
+  timer.AddFlops(static_cast<double>(rows_) * cols_);
+  return result;
+}
+
+// every row is scaled by its largest element so squaring neither overflows
+// nor underflows, the rows are then combined relative to the largest scale
+double S21Matrix::FrobeniusNorm() const {
+  S21OperationTimer timer(S21Operation::kReduce);
+
+  if (IsNullOrEmpty())
+    throw std::invalid_argument(
+        "S21Matrix::FrobeniusNorm: null matrix exception");
+
+  std::vector<double> scales(rows_);
+  std::vector<double> sums(rows_);
+  ForEachBlock(rows_, kRowsBlock, IsLarge(rows_, cols_),
+               [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      double scale = ExtremumKernel<true>(matrix_[i], cols_, Absolute());
+      double inverse = scale > 0 ? 1.0 / scale : 0.0;
+      scales[i] = scale;
+      sums[i] = SumKernel(matrix_[i], cols_, [inverse](double value) {
+        return value * inverse * (value * inverse);
+      });
+    }
+  });
+
+  double scale = *std::max_element(scales.begin(), scales.end());
+  for (int i = 0; i < rows_; i++) {
+    double ratio = scale > 0 ? scales[i] / scale : 0.0;
+    sums[i] *= ratio * ratio;
+  }
+  timer.AddFlops(3.0 * rows_ * cols_);
+  // an infinite element makes the norm infinite, as for hypot, where the
+  // scaled sums would turn to NaN
+  return isinf(scale) ? scale
+                      : scale * sqrt(PairwiseSum(sums.data(), sums.size()));
+}
+
+// the largest absolute column sum
+double S21Matrix::Norm1() const {
+  S21OperationTimer timer(S21Operation::kReduce);
+
+  if (IsNullOrEmpty())
+    throw std::invalid_argument("S21Matrix::Norm1: null matrix exception");
+
+  std::vector<double> sums(cols_);
+  ColReduce(matrix_, rows_, cols_, Absolute(), sums.data());
+  timer.AddFlops(static_cast<double>(rows_) * cols_);
+  return *std::max_element(sums.begin(), sums.end());
+}
+
+// the largest absolute row sum
+double S21Matrix::NormInf() const {
+  S21OperationTimer timer(S21Operation::kReduce);
+
+  if (IsNullOrEmpty())
+    throw std::invalid_argument("S21Matrix::NormInf: null matrix exception");
+
+  std::vector<double> sums(rows_);
+  RowReduce(matrix_, rows_, cols_, Absolute(), sums.data());
+  timer.AddFlops(static_cast<double>(rows_) * cols_);
+  return *std::max_element(sums.begin(), sums.end());
+}
+
+double S21Matrix::Min() const {
+  S21OperationTimer timer(S21Operation::kReduce);
+
+  if (IsNullOrEmpty())
+    throw std::invalid_argument("S21Matrix::Min: null matrix exception");
+
+  std::vector<double> minima(rows_);
+  RowExtrema<false>(matrix_, rows_, cols_, minima.data());
+  return *std::min_element(minima.begin(), minima.end());
+}
+
+double S21Matrix::Max() const {
+  S21OperationTimer timer(S21Operation::kReduce);
+
+  if (IsNullOrEmpty())
+    throw std::invalid_argument("S21Matrix::Max: null matrix exception");
+
+  std::vector<double> maxima(rows_);
+  RowExtrema<true>(matrix_, rows_, cols_, maxima.data());
+  return *std::max_element(maxima.begin(), maxima.end());
+}
+
+// the first largest element in row-major order: the row maxima are found
+// first, only the winning row is scanned again for the column
+void S21Matrix::ArgMax(int* indexRows, int* indexCols) const {
+  S21OperationTimer timer(S21Operation::kReduce);
+
+  if (IsNullOrEmpty())
+    throw std::invalid_argument("S21Matrix::ArgMax: null matrix exception");
+
+  std::vector<double> maxima(rows_);
+  RowExtrema<true>(matrix_, rows_, cols_, maxima.data());
+
+  int row = static_cast<int>(std::max_element(maxima.begin(), maxima.end()) -
+                             maxima.begin());
+  int col = static_cast<int>(
+      std::find(matrix_[row], matrix_[row] + cols_, maxima[row]) -
+      matrix_[row]);
+
+  // a matrix of NaN only has no largest element, the first one stands in
+  if (col == cols_) col = 0;
+  if (indexRows != nullptr) *indexRows = row;
+  if (indexCols != nullptr) *indexCols = col;
+}
@@ -0,0 +1,213 @@
+#include "s21_matrix_stats.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+constexpr std::size_t kOperationsCount =
+    static_cast<std::size_t>(S21Operation::kCount);
+constexpr std::size_t kBuckets = S21OperationStats::kHistogramBuckets;
+
+constexpr const char* kOperationNames[kOperationsCount] = {
+    "Create",    "Copy",            "Resize",      "EqMatrix",
+    "SumMatrix", "SubMatrix",       "MulNumber",   "MulMatrix",
+    "Transpose", "CalcComplements", "Determinant", "InverseMatrix",
+    "Product",   "Gemm",            "Random",      "Reduce",
+    "Map",       "Broadcast",       "Import",      "Export",
+    "Evaluate",  "Factorize",       "Update"};
+
+// one cache line per operation, so threads recording different operations
+// don't contend
+struct alignas(64) OperationCounters {
+  std::atomic<std::uint64_t> calls;
+  std::atomic<std::uint64_t> nanoseconds;
+  std::atomic<std::uint64_t> flops;
+  std::atomic<std::uint64_t> allocatedBytes;
+  std::atomic<std::uint64_t> histogram[kBuckets];
+};
+
+OperationCounters counters[kOperationsCount];
+
+// bucket upper bounds grow by 4x from 256 ns up to ~1 s, the last bucket is
+// unbounded
+std::size_t BucketIndex(std::uint64_t nanoseconds) noexcept {
+  std::size_t result = 0;
+  while (result + 1 < kBuckets &&
+         nanoseconds > S21MatrixStats::GetHistogramBound(result)) {
+    result++;
+  }
+  return result;
+}
+
+void AppendFormat(std::string* out, const char* format, const char* name,
+                  std::uint64_t value) {
+  char buffer[256];
+  std::snprintf(buffer, sizeof(buffer), format, name,
+                static_cast<unsigned long long>(value));
+  out->append(buffer);
+}
+
+bool EnabledFromEnvironment() {
+  const char* variable = std::getenv("S21_MATRIX_STATS");
+  if (variable != nullptr && variable[0] == '1') {
+    S21MatrixStats::SetEnabled(true);
+  }
+  return true;
+}
+
+const bool kEnvironmentChecked = EnabledFromEnvironment();
+
+}  // namespace
+
+void S21MatrixStats::SetEnabled(bool enabled) noexcept {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void S21MatrixStats::Record(S21Operation operation, std::uint64_t nanoseconds,
+                            std::uint64_t flops,
+                            std::uint64_t allocatedBytes) noexcept {
+  OperationCounters& counter = counters[static_cast<std::size_t>(operation)];
+
+  counter.calls.fetch_add(1, std::memory_order_relaxed);
+  counter.nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+  counter.flops.fetch_add(flops, std::memory_order_relaxed);
+  counter.allocatedBytes.fetch_add(allocatedBytes, std::memory_order_relaxed);
+  counter.histogram[BucketIndex(nanoseconds)].fetch_add(
+      1, std::memory_order_relaxed);
+}
+
+void S21MatrixStats::Reset() noexcept {
+  for (OperationCounters& counter : counters) {
+    counter.calls.store(0, std::memory_order_relaxed);
+    counter.nanoseconds.store(0, std::memory_order_relaxed);
+    counter.flops.store(0, std::memory_order_relaxed);
+    counter.allocatedBytes.store(0, std::memory_order_relaxed);
+    for (std::atomic<std::uint64_t>& bucket : counter.histogram) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+std::uint64_t S21MatrixStats::GetHistogramBound(std::size_t bucket) noexcept {
+  return bucket + 1 < kBuckets ? std::uint64_t{256} << (2 * bucket)
+                               : UINT64_MAX;
+}
+
+std::vector<S21OperationStats> S21MatrixStats::Snapshot() {
+  std::vector<S21OperationStats> result(kOperationsCount);
+
+  for (std::size_t i = 0; i < kOperationsCount; i++) {
+    result[i].name = kOperationNames[i];
+    result[i].calls = counters[i].calls.load(std::memory_order_relaxed);
+    result[i].nanoseconds =
+        counters[i].nanoseconds.load(std::memory_order_relaxed);
+    result[i].flops = counters[i].flops.load(std::memory_order_relaxed);
+    result[i].allocatedBytes =
+        counters[i].allocatedBytes.load(std::memory_order_relaxed);
+    for (std::size_t j = 0; j < kBuckets; j++) {
+      result[i].histogram[j] =
+          counters[i].histogram[j].load(std::memory_order_relaxed);
+    }
+  }
+  return result;
+}
+
+std::string S21MatrixStats::ToJson() {
+  std::string result = "{\"histogram_bounds_ns\":[";
+
+  for (std::size_t j = 0; j + 1 < kBuckets; j++) {
+    if (j > 0) result += ",";
+    result += std::to_string(GetHistogramBound(j));
+  }
+  result += "],\"operations\":[";
+
+  std::vector<S21OperationStats> snapshot = Snapshot();
+  for (std::size_t i = 0; i < snapshot.size(); i++) {
+    const S21OperationStats& stats = snapshot[i];
+    if (i > 0) result += ",";
+
+    result += "{\"name\":\"" + std::string(stats.name) + "\"";
+    result += ",\"calls\":" + std::to_string(stats.calls);
+    result += ",\"total_ns\":" + std::to_string(stats.nanoseconds);
+    result += ",\"flops\":" + std::to_string(stats.flops);
+    result += ",\"allocated_bytes\":" + std::to_string(stats.allocatedBytes);
+    result += ",\"histogram\":[";
+    for (std::size_t j = 0; j < kBuckets; j++) {
+      if (j > 0) result += ",";
+      result += std::to_string(stats.histogram[j]);
+    }
+    result += "]}";
+  }
+  result += "]}";
+  return result;
+}
+
+std::string S21MatrixStats::ToPrometheus() {
+  std::vector<S21OperationStats> snapshot = Snapshot();
+  std::string result;
+
+  result +=
+      "# HELP s21_matrix_operation_calls_total Completed operation calls.\n"
+      "# TYPE s21_matrix_operation_calls_total counter\n";
+  for (const S21OperationStats& stats : snapshot) {
+    AppendFormat(&result,
+                 "s21_matrix_operation_calls_total{operation=\"%s\"} %llu\n",
+                 stats.name, stats.calls);
+  }
+
+  result +=
+      "# HELP s21_matrix_operation_flops_total Floating point operations.\n"
+      "# TYPE s21_matrix_operation_flops_total counter\n";
+  for (const S21OperationStats& stats : snapshot) {
+    AppendFormat(&result,
+                 "s21_matrix_operation_flops_total{operation=\"%s\"} %llu\n",
+                 stats.name, stats.flops);
+  }
+
+  result +=
+      "# HELP s21_matrix_operation_allocated_bytes_total Bytes allocated.\n"
+      "# TYPE s21_matrix_operation_allocated_bytes_total counter\n";
+  for (const S21OperationStats& stats : snapshot) {
+    AppendFormat(
+        &result,
+        "s21_matrix_operation_allocated_bytes_total{operation=\"%s\"} %llu\n",
+        stats.name, stats.allocatedBytes);
+  }
+
+  result +=
+      "# HELP s21_matrix_operation_duration_seconds Operation wall time.\n"
+      "# TYPE s21_matrix_operation_duration_seconds histogram\n";
+  for (const S21OperationStats& stats : snapshot) {
+    std::uint64_t cumulative = 0;
+    char line[256];
+
+    for (std::size_t j = 0; j < kBuckets; j++) {
+      cumulative += stats.histogram[j];
+      if (j + 1 < kBuckets) {
+        std::snprintf(line, sizeof(line),
+                      "s21_matrix_operation_duration_seconds_bucket{operation="
+                      "\"%s\",le=\"%g\"} %llu\n",
+                      stats.name, GetHistogramBound(j) * 1e-9,
+                      static_cast<unsigned long long>(cumulative));
+      } else {
+        std::snprintf(line, sizeof(line),
+                      "s21_matrix_operation_duration_seconds_bucket{operation="
+                      "\"%s\",le=\"+Inf\"} %llu\n",
+                      stats.name, static_cast<unsigned long long>(cumulative));
+      }
+      result += line;
+    }
+
+    std::snprintf(line, sizeof(line),
+                  "s21_matrix_operation_duration_seconds_sum{operation="
+                  "\"%s\"} %.9f\n",
+                  stats.name, stats.nanoseconds * 1e-9);
+    result += line;
+    AppendFormat(&result,
+                 "s21_matrix_operation_duration_seconds_count{operation="
+                 "\"%s\"} %llu\n",
+                 stats.name, stats.calls);
+  }
+  return result;
+}
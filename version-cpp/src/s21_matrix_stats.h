@@ -0,0 +1,133 @@
+#ifndef SRC_S21_MATRIX_STATS_H_
+#define SRC_S21_MATRIX_STATS_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// opt-in instrumentation of the library operations: call counts, wall time
+// histograms, allocated bytes and FLOPs. disabled by default, enabled with
+// S21MatrixStats::SetEnabled(true) or the S21_MATRIX_STATS=1 environment
+// variable. building with -DS21_MATRIX_NO_STATS removes it at compile time
+
+enum class S21Operation {
+  kCreate,
+  kCopy,
+  kResize,
+  kEqMatrix,
+  kSumMatrix,
+  kSubMatrix,
+  kMulNumber,
+  kMulMatrix,
+  kTranspose,
+  kCalcComplements,
+  kDeterminant,
+  kInverseMatrix,
+  kProduct,
+  kGemm,
+  kRandom,
+  kReduce,
+  kMap,
+  kBroadcast,
+  kImport,
+  kExport,
+  kEvaluate,
+  kFactorize,
+  kUpdate,
+  kCount
+};
+
+struct S21OperationStats {
+  static constexpr std::size_t kHistogramBuckets = 13;
+
+  const char* name;
+  std::uint64_t calls;
+  std::uint64_t nanoseconds;
+  std::uint64_t flops;
+  std::uint64_t allocatedBytes;
+  std::array<std::uint64_t, kHistogramBuckets> histogram;
+};
+
+class S21MatrixStats {
+ public:
+  static bool IsEnabled() noexcept {
+#ifdef S21_MATRIX_NO_STATS
+    return false;
+#else
+    return enabled_.load(std::memory_order_relaxed);
+#endif
+  }
+  static void SetEnabled(bool enabled) noexcept;
+
+  static void Record(S21Operation operation, std::uint64_t nanoseconds,
+                     std::uint64_t flops,
+                     std::uint64_t allocatedBytes) noexcept;
+  static void Reset() noexcept;
+
+  static std::uint64_t GetHistogramBound(std::size_t bucket) noexcept;
+  static std::vector<S21OperationStats> Snapshot();
+  static std::string ToJson();
+  static std::string ToPrometheus();
+
+ private:
+  inline static std::atomic<bool> enabled_{false};
+};
+
+// measures one top-level operation call. nested calls (the recursion of
+// Determinant, the copies made inside operators) are folded into the
+// outermost timer of the thread, so a call is never counted twice
+class S21OperationTimer {
+ public:
+  explicit S21OperationTimer(S21Operation operation) noexcept
+      : operation_(operation), active_(false), flops_(0), allocatedBytes_(0) {
+    if (S21MatrixStats::IsEnabled() && current_ == nullptr) {
+      active_ = true;
+      current_ = this;
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+  S21OperationTimer(const S21OperationTimer& other) = delete;
+  S21OperationTimer& operator=(const S21OperationTimer& other) = delete;
+  ~S21OperationTimer() {
+    if (active_) {
+      auto elapsed = std::chrono::steady_clock::now() - start_;
+      current_ = nullptr;
+      S21MatrixStats::Record(
+          operation_,
+          static_cast<std::uint64_t>(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                  .count()),
+          flops_, allocatedBytes_);
+    }
+  }
+
+  // a double, the factorial counts of the cofactor expansion saturate
+  void AddFlops(double flops) noexcept {
+    if (active_ && flops > 0) {
+      flops_ = flops >= static_cast<double>(UINT64_MAX - flops_)
+                   ? UINT64_MAX
+                   : flops_ + static_cast<std::uint64_t>(flops);
+    }
+  }
+
+  static void AddAllocatedBytes(std::size_t bytes) noexcept {
+    if (S21MatrixStats::IsEnabled() && current_ != nullptr) {
+      current_->allocatedBytes_ += bytes;
+    }
+  }
+
+ private:
+  S21Operation operation_;
+  bool active_;
+  std::uint64_t flops_;
+  std::uint64_t allocatedBytes_;
+  std::chrono::steady_clock::time_point start_;
+
+  inline static thread_local S21OperationTimer* current_ = nullptr;
+};
+
+#endif  // SRC_S21_MATRIX_STATS_H_
@@ -0,0 +1,357 @@
+#include "s21_parallel.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+namespace {
+
+constexpr std::int64_t kDequeCapacity = 256;
+
+}  // namespace
+
+// constructors, destructor
+
+S21WorkStealingDeque::Buffer::Buffer(std::int64_t capacity)
+    : capacity(capacity), tasks(new std::atomic<S21Task*>[capacity]) {}
+
+S21WorkStealingDeque::S21WorkStealingDeque() : top_(0), bottom_(0) {
+  buffers_.push_back(std::make_unique<Buffer>(kDequeCapacity));
+  buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+}
+
+S21WorkStealingDeque::~S21WorkStealingDeque() {
+  while (S21Task* task = Pop()) delete task;
+}
+
+S21ThreadPool::S21ThreadPool(std::size_t threadsCount)
+    : submittedCount_(0), epoch_(0), sleeping_(0), stopped_(false) {
+  for (std::size_t i = 0; i < threadsCount; i++) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  for (std::size_t i = 0; i < threadsCount; i++) {
+    workers_[i]->thread = std::thread(&S21ThreadPool::WorkerLoop, this, i);
+  }
+}
+
+S21ThreadPool::~S21ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+    epoch_++;
+  }
+  condition_.notify_all();
+
+  for (std::unique_ptr<Worker>& worker : workers_) {
+    worker->thread.join();
+  }
+  for (S21Task* task : submitted_) delete task;
+}
+
+S21TaskGroup::S21TaskGroup(S21ThreadPool& pool) : pool_(pool), pending_(0) {}
+
+// the tasks refer to the group, it can't go before them
+S21TaskGroup::~S21TaskGroup() { WaitForTasks(); }
+
+// public functions
+
+// the seq_cst accesses of top and bottom order the owner's Pop against the
+// thieves, as the fences of the original algorithm do
+void S21WorkStealingDeque::Push(S21Task* task) {
+  std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+  std::int64_t top = top_.load(std::memory_order_acquire);
+  Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+
+  if (bottom - top >= buffer->capacity) buffer = Grow(buffer, top, bottom);
+  buffer->tasks[bottom & (buffer->capacity - 1)].store(
+      task, std::memory_order_relaxed);
+  bottom_.store(bottom + 1, std::memory_order_release);
+}
+
+S21Task* S21WorkStealingDeque::Pop() noexcept {
+  std::int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+  Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+  bottom_.store(bottom, std::memory_order_seq_cst);
+  std::int64_t top = top_.load(std::memory_order_seq_cst);
+  S21Task* result = nullptr;
+
+  if (top <= bottom) {
+    result = buffer->tasks[bottom & (buffer->capacity - 1)].load(
+        std::memory_order_relaxed);
+    // the last task, a thief may be taking it as well
+    if (top == bottom) {
+      if (!top_.compare_exchange_strong(top, top + 1,
+                                        std::memory_order_seq_cst,
+                                        std::memory_order_relaxed)) {
+        result = nullptr;
+      }
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+  } else {
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+  }
+  return result;
+}
+
+// a lost race is retried while tasks are left, so nullptr means empty
+S21Task* S21WorkStealingDeque::Steal() noexcept {
+  S21Task* result = nullptr;
+  bool stolen = false;
+
+  while (!stolen) {
+    std::int64_t top = top_.load(std::memory_order_seq_cst);
+    std::int64_t bottom = bottom_.load(std::memory_order_seq_cst);
+    if (top >= bottom) break;
+
+    Buffer* buffer = buffer_.load(std::memory_order_acquire);
+    result = buffer->tasks[top & (buffer->capacity - 1)].load(
+        std::memory_order_relaxed);
+    stolen = top_.compare_exchange_strong(top, top + 1,
+                                          std::memory_order_seq_cst,
+                                          std::memory_order_relaxed);
+  }
+  return stolen ? result : nullptr;
+}
+
+// the calling thread takes part in every ParallelFor, so the shared pool is
+// sized one below the hardware concurrency (or the S21_MATRIX_THREADS value)
+S21ThreadPool& S21ThreadPool::GetInstance() {
+  static S21ThreadPool instance(DefaultThreadsCount() - 1);
+  return instance;
+}
+
+std::size_t S21ThreadPool::DefaultThreadsCount() noexcept {
+  std::size_t result = std::max(1u, std::thread::hardware_concurrency());
+  const char* variable = std::getenv("S21_MATRIX_THREADS");
+
+  if (variable != nullptr && std::atoi(variable) > 0) {
+    result = static_cast<std::size_t>(std::atoi(variable));
+  }
+  return result;
+}
+
+std::size_t S21ThreadPool::GetThreadsCount() const noexcept {
+  return workers_.size() + 1;
+}
+
+bool S21ThreadPool::IsWorkerThread() const noexcept {
+  return currentPool_ == this;
+}
+
+void S21ThreadPool::Submit(S21Task task) {
+  auto pending = std::make_unique<S21Task>(std::move(task));
+
+  if (IsWorkerThread()) {
+    workers_[currentWorker_]->deque.Push(pending.get());
+  } else {
+    std::lock_guard<std::mutex> lock(mutex_);
+    submitted_.push_back(pending.get());
+    submittedCount_.fetch_add(1, std::memory_order_relaxed);
+  }
+  pending.release();
+  Notify();
+}
+
+// runs body(0) ... body(count - 1), returns once all of them are finished.
+// the indices are handed out one by one, to the calling thread and to
+// helper tasks the idle workers steal. the first exception thrown by body is
+// rethrown in the calling thread
+void S21ThreadPool::ParallelFor(
+    std::size_t count, const std::function<void(std::size_t)>& body) {
+  if (count < 2 || workers_.empty()) {
+    for (std::size_t i = 0; i < count; i++) {
+      body(i);
+    }
+    return;
+  }
+
+  std::atomic<std::size_t> next{0};
+  std::mutex mutex;
+  std::exception_ptr error;
+  auto run = [&]() {
+    std::size_t index = 0;
+
+    while ((index = next.fetch_add(1)) < count) {
+      try {
+        body(index);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error) error = std::current_exception();
+      }
+    }
+  };
+
+  {
+    S21TaskGroup group(*this);
+    std::size_t helpersCount = std::min(workers_.size(), count - 1);
+    for (std::size_t i = 0; i < helpersCount; i++) {
+      group.Run(run);
+    }
+    run();
+    group.Wait();
+  }
+
+  if (error) std::rethrow_exception(error);
+}
+
+void S21ThreadPool::WaitUntil(const std::function<bool()>& done) {
+  while (!done()) {
+    if (!RunPendingTask()) std::this_thread::yield();
+  }
+}
+
+void S21TaskGroup::Run(S21Task task) {
+  if (pool_.GetThreadsCount() > 1) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_.fetch_add(1, std::memory_order_relaxed);
+    }
+    try {
+      pool_.Submit([this, task = std::move(task)]() {
+        RunTask(task);
+        Finish();
+      });
+    } catch (...) {
+      Finish();
+      throw;
+    }
+  } else {
+    RunTask(task);
+  }
+}
+
+void S21TaskGroup::Wait() {
+  WaitForTasks();
+
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::swap(error, error_);
+  }
+  if (error) std::rethrow_exception(error);
+}
+
+// private functions
+
+// the buffer is replaced whole, the thieves keep reading the old one
+S21WorkStealingDeque::Buffer* S21WorkStealingDeque::Grow(Buffer* buffer,
+                                                         std::int64_t top,
+                                                         std::int64_t bottom) {
+  auto grown = std::make_unique<Buffer>(2 * buffer->capacity);
+
+  for (std::int64_t i = top; i < bottom; i++) {
+    grown->tasks[i & (grown->capacity - 1)].store(
+        buffer->tasks[i & (buffer->capacity - 1)].load(
+            std::memory_order_relaxed),
+        std::memory_order_relaxed);
+  }
+  buffers_.push_back(std::move(grown));
+  buffer_.store(buffers_.back().get(), std::memory_order_release);
+  return buffers_.back().get();
+}
+
+// a worker that finds no task sleeps until the epoch moves: Notify raises
+// it after every new task, so a task queued between the search and the sleep
+// is never missed
+void S21ThreadPool::WorkerLoop(std::size_t index) {
+  currentPool_ = this;
+  currentWorker_ = index;
+
+  while (true) {
+    std::uint64_t epoch = epoch_.load();
+    if (RunPendingTask()) continue;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (stopped_) return;
+
+    sleeping_++;
+    condition_.wait(lock, [this, epoch]() { return epoch_.load() != epoch; });
+    sleeping_--;
+  }
+}
+
+// the own deque first, then the submitted tasks, then the other workers
+bool S21ThreadPool::RunPendingTask() {
+  S21Task* task = nullptr;
+
+  if (IsWorkerThread()) task = workers_[currentWorker_]->deque.Pop();
+  if (task == nullptr) task = TakeSubmitted();
+  if (task == nullptr) task = StealTask();
+
+  if (task != nullptr) {
+    std::unique_ptr<S21Task> owner(task);
+    (*owner)();
+  }
+  return task != nullptr;
+}
+
+S21Task* S21ThreadPool::TakeSubmitted() {
+  S21Task* result = nullptr;
+
+  if (submittedCount_.load(std::memory_order_relaxed) > 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!submitted_.empty()) {
+      result = submitted_.front();
+      submitted_.pop_front();
+      submittedCount_.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+  return result;
+}
+
+// one pass over the other workers, starting after the own index so the
+// thieves spread over the victims
+S21Task* S21ThreadPool::StealTask() noexcept {
+  std::size_t count = workers_.size();
+  std::size_t start = IsWorkerThread() ? currentWorker_ + 1 : 0;
+  S21Task* result = nullptr;
+
+  for (std::size_t i = 0; i < count && result == nullptr; i++) {
+    std::size_t victim = (start + i) % count;
+    if (!IsWorkerThread() || victim != currentWorker_) {
+      result = workers_[victim]->deque.Steal();
+    }
+  }
+  return result;
+}
+
+void S21ThreadPool::Notify() {
+  epoch_.fetch_add(1);
+  if (sleeping_.load() > 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    condition_.notify_one();
+  }
+}
+
+void S21TaskGroup::RunTask(const S21Task& task) noexcept {
+  try {
+    task();
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!error_) error_ = std::current_exception();
+  }
+}
+
+// the notification is sent with mutex_ held, the waiter only returns once
+// it has the mutex back
+void S21TaskGroup::Finish() noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    finished_.notify_all();
+  }
+}
+
+void S21TaskGroup::WaitForTasks() {
+  auto done = [this]() {
+    return pending_.load(std::memory_order_acquire) == 0;
+  };
+
+  if (pool_.IsWorkerThread()) {
+    pool_.WaitUntil(done);
+    // until the last Finish lets go of the mutex
+    std::lock_guard<std::mutex> lock(mutex_);
+  } else {
+    std::unique_lock<std::mutex> lock(mutex_);
+    finished_.wait(lock, done);
+  }
+}
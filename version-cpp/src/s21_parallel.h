@@ -0,0 +1,130 @@
+#ifndef SRC_S21_PARALLEL_H_
+#define SRC_S21_PARALLEL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using S21Task = std::function<void()>;
+
+// Chase-Lev work-stealing deque: the owner thread pushes and pops tasks at
+// the bottom (newest first, while its data is still in cache), any other
+// thread steals from the top (oldest first, the largest subtrees of a
+// fork-join recursion). the buffer grows, the outgrown ones are kept until
+// the deque is destroyed since a thief may still be reading them
+class S21WorkStealingDeque {
+ public:
+  S21WorkStealingDeque();
+  S21WorkStealingDeque(const S21WorkStealingDeque& other) = delete;
+  S21WorkStealingDeque& operator=(const S21WorkStealingDeque& other) = delete;
+  ~S21WorkStealingDeque();
+
+  // owner only
+  void Push(S21Task* task);
+  S21Task* Pop() noexcept;
+  // any thread, nullptr when empty
+  S21Task* Steal() noexcept;
+
+ private:
+  struct Buffer {
+    explicit Buffer(std::int64_t capacity);
+
+    std::int64_t capacity;
+    std::unique_ptr<std::atomic<S21Task*>[]> tasks;
+  };
+
+  Buffer* Grow(Buffer* buffer, std::int64_t top, std::int64_t bottom);
+
+  std::atomic<std::int64_t> top_;
+  std::atomic<std::int64_t> bottom_;
+  std::atomic<Buffer*> buffer_;
+  std::vector<std::unique_ptr<Buffer>> buffers_;
+};
+
+// every worker owns a deque: the tasks forked by a worker go to its own
+// deque, the ones submitted from other threads to a shared queue, and an
+// idle worker steals from the others. a worker waiting for tasks
+// (S21TaskGroup::Wait, ParallelFor) runs pending ones meanwhile, so nested
+// fork-join never blocks a worker, any other thread sleeps until they are
+// finished
+class S21ThreadPool {
+ public:
+  explicit S21ThreadPool(std::size_t threadsCount);
+  S21ThreadPool(const S21ThreadPool& other) = delete;
+  S21ThreadPool& operator=(const S21ThreadPool& other) = delete;
+  ~S21ThreadPool();
+
+  static S21ThreadPool& GetInstance();
+  static std::size_t DefaultThreadsCount() noexcept;
+
+  std::size_t GetThreadsCount() const noexcept;
+  bool IsWorkerThread() const noexcept;
+  void Submit(S21Task task);
+  void ParallelFor(std::size_t count,
+                   const std::function<void(std::size_t)>& body);
+  // runs pending tasks on the calling thread until done() holds, it spins
+  // when there are none: for workers, other threads should block instead
+  void WaitUntil(const std::function<bool()>& done);
+
+ private:
+  struct Worker {
+    S21WorkStealingDeque deque;
+    std::thread thread;
+  };
+
+  void WorkerLoop(std::size_t index);
+  bool RunPendingTask();
+  S21Task* TakeSubmitted();
+  S21Task* StealTask() noexcept;
+  void Notify();
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::deque<S21Task*> submitted_;
+  std::atomic<std::size_t> submittedCount_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::atomic<std::uint64_t> epoch_;
+  std::atomic<int> sleeping_;
+  bool stopped_;
+
+  inline static thread_local S21ThreadPool* currentPool_ = nullptr;
+  inline static thread_local std::size_t currentWorker_ = 0;
+};
+
+// fork-join on the pool: Run forks a task, Wait returns once all of them are
+// finished (a worker runs pending tasks meanwhile, another thread sleeps
+// until the last one wakes it) and rethrows the first exception. without
+// pool workers Run runs the task right away
+class S21TaskGroup {
+ public:
+  explicit S21TaskGroup(S21ThreadPool& pool = S21ThreadPool::GetInstance());
+  S21TaskGroup(const S21TaskGroup& other) = delete;
+  S21TaskGroup& operator=(const S21TaskGroup& other) = delete;
+  ~S21TaskGroup();
+
+  void Run(S21Task task);
+  void Wait();
+
+ private:
+  void RunTask(const S21Task& task) noexcept;
+  void Finish() noexcept;
+  void WaitForTasks();
+
+  S21ThreadPool& pool_;
+  // changed under mutex_, so a waiter holding it can't see the group done
+  // before the last task stops touching it
+  std::atomic<std::size_t> pending_;
+  std::mutex mutex_;
+  std::condition_variable finished_;
+  std::exception_ptr error_;
+};
+
+#endif  // SRC_S21_PARALLEL_H_
@@ -0,0 +1,178 @@
+#include "s21_random.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+#include "s21_matrix_oop.h"
+#include "s21_matrix_stats.h"
+#include "s21_parallel.h"
+
+namespace {
+
+constexpr std::uint32_t kMultiplier0 = 0xD2511F53u;
+constexpr std::uint32_t kMultiplier1 = 0xCD9E8D57u;
+constexpr std::uint32_t kWeyl0 = 0x9E3779B9u;
+constexpr std::uint32_t kWeyl1 = 0xBB67AE85u;
+constexpr int kRounds = 10;
+constexpr int kBatch = 32;
+// matrices from kParallelSize elements are filled on the thread pool,
+// kRowsBlock rows per task
+constexpr double kParallelSize = 1 << 16;
+constexpr int kRowsBlock = 16;
+constexpr double kTwoPi = 6.283185307179586476925286766559;
+
+// Philox4x32-10 of counters [counter, counter + kBatch) with the key seed,
+// the rounds run over the whole batch at once (one lane per counter) so
+// they vectorize. counter c gives bits[2c] and bits[2c + 1]
+void PhiloxBatch(std::uint64_t counter, std::uint64_t seed,
+                 std::uint64_t* bits) noexcept {
+  std::uint32_t x0[kBatch], x1[kBatch], x2[kBatch], x3[kBatch];
+  std::uint32_t k0 = static_cast<std::uint32_t>(seed);
+  std::uint32_t k1 = static_cast<std::uint32_t>(seed >> 32);
+
+  for (int c = 0; c < kBatch; c++) {
+    x0[c] = static_cast<std::uint32_t>(counter + c);
+    x1[c] = static_cast<std::uint32_t>((counter + c) >> 32);
+    x2[c] = 0;
+    x3[c] = 0;
+  }
+  for (int round = 0; round < kRounds; round++) {
+    for (int c = 0; c < kBatch; c++) {
+      std::uint64_t product0 = static_cast<std::uint64_t>(kMultiplier0) * x0[c];
+      std::uint64_t product1 = static_cast<std::uint64_t>(kMultiplier1) * x2[c];
+      x0[c] = static_cast<std::uint32_t>(product1 >> 32) ^ x1[c] ^ k0;
+      x2[c] = static_cast<std::uint32_t>(product0 >> 32) ^ x3[c] ^ k1;
+      x1[c] = static_cast<std::uint32_t>(product1);
+      x3[c] = static_cast<std::uint32_t>(product0);
+    }
+    k0 += kWeyl0;
+    k1 += kWeyl1;
+  }
+  for (int c = 0; c < kBatch; c++) {
+    bits[2 * c] = static_cast<std::uint64_t>(x1[c]) << 32 | x0[c];
+    bits[2 * c + 1] = static_cast<std::uint64_t>(x3[c]) << 32 | x2[c];
+  }
+}
+
+// [0, 1) with the top 53 bits
+double ToUnit(std::uint64_t bits) noexcept {
+  return static_cast<double>(bits >> 11) * 0x1.0p-53;
+}
+
+// the values of counters [counter, counter + kBatch): counter c gives
+// stream elements 2c and 2c + 1
+void SampleBatch(std::uint64_t counter, const S21Distribution& distribution,
+                 std::uint64_t seed, double* result) noexcept {
+  std::uint64_t bits[2 * kBatch];
+  PhiloxBatch(counter, seed, bits);
+
+  double first = distribution.first;
+  double second = distribution.second;
+  switch (distribution.kind) {
+    case S21DistributionKind::kUniform:
+      for (int i = 0; i < 2 * kBatch; i++) {
+        result[i] = first + ToUnit(bits[i]) * (second - first);
+      }
+      break;
+    case S21DistributionKind::kNormal:
+      for (int c = 0; c < kBatch; c++) {
+        // 1 - u is in (0, 1], so the logarithm stays finite
+        double radius = second * sqrt(-2.0 * log(1.0 - ToUnit(bits[2 * c])));
+        double angle = kTwoPi * ToUnit(bits[2 * c + 1]);
+        result[2 * c] = first + radius * cos(angle);
+        result[2 * c + 1] = first + radius * sin(angle);
+      }
+      break;
+    case S21DistributionKind::kBernoulli:
+      for (int i = 0; i < 2 * kBatch; i++) {
+        result[i] = ToUnit(bits[i]) < first ? 1.0 : 0.0;
+      }
+      break;
+  }
+}
+
+}  // namespace
+
+// S21Distribution
+
+S21Distribution S21Distribution::Uniform(double min, double max) noexcept {
+  return {S21DistributionKind::kUniform, min, max};
+}
+
+S21Distribution S21Distribution::Normal(double mean, double stddev) noexcept {
+  return {S21DistributionKind::kNormal, mean, stddev};
+}
+
+S21Distribution S21Distribution::Bernoulli(double probability) noexcept {
+  return {S21DistributionKind::kBernoulli, probability, 0.0};
+}
+
+bool S21Distribution::IsValid() const noexcept {
+  bool result = isfinite(first) && isfinite(second);
+
+  if (kind == S21DistributionKind::kUniform) {
+    result = result && first <= second;
+  } else if (kind == S21DistributionKind::kNormal) {
+    result = result && second >= 0.0;
+  } else {
+    result = result && first >= 0.0 && first <= 1.0;
+  }
+  return result;
+}
+
+// functions
+
+void S21FillRandom(double* values, std::uint64_t first, int count,
+                   const S21Distribution& distribution,
+                   std::uint64_t seed) noexcept {
+  double batch[2 * kBatch];
+  std::uint64_t end = first + static_cast<std::uint64_t>(std::max(count, 0));
+
+  for (std::uint64_t element = first; element < end;) {
+    std::uint64_t batchFirst = element / 2 * 2;
+    std::uint64_t batchEnd = std::min(end, batchFirst + 2 * kBatch);
+
+    SampleBatch(element / 2, distribution, seed, batch);
+    std::copy(batch + (element - batchFirst), batch + (batchEnd - batchFirst),
+              values + (element - first));
+    element = batchEnd;
+  }
+}
+
+// S21Matrix
+
+// element (i, j) is element i * cols + j of the stream, whatever the split
+// of the rows over the thread pool
+S21Matrix S21Matrix::Random(int rows, int cols,
+                            const S21Distribution& distribution,
+                            std::uint64_t seed) {
+  S21OperationTimer timer(S21Operation::kRandom);
+
+  if (!distribution.IsValid())
+    throw std::invalid_argument(
+        "S21Matrix::Random: incorrect distribution exception");
+
+  S21Matrix result(rows, cols, S21Matrix::uninit);
+  auto fill = [&](std::size_t block) {
+    int end = std::min(rows, static_cast<int>(block + 1) * kRowsBlock);
+
+    for (int i = static_cast<int>(block) * kRowsBlock; i < end; i++) {
+      S21FillRandom(result.matrix_[i], static_cast<std::uint64_t>(i) * cols,
+                    cols, distribution, seed);
+    }
+  };
+  std::size_t blocks =
+      result.IsNullOrEmpty()
+          ? 0
+          : static_cast<std::size_t>((rows + kRowsBlock - 1) / kRowsBlock);
+
+  if (static_cast<double>(rows) * cols >= kParallelSize) {
+    S21ThreadPool::GetInstance().ParallelFor(blocks, fill);
+  } else {
+    for (std::size_t block = 0; block < blocks; block++) fill(block);
+  }
+  return result;
+}
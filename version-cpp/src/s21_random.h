@@ -0,0 +1,34 @@
+#ifndef SRC_S21_RANDOM_H_
+#define SRC_S21_RANDOM_H_
+
+#include <cstdint>
+
+// counter-based random numbers: Philox4x32-10 turns (seed, counter) into 128
+// random bits, so any element of a stream can be generated on its own, in
+// any order and on any thread. every counter gives two values: two uniform
+// doubles with 53 random bits each, or two normal ones through Box-Muller
+
+enum class S21DistributionKind { kUniform, kNormal, kBernoulli };
+
+struct S21Distribution {
+  // uniform on [min, max), normal with the given mean and standard
+  // deviation, 1.0 with the given probability and 0.0 otherwise
+  static S21Distribution Uniform(double min = 0.0, double max = 1.0) noexcept;
+  static S21Distribution Normal(double mean = 0.0,
+                                double stddev = 1.0) noexcept;
+  static S21Distribution Bernoulli(double probability = 0.5) noexcept;
+
+  bool IsValid() const noexcept;
+
+  S21DistributionKind kind;
+  double first;
+  double second;
+};
+
+// values[0 .. count) = elements first .. first + count - 1 of the stream of
+// seed, drawn from distribution
+void S21FillRandom(double* values, std::uint64_t first, int count,
+                   const S21Distribution& distribution,
+                   std::uint64_t seed) noexcept;
+
+#endif  // SRC_S21_RANDOM_H_
@@ -0,0 +1,298 @@
+#include "s21_vector.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "s21_allocator.h"
+#include "s21_matrix_oop.h"
+#include "s21_parallel.h"
+
+namespace {
+
+// vectors below kParallelSize elements (matrices below as many elements)
+// stay on the calling thread, kChunkSize fixes the split of the reductions
+constexpr int kParallelSize = 1 << 16;
+constexpr int kChunkSize = 1 << 14;
+constexpr int kRowsBlock = 64;
+constexpr int kColsBlock = 1024;
+
+// calls body(chunk, begin, end) for every chunkSize slice of [0, size), on
+// the thread pool when parallel is set
+template <class Body>
+void ForEachChunk(int size, int chunkSize, bool parallel, const Body& body) {
+  std::size_t chunks =
+      static_cast<std::size_t>((size + chunkSize - 1) / chunkSize);
+  auto run = [&](std::size_t chunk) {
+    int begin = static_cast<int>(chunk) * chunkSize;
+    body(chunk, begin, std::min(size, begin + chunkSize));
+  };
+
+  if (parallel) {
+    S21ThreadPool::GetInstance().ParallelFor(chunks, run);
+  } else {
+    for (std::size_t chunk = 0; chunk < chunks; chunk++) run(chunk);
+  }
+}
+
+// kLanes independent accumulators, so the additions pipeline and vectorize
+// without reassociating the whole sum
+constexpr int kLanes = 8;
+
+double DotKernel(const double* __restrict__ a, const double* __restrict__ b,
+                 int size) {
+  double sums[kLanes] = {};
+  int i = 0;
+
+  for (; i + kLanes <= size; i += kLanes) {
+    for (int lane = 0; lane < kLanes; lane++) {
+      sums[lane] += a[i + lane] * b[i + lane];
+    }
+  }
+  for (; i < size; i++) {
+    sums[0] += a[i] * b[i];
+  }
+
+  double result = 0;
+  for (double sum : sums) result += sum;
+  return result;
+}
+
+double ChunkedDot(const double* a, const double* b, int size) {
+  std::vector<double> partials((size + kChunkSize - 1) / kChunkSize, 0.0);
+
+  ForEachChunk(size, kChunkSize, size >= kParallelSize,
+               [&](std::size_t chunk, int begin, int end) {
+    partials[chunk] = DotKernel(a + begin, b + begin, end - begin);
+  });
+
+  double result = 0;
+  for (double partial : partials) result += partial;
+  return result;
+}
+
+}  // namespace
+
+// constructors, destructor
+
+S21Vector::S21Vector() noexcept : size_(0), data_(nullptr) {}
+
+S21Vector::S21Vector(int size) : size_(0), data_(nullptr) {
+  if (size < 0)
+    throw std::invalid_argument("S21Vector: negative size exception");
+
+  Allocate(size);
+  SetVector(0.0);
+}
+
+S21Vector::S21Vector(const S21Vector& other) : size_(0), data_(nullptr) {
+  Allocate(other.size_);
+  std::copy_n(other.data_, size_, data_);
+}
+
+S21Vector::S21Vector(S21Vector&& other) noexcept
+    : size_(other.size_), data_(other.data_) {
+  other.size_ = 0;
+  other.data_ = nullptr;
+}
+
+S21Vector::~S21Vector() { Release(); }
+
+// operators
+
+S21Vector& S21Vector::operator=(const S21Vector& other) {
+  if (this != &other) {
+    if (size_ != other.size_) {
+      Release();
+      Allocate(other.size_);
+    }
+    std::copy_n(other.data_, size_, data_);
+  }
+  return *this;
+}
+
+S21Vector& S21Vector::operator=(S21Vector&& other) noexcept {
+  if (this != &other) {
+    Release();
+    std::swap(size_, other.size_);
+    std::swap(data_, other.data_);
+  }
+  return *this;
+}
+
+double& S21Vector::operator()(int i) {
+  if (i < 0 || i >= size_)
+    throw std::out_of_range("S21Vector: index out of range exception");
+
+  return data_[i];
+}
+
+const double& S21Vector::operator()(int i) const {
+  if (i < 0 || i >= size_)
+    throw std::out_of_range("S21Vector: index out of range exception");
+
+  return data_[i];
+}
+
+bool S21Vector::operator==(const S21Vector& other) const noexcept {
+  return EqVector(other);
+}
+
+bool S21Vector::operator!=(const S21Vector& other) const noexcept {
+  return !EqVector(other);
+}
+
+// public functions (lib)
+
+bool S21Vector::EqVector(const S21Vector& other) const noexcept {
+  bool result = size_ == other.size_;
+
+  for (int i = 0; i < size_ && result; i++) {
+    result = fabs(data_[i] - other.data_[i]) <= EPS;
+  }
+  return result;
+}
+
+double S21Vector::Dot(const S21Vector& other) const {
+  if (size_ != other.size_)
+    throw std::invalid_argument(
+        "S21Vector::Dot: different vector dimensions exception");
+
+  return ChunkedDot(data_, other.data_, size_);
+}
+
+// *this += alpha * x
+void S21Vector::Axpy(double alpha, const S21Vector& x) {
+  if (size_ != x.size_)
+    throw std::invalid_argument(
+        "S21Vector::Axpy: different vector dimensions exception");
+
+  double* y = data_;
+  const double* source = x.data_;
+  ForEachChunk(size_, kChunkSize, size_ >= kParallelSize,
+               [&](std::size_t, int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      y[i] += alpha * source[i];
+    }
+  });
+}
+
+// euclidean norm, every chunk is scaled by its largest element so squaring
+// neither overflows nor underflows
+double S21Vector::Norm() const {
+  std::vector<double> scales((size_ + kChunkSize - 1) / kChunkSize, 0.0);
+  std::vector<double> sums(scales.size(), 0.0);
+
+  ForEachChunk(size_, kChunkSize, size_ >= kParallelSize,
+               [&](std::size_t chunk, int begin, int end) {
+    double scale = 0;
+    double sum = 0;
+
+    for (int i = begin; i < end; i++) scale = std::max(scale, fabs(data_[i]));
+    if (scale > 0) {
+      for (int i = begin; i < end; i++) {
+        double value = data_[i] / scale;
+        sum += value * value;
+      }
+    }
+    scales[chunk] = scale;
+    sums[chunk] = sum;
+  });
+
+  double scale =
+      scales.empty() ? 0.0 : *std::max_element(scales.begin(), scales.end());
+  double sum = 0;
+  for (std::size_t chunk = 0; chunk < scales.size() && scale > 0; chunk++) {
+    double ratio = scales[chunk] / scale;
+    sum += sums[chunk] * ratio * ratio;
+  }
+  // infinite with an infinite element, whatever the scaled sums are
+  return isinf(scale) ? scale : scale * sqrt(sum);
+}
+
+// *this = alpha * op(a) * x + beta * *this. the plain product takes one dot
+// product per row of a, split over row blocks, the transposed one adds
+// scaled rows of a into *this, split over column blocks, so both read a
+// row by row
+void S21Vector::Gemv(double alpha, const S21Matrix& a, bool transA,
+                     const S21Vector& x, double beta) {
+  if (a.IsNullOrEmpty())
+    throw std::invalid_argument("S21Vector::Gemv: null matrix exception");
+
+  int rows = a.GetRowsCount();
+  int cols = a.GetColsCount();
+  if ((transA ? rows : cols) != x.size_ || (transA ? cols : rows) != size_)
+    throw std::invalid_argument(
+        "S21Vector::Gemv: different matrix dimensions exception");
+
+  S21Vector copy;
+  const double* source = x.data_;
+  if (&x == this) {
+    copy = x;
+    source = copy.data_;
+  }
+
+  double* const* matrix = a.GetMatrix();
+  double* y = data_;
+  bool parallel = static_cast<double>(rows) * cols >= kParallelSize;
+
+  if (!transA) {
+    ForEachChunk(rows, kRowsBlock, parallel,
+                 [&](std::size_t, int begin, int end) {
+      for (int i = begin; i < end; i++) {
+        double value = alpha * DotKernel(matrix[i], source, cols);
+        y[i] = beta == 0.0 ? value : value + beta * y[i];
+      }
+    });
+  } else {
+    ForEachChunk(cols, kColsBlock, parallel,
+                 [&](std::size_t, int begin, int end) {
+      double* __restrict__ block = y + begin;
+      int width = end - begin;
+
+      for (int j = 0; j < width; j++) {
+        block[j] = beta == 0.0 ? 0.0 : beta * block[j];
+      }
+      for (int i = 0; i < rows; i++) {
+        const double* __restrict__ row = matrix[i] + begin;
+        double value = alpha * source[i];
+
+        for (int j = 0; j < width; j++) {
+          block[j] += value * row[j];
+        }
+      }
+    });
+  }
+}
+
+// getters, setters
+
+int S21Vector::GetSize() const noexcept { return size_; }
+
+double* S21Vector::GetData() noexcept { return data_; }
+
+const double* S21Vector::GetData() const noexcept { return data_; }
+
+void S21Vector::SetVector(double value) noexcept {
+  std::fill_n(data_, size_, value);
+}
+
+// private functions
+
+void S21Vector::Allocate(int size) {
+  if (size > 0) {
+    data_ = static_cast<double*>(S21Allocator::Allocate(
+        sizeof(double) * static_cast<std::size_t>(size)));
+  }
+  size_ = size;
+}
+
+void S21Vector::Release() noexcept {
+  S21Allocator::Deallocate(data_,
+                           sizeof(double) * static_cast<std::size_t>(size_));
+  data_ = nullptr;
+  size_ = 0;
+}
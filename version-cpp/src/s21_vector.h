@@ -0,0 +1,45 @@
+#ifndef SRC_S21_VECTOR_H_
+#define SRC_S21_VECTOR_H_
+
+class S21Matrix;
+
+// dense vector with one contiguous buffer, the operand of the matrix-vector
+// kernels. large vectors and matrices are split over the thread pool, the
+// reductions (Dot, Norm) always use the same fixed-size chunks, so their
+// result doesn't depend on the number of threads
+class S21Vector {
+ public:
+  S21Vector() noexcept;
+  explicit S21Vector(int size);
+  S21Vector(const S21Vector& other);
+  S21Vector(S21Vector&& other) noexcept;
+  ~S21Vector();
+
+  S21Vector& operator=(const S21Vector& other);
+  S21Vector& operator=(S21Vector&& other) noexcept;
+  double& operator()(int i);
+  const double& operator()(int i) const;
+  bool operator==(const S21Vector& other) const noexcept;
+  bool operator!=(const S21Vector& other) const noexcept;
+
+  bool EqVector(const S21Vector& other) const noexcept;
+  double Dot(const S21Vector& other) const;
+  void Axpy(double alpha, const S21Vector& x);
+  double Norm() const;
+  void Gemv(double alpha, const S21Matrix& a, bool transA, const S21Vector& x,
+            double beta);
+
+  int GetSize() const noexcept;
+  double* GetData() noexcept;
+  const double* GetData() const noexcept;
+  void SetVector(double value) noexcept;
+
+ private:
+  void Allocate(int size);
+  void Release() noexcept;
+
+  int size_;
+  double* data_;
+};
+
+#endif  // SRC_S21_VECTOR_H_
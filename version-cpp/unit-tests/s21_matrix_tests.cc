@@ -1,6 +1,25 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "../src/s21_allocator.h"
+#include "../src/s21_factorization.h"
+#include "../src/s21_lazy.h"
+#include "../src/s21_matrix_cache.h"
 #include "../src/s21_matrix_oop.h"
+#include "../src/s21_matrix_stats.h"
+#include "../src/s21_parallel.h"
 
 TEST(CONSTRUCTORS, NOERR) {
   S21Matrix test = S21Matrix();
@@ -39,6 +58,17 @@ TEST(CONSTRUCTORS, NOERR) {
       EXPECT_ANY_THROW(EXPECT_DOUBLE_EQ(test(i, j), test3(i, j)));
     }
   }
+
+  // non-square copies keep their shape
+  S21Matrix test4(2, 5);
+  test4.SetMatrix(1.0, 1.0);
+  S21Matrix test5(test4);
+  EXPECT_EQ(test5.GetRowsCount(), 2);
+  EXPECT_EQ(test5.GetColsCount(), 5);
+  EXPECT_TRUE(test5 == test4);
+  test4.SetRowsCount(3);
+  EXPECT_DOUBLE_EQ(test4(1, 4), 10.0);
+  EXPECT_DOUBLE_EQ(test4(2, 4), 0.0);
 }
 
 TEST(GETSET, NOERR) {
@@ -147,6 +177,56 @@ TEST(EQ, NOERR) {
   EXPECT_FALSE(test2 == test3);
 }
 
+TEST(APPROX_EQUAL, NOERR) {
+  S21Matrix test1 = S21Matrix(3, 20);
+  S21Matrix test2 = S21Matrix(3, 20);
+  test1.SetMatrix(1e9, 1e6);
+  test2.SetMatrix(1e9, 1e6);
+  test2(2, 13) += 1.0;
+
+  EXPECT_FALSE(test1.EqMatrix(test2));
+  EXPECT_TRUE(test1.ApproxEqual(test2, 0.0, 1e-9));
+  EXPECT_FALSE(test1.ApproxEqual(test2, 0.0, 1e-12));
+  test2(2, 13) = nextafter(test1(2, 13), 2e9);
+  EXPECT_TRUE(test1.ApproxEqual(test2, 0.0, 0.0, 1));
+  EXPECT_FALSE(test1.ApproxEqual(test2, 0.0, 0.0, 0));
+
+  int row = -1;
+  int col = -1;
+  EXPECT_TRUE(test1.FindMismatch(test2, &row, &col));
+  EXPECT_EQ(row, 2);
+  EXPECT_EQ(col, 13);
+  test2(2, 13) = NAN;
+  test2(0, 1) = test1(0, 1) + 1.0;
+  EXPECT_TRUE(test1.FindMismatch(test2, &row, &col, 2.0));
+  EXPECT_EQ(row, 2);
+  EXPECT_FALSE(test1.ApproxEqual(test2, 1e300));
+
+  // the parallel scan reports the first mismatch in row-major order
+  S21Matrix test3 = S21Matrix(1200, 1000);
+  S21Matrix test4 = S21Matrix(1200, 1000);
+  test4(1100, 3) = 1.0;
+  test4(700, 999) = 1.0;
+  EXPECT_TRUE(test3.FindMismatch(test4, &row, &col));
+  EXPECT_EQ(row, 700);
+  EXPECT_EQ(col, 999);
+  test4(700, 999) = 0.0;
+  test4(1100, 3) = 0.0;
+  EXPECT_FALSE(test3.FindMismatch(test4, &row, &col));
+}
+
+TEST(APPROX_EQUAL, ERR) {
+  S21Matrix test1 = S21Matrix(2, 2);
+  S21Matrix test2 = S21Matrix(2, 3);
+  EXPECT_FALSE(test1.ApproxEqual(test2));
+  EXPECT_THROW(test1.ApproxEqual(test1, -1.0), std::invalid_argument);
+  EXPECT_THROW(test1.ApproxEqual(test1, 0.0, NAN), std::invalid_argument);
+  EXPECT_THROW(test1.FindMismatch(test1, nullptr, nullptr, 0.0, 0.0, -1),
+               std::invalid_argument);
+  EXPECT_THROW(test1.FindMismatch(test2, nullptr, nullptr),
+               std::invalid_argument);
+}
+
 TEST(OPERATORS, NOERR) {
   S21Matrix test1 = S21Matrix(4, 4);
   S21Matrix test2 = S21Matrix(test1);
@@ -175,6 +255,16 @@ TEST(OPERATORS, NOERR) {
 
   EXPECT_FALSE(test1 == test2);
   EXPECT_FALSE(test1 == test3);
+
+  S21Matrix test5(2, 2);
+  test5.SetMatrix(1.0, 1.0);
+  S21Matrix& same = test5;
+  test5 = same;
+  EXPECT_DOUBLE_EQ(test5(0, 0), 1.0);
+  EXPECT_DOUBLE_EQ(test5(1, 1), 4.0);
+  test5.SetCopyOnWrite(true);
+  test5 = same;
+  EXPECT_DOUBLE_EQ(test5(1, 0), 3.0);
 }
 
 TEST(OPERATORS, ERR) {
@@ -472,6 +562,1268 @@ TEST(CONSTANTS, NOERR) {
   EXPECT_ANY_THROW(test1.InverseMatrix());
 }
 
+TEST(PRODUCT, NOERR) {
+  S21Matrix test1(2, 3);
+  S21Matrix test2(3, 2);
+  S21Matrix expected(2, 2);
+  test1.SetMatrix(1.0, 1.0);
+  test2.SetMatrix(-2.0, 0.5);
+  expected(0, 0) = -4.0;
+  expected(0, 1) = -1.0;
+  expected(1, 0) = -13.0;
+  expected(1, 1) = -5.5;
+  EXPECT_TRUE(test1.Product(test2) == expected);
+
+  // odd sizes exercise the padding, the recursion runs two levels with the
+  // default leaf size of 64
+  int size = 301;
+  S21Matrix test3(size, size + 2);
+  S21Matrix test4(size + 2, size - 1);
+  for (int i = 0; i < test3.GetRowsCount(); i++) {
+    for (int j = 0; j < test3.GetColsCount(); j++) {
+      test3(i, j) = ((i * 7 + j * 3) % 11) / 11.0 - 0.5;
+    }
+  }
+  for (int i = 0; i < test4.GetRowsCount(); i++) {
+    for (int j = 0; j < test4.GetColsCount(); j++) {
+      test4(i, j) = ((i * 5 + j * 13) % 17) / 17.0 - 0.5;
+    }
+  }
+  S21Matrix classical = test3.Product(test4, S21ProductAlgorithm::kClassical);
+  S21Matrix strassen = test3.Product(test4, S21ProductAlgorithm::kStrassen);
+  EXPECT_EQ(strassen.GetRowsCount(), size);
+  EXPECT_EQ(strassen.GetColsCount(), size - 1);
+  EXPECT_TRUE(classical == strassen);
+  double expected1 = 0;
+  for (int k = 0; k < test3.GetColsCount(); k++) {
+    expected1 += test3(size - 1, k) * test4(k, size - 2);
+  }
+  EXPECT_NEAR(classical(size - 1, size - 2), expected1, 1e-9);
+}
+
+TEST(PRODUCT, ERR) {
+  S21Matrix test1(2, 3);
+  S21Matrix test2(2, 3);
+  S21Matrix test3;
+  EXPECT_THROW(test1.Product(test2), std::invalid_argument);
+  EXPECT_THROW(test1.Product(test3), std::invalid_argument);
+  EXPECT_THROW(test3.Product(test1), std::invalid_argument);
+}
+
+TEST(GEMM, NOERR) {
+  S21Matrix test1(3, 4);
+  S21Matrix test2(4, 5);
+  S21Matrix test3(3, 5);
+  test1.SetMatrix(-1.0, 0.25);
+  test2.SetMatrix(2.0, -0.5);
+  test3.SetMatrix(1.0, 1.0);
+
+  S21Matrix expected = test1.Product(test2);
+  S21Matrix result(3, 5);
+  expected.MulNumber(0.5);
+  result.SetMatrix(test3);
+  result.MulNumber(2.0);
+  expected.SumMatrix(result);
+  result.SetMatrix(test3);
+  result.Gemm(0.5, test1, false, test2, false, 2.0);
+  EXPECT_TRUE(result == expected);
+
+  // transposed operands are read in place, the result matches the product
+  // of the materialized transposes
+  S21Matrix test1T = test1.Transpose();
+  S21Matrix test2T = test2.Transpose();
+  result.Gemm(1.0, test1T, true, test2T, true, 0.0);
+  EXPECT_TRUE(result == test1.Product(test2));
+
+  S21Matrix square(4, 4);
+  square.SetMatrix(0.5, 0.5);
+  expected = square.Product(square.Transpose());
+  square.Gemm(1.0, square, false, square, true, 0.0);
+  EXPECT_TRUE(square == expected);
+}
+
+TEST(GEMM, ERR) {
+  S21Matrix test1(3, 4);
+  S21Matrix test2(4, 5);
+  S21Matrix test3(3, 5);
+  S21Matrix test4;
+  EXPECT_THROW(test3.Gemm(1.0, test1, true, test2, false, 0.0),
+               std::invalid_argument);
+  EXPECT_THROW(test3.Gemm(1.0, test1, false, test2, true, 0.0),
+               std::invalid_argument);
+  EXPECT_THROW(test2.Gemm(1.0, test1, false, test2, false, 0.0),
+               std::invalid_argument);
+  EXPECT_THROW(test4.Gemm(1.0, test1, false, test2, false, 0.0),
+               std::invalid_argument);
+}
+
+TEST(VECTOR, NOERR) {
+  S21Vector test1(3);
+  S21Vector test2(3);
+  test1(0) = 1.0;
+  test1(1) = 2.0;
+  test1(2) = 2.0;
+  test2.SetVector(0.5);
+  EXPECT_DOUBLE_EQ(test1.Dot(test2), 2.5);
+  EXPECT_DOUBLE_EQ(test1.Norm(), 3.0);
+  test2.Axpy(2.0, test1);
+  EXPECT_DOUBLE_EQ(test2(2), 4.5);
+
+  S21Vector huge(2);
+  huge.SetVector(1e300);
+  EXPECT_DOUBLE_EQ(huge.Norm(), sqrt(2.0) * 1e300);
+  S21Vector infinite(3);
+  infinite(0) = INFINITY;
+  EXPECT_DOUBLE_EQ(infinite.Norm(), INFINITY);
+
+  // a long vector takes the chunked, parallel path
+  S21Vector test3(200000);
+  test3.SetVector(0.5);
+  EXPECT_DOUBLE_EQ(test3.Dot(test3), 50000.0);
+  test3.Axpy(-1.0, test3);
+  EXPECT_DOUBLE_EQ(test3.Norm(), 0.0);
+}
+
+TEST(VECTOR, GEMV) {
+  S21Matrix test1(2, 3);
+  test1.SetMatrix(1.0, 1.0);
+  S21Vector test2 = test1.GetRow(1);
+  S21Vector test3 = test1.GetCol(2);
+  EXPECT_DOUBLE_EQ(test2(0), 4.0);
+  EXPECT_DOUBLE_EQ(test3(1), 6.0);
+
+  S21Vector result = test1.Product(test2);
+  EXPECT_DOUBLE_EQ(result(0), 32.0);
+  EXPECT_DOUBLE_EQ(result(1), 77.0);
+
+  S21Vector transposed(3);
+  transposed.SetVector(1.0);
+  transposed.Gemv(2.0, test1, true, test3, 0.5);
+  EXPECT_DOUBLE_EQ(transposed(0), 2.0 * 27.0 + 0.5);
+  EXPECT_DOUBLE_EQ(transposed(2), 2.0 * 45.0 + 0.5);
+
+  test1.SetRow(0, S21Vector(3));
+  EXPECT_DOUBLE_EQ(test1(0, 1), 0.0);
+  test1.SetCol(1, test3);
+  EXPECT_DOUBLE_EQ(test1(1, 1), 6.0);
+
+  // a large matrix is split over row (column) blocks
+  S21Matrix test4(300, 400);
+  S21Vector ones(400);
+  S21Vector column(300);
+  test4.SetMatrix(0.25);
+  ones.SetVector(1.0);
+  column.SetVector(1.0);
+  EXPECT_DOUBLE_EQ(test4.Product(ones)(299), 100.0);
+  ones.Gemv(1.0, test4, true, column, 0.0);
+  EXPECT_DOUBLE_EQ(ones(399), 75.0);
+}
+
+TEST(VECTOR, ERR) {
+  S21Matrix test1(2, 3);
+  S21Vector test2(2);
+  S21Vector test3(3);
+  EXPECT_THROW(S21Vector(-1), std::invalid_argument);
+  EXPECT_THROW(test2(2), std::out_of_range);
+  EXPECT_THROW(test2.Dot(test3), std::invalid_argument);
+  EXPECT_THROW(test2.Axpy(1.0, test3), std::invalid_argument);
+  EXPECT_THROW(test1.Product(test2), std::invalid_argument);
+  EXPECT_THROW(test2.Gemv(1.0, test1, true, test2, 0.0),
+               std::invalid_argument);
+  EXPECT_THROW(test1.GetRow(2), std::out_of_range);
+  EXPECT_THROW(test1.GetCol(3), std::out_of_range);
+  EXPECT_THROW(test1.SetRow(0, test2), std::invalid_argument);
+  EXPECT_THROW(test1.SetCol(0, test3), std::invalid_argument);
+}
+
+TEST(REDUCE, NOERR) {
+  S21Matrix test1(3, 3);
+  test1.SetMatrix(1.0, 1.0);
+  test1(1, 1) = -5.0;
+  EXPECT_DOUBLE_EQ(test1.Trace(), 5.0);
+  EXPECT_DOUBLE_EQ(test1.Sum(), 35.0);
+  EXPECT_DOUBLE_EQ(test1.RowSums()(1), 5.0);
+  EXPECT_DOUBLE_EQ(test1.ColSums()(1), 5.0);
+  EXPECT_DOUBLE_EQ(test1.Norm1(), 18.0);
+  EXPECT_DOUBLE_EQ(test1.NormInf(), 24.0);
+  EXPECT_DOUBLE_EQ(test1.FrobeniusNorm(), sqrt(285.0));
+  EXPECT_DOUBLE_EQ(test1.Min(), -5.0);
+
+  int row = -1;
+  int col = -1;
+  test1(0, 2) = 9.0;
+  test1(1, 0) = NAN;
+  test1.ArgMax(&row, &col);
+  EXPECT_EQ(row, 0);
+  EXPECT_EQ(col, 2);
+  EXPECT_DOUBLE_EQ(test1.Max(), 9.0);
+
+  S21Matrix huge(1, 2);
+  huge.SetMatrix(1e300);
+  EXPECT_DOUBLE_EQ(huge.FrobeniusNorm(), sqrt(2.0) * 1e300);
+  S21Matrix infinite(2, 2);
+  infinite(1, 0) = -INFINITY;
+  EXPECT_DOUBLE_EQ(infinite.FrobeniusNorm(), INFINITY);
+
+  // a large matrix is split over row (column) blocks, the compensated sums
+  // don't lose the small elements next to the large ones
+  S21Matrix test2(300, 1000);
+  test2.SetMatrix(0.1);
+  test2(0, 0) = 1e8;
+  EXPECT_NEAR(test2.Sum(), 1e8 + 29999.9, 1e-6);
+  EXPECT_NEAR(test2.ColSums()(0), 1e8 + 29.9, 1e-6);
+  test2(250, 700) = 2e8;
+  test2.ArgMax(&row, &col);
+  EXPECT_EQ(row, 250);
+  EXPECT_EQ(col, 700);
+  EXPECT_NEAR(test2.Norm1(), 2e8 + 29.9, 1e-6);
+}
+
+TEST(REDUCE, ERR) {
+  S21Matrix test1;
+  S21Matrix test2(2, 3);
+  EXPECT_THROW(test1.Sum(), std::invalid_argument);
+  EXPECT_THROW(test1.Max(), std::invalid_argument);
+  EXPECT_THROW(test1.ArgMax(nullptr, nullptr), std::invalid_argument);
+  EXPECT_THROW(test1.FrobeniusNorm(), std::invalid_argument);
+  EXPECT_THROW(test2.Trace(), std::invalid_argument);
+}
+
+TEST(COPY_ON_WRITE, NOERR) {
+  S21Matrix test1(3, 4);
+  test1.SetMatrix(1.0, 1.0);
+  test1.SetCopyOnWrite(true);
+  EXPECT_TRUE(test1.IsCopyOnWrite());
+  EXPECT_FALSE(test1.IsShared());
+
+  // copies share the elements until one of them is written
+  S21Matrix test2(test1);
+  S21Matrix test3;
+  test3 = test2;
+  EXPECT_TRUE(test1.IsShared() && test3.IsShared());
+  EXPECT_EQ(test2.GetMatrix(), test1.GetMatrix());
+  EXPECT_EQ(test3.GetMatrix(), test1.GetMatrix());
+  test2(0, 0) = -1.0;
+  EXPECT_NE(test2.GetMatrix(), test1.GetMatrix());
+  EXPECT_TRUE(test2.IsCopyOnWrite() && !test2.IsShared());
+  EXPECT_DOUBLE_EQ(test1(0, 0), 1.0);
+  test1.MulNumber(2.0);
+  EXPECT_DOUBLE_EQ(test3(2, 3), 12.0);
+  EXPECT_DOUBLE_EQ(test1(2, 3), 24.0);
+  EXPECT_FALSE(test3.IsShared());
+
+  // every mutating path takes the private copy first
+  S21Matrix test4 = test3;
+  *test4.RowPtr(1) = 0.0;
+  S21Matrix test5 = test3;
+  test5.SumBroadcast(test3);
+  S21Matrix test6 = test3;
+  test6.Apply(S21Abs());
+  std::fill(test6.begin(), test6.end(), 7.0);
+  EXPECT_DOUBLE_EQ(test3(1, 0), 5.0);
+  EXPECT_DOUBLE_EQ(test4(1, 0), 0.0);
+  EXPECT_DOUBLE_EQ(test5(1, 0), 10.0);
+  EXPECT_DOUBLE_EQ(test6(1, 0), 7.0);
+
+  // a row pointer taken again after a copy writes a private copy
+  double* row = test6.RowPtr(0);
+  row[0] = 1.0;
+  S21Matrix test8 = test6;
+  row = test6.RowPtr(0);
+  row[0] = 2.0;
+  EXPECT_FALSE(test6.IsShared());
+  EXPECT_DOUBLE_EQ(test8(0, 0), 1.0);
+  EXPECT_DOUBLE_EQ(test6(0, 0), 2.0);
+
+  // snapshots released on other threads
+  S21Matrix test7(300, 300);
+  test7.SetCopyOnWrite(true);
+  std::vector<S21Matrix> snapshots(8, test7);
+  EXPECT_TRUE(test7.IsShared());
+  S21ThreadPool::GetInstance().ParallelFor(
+      snapshots.size(), [&](std::size_t i) {
+        snapshots[i].SetElementAtIndex(0, 0, static_cast<double>(i));
+        snapshots[i] = S21Matrix();
+      });
+  EXPECT_FALSE(test7.IsShared());
+  test7.SetCopyOnWrite(false);
+  EXPECT_FALSE(test7.IsCopyOnWrite());
+}
+
+TEST(BROADCAST, NOERR) {
+  S21Matrix test1(3, 4);
+  S21Matrix row(1, 4);
+  S21Matrix col(3, 1);
+  S21Matrix scalar(1, 1);
+  test1.SetMatrix(1.0, 1.0);
+  row.SetMatrix(10.0, 10.0);
+  col.SetMatrix(2.0, 2.0);
+  scalar(0, 0) = 0.5;
+
+  test1.SumBroadcast(row);
+  EXPECT_DOUBLE_EQ(test1(0, 0), 11.0);
+  EXPECT_DOUBLE_EQ(test1(2, 3), 52.0);
+  test1.MulBroadcast(col);
+  EXPECT_DOUBLE_EQ(test1(0, 1), 44.0);
+  EXPECT_DOUBLE_EQ(test1(2, 3), 312.0);
+  test1.DivBroadcast(col);
+  test1.SubBroadcast(row);
+  test1.MulBroadcast(scalar);
+  EXPECT_DOUBLE_EQ(test1(1, 2), 3.5);
+  test1.SubBroadcast(test1);
+  EXPECT_DOUBLE_EQ(test1.Sum(), 0.0);
+
+  // the parallel path against the expanded operand
+  S21Matrix test2(300, 300);
+  S21Matrix test3(300, 300);
+  S21Matrix bias(1, 300);
+  test2.SetMatrix(-1.0, 0.001);
+  bias.SetMatrix(3.0, 0.25);
+  test3.SetMatrix(test2);
+  test2.SumBroadcast(bias);
+  for (int i = 0; i < 300; i++) {
+    for (int j = 0; j < 300; j++) test3(i, j) += bias(0, j);
+  }
+  EXPECT_TRUE(test2 == test3);
+}
+
+TEST(BROADCAST, ERR) {
+  S21Matrix test1;
+  S21Matrix test2(3, 4);
+  S21Matrix test3(1, 3);
+  S21Matrix test4(2, 1);
+  EXPECT_THROW(test1.SumBroadcast(test2), std::invalid_argument);
+  EXPECT_THROW(test2.SubBroadcast(test1), std::invalid_argument);
+  EXPECT_THROW(test2.MulBroadcast(test3), std::invalid_argument);
+  EXPECT_THROW(test2.DivBroadcast(test4), std::invalid_argument);
+  EXPECT_FALSE(test3.IsBroadcastable(test2));
+}
+
+TEST(ITERATORS, NOERR) {
+  S21Matrix test1(3, 4);
+  test1.SetMatrix(1.0, 1.0);
+  EXPECT_DOUBLE_EQ(test1.At(2, 1), 10.0);
+  test1.At(2, 1) = -1.0;
+  EXPECT_DOUBLE_EQ(test1(2, 1), -1.0);
+  EXPECT_DOUBLE_EQ(test1.RowPtr(1)[3], 8.0);
+  EXPECT_EQ(test1.RowEnd(0) - test1.RowBegin(0), 4);
+
+  // row-major order, across the rows
+  EXPECT_EQ(std::distance(test1.begin(), test1.end()), 12);
+  EXPECT_DOUBLE_EQ(std::accumulate(test1.cbegin(), test1.cend(), 0.0), 67.0);
+  S21Matrix::const_iterator it = test1.begin() + 5;
+  EXPECT_DOUBLE_EQ(*it, 6.0);
+  EXPECT_EQ(it.GetRow(), 1);
+  EXPECT_EQ(it.GetCol(), 1);
+  EXPECT_DOUBLE_EQ(it[-2], 4.0);
+  EXPECT_DOUBLE_EQ(*--test1.end(), 12.0);
+  EXPECT_TRUE(test1.begin() < it && it - test1.begin() == 5);
+
+  std::sort(test1.begin(), test1.end(), std::greater<double>());
+  EXPECT_DOUBLE_EQ(test1(0, 0), 12.0);
+  EXPECT_DOUBLE_EQ(test1(2, 3), -1.0);
+  std::reverse(test1.begin(), test1.end());
+  EXPECT_DOUBLE_EQ(test1(0, 0), -1.0);
+
+  for (double& value : test1) value = 2.0;
+  EXPECT_DOUBLE_EQ(test1.Sum(), 24.0);
+
+  const S21Matrix test2;
+  S21Matrix test3(0, 5);
+  EXPECT_TRUE(test2.begin() == test2.end());
+  EXPECT_EQ(std::count(test3.begin(), test3.end(), 0.0), 0);
+}
+
+TEST(MAP, NOERR) {
+  S21Matrix test1(2, 3);
+  test1.SetMatrix(-2.0, 1.5);
+  S21Matrix test2 = test1.Map([](double value) { return value * value; });
+  EXPECT_DOUBLE_EQ(test2(1, 2), 30.25);
+  EXPECT_DOUBLE_EQ(test1.Map(S21Abs())(0, 0), 2.0);
+  EXPECT_DOUBLE_EQ(test1.Map(S21Clamp{-1.0, 1.0})(0, 0), -1.0);
+  EXPECT_DOUBLE_EQ(test1.Zip(test2, S21Max())(0, 1), 0.25);
+  EXPECT_DOUBLE_EQ(test1.Zip(test2, std::minus<double>())(1, 2), -24.75);
+  test1.Apply(S21Sqrt());
+  EXPECT_TRUE(isnan(test1(0, 0)));
+  EXPECT_DOUBLE_EQ(test1(1, 2), sqrt(5.5));
+
+  // exp and log within a few ulps of libm, the special values included
+  S21Matrix test3(300, 300);
+  test3.SetMatrix(-750.0, 0.0162);
+  test3(0, 1) = -INFINITY;
+  test3(0, 2) = INFINITY;
+  S21Matrix test4 = test3.Map(S21Exp());
+  EXPECT_TRUE(test4.ApproxEqual(
+      test3.Map([](double value) { return exp(value); }), 0.0, 0.0, 4));
+  test4(0, 3) = 0.0;
+  test4(0, 4) = 1e-310;
+  S21Matrix test5 = test4.Map(S21Log());
+  EXPECT_TRUE(test5.ApproxEqual(
+      test4.Map([](double value) { return log(value); }), 0.0, 0.0, 4));
+  EXPECT_DOUBLE_EQ(test5(0, 3), -INFINITY);
+
+  S21Matrix test6(1, 2);
+  test6(0, 0) = NAN;
+  test6(0, 1) = -1.0;
+  EXPECT_TRUE(isnan(test6.Map(S21Exp())(0, 0)));
+  EXPECT_TRUE(isnan(test6.Map(S21Log())(0, 0)));
+  EXPECT_TRUE(isnan(test6.Map(S21Log())(0, 1)));
+}
+
+TEST(MAP, ERR) {
+  S21Matrix test1;
+  S21Matrix test2(2, 3);
+  S21Matrix test3(3, 2);
+  EXPECT_THROW(test1.Apply(S21Exp()), std::invalid_argument);
+  EXPECT_THROW(test1.Map(S21Exp()), std::invalid_argument);
+  EXPECT_THROW(test2.Zip(test1, S21Max()), std::invalid_argument);
+  EXPECT_THROW(test2.Zip(test3, S21Max()), std::invalid_argument);
+  EXPECT_THROW(test2.Map([](double value) -> double {
+    throw std::runtime_error(std::to_string(value));
+  }), std::runtime_error);
+}
+
+TEST(RANDOM, NOERR) {
+  S21Matrix test1 =
+      S21Matrix::Random(400, 500, S21Distribution::Normal(2.0, 3.0), 42);
+  S21Matrix test2 =
+      S21Matrix::Random(400, 500, S21Distribution::Normal(2.0, 3.0), 42);
+  EXPECT_TRUE(test1 == test2);
+
+  double sum = 0;
+  double squares = 0;
+  for (int i = 0; i < 400; i++) {
+    for (int j = 0; j < 500; j++) {
+      sum += test1(i, j);
+      squares += (test1(i, j) - 2.0) * (test1(i, j) - 2.0);
+    }
+  }
+  EXPECT_NEAR(sum / 200000, 2.0, 0.05);
+  EXPECT_NEAR(sqrt(squares / 200000), 3.0, 0.05);
+
+  // any slice of the stream can be generated on its own
+  double values[7];
+  S21FillRandom(values, 3 * 500 + 11, 7, S21Distribution::Normal(2.0, 3.0),
+                42);
+  for (int j = 0; j < 7; j++) EXPECT_EQ(values[j], test1(3, 11 + j));
+
+  S21Matrix test3 =
+      S21Matrix::Random(100, 100, S21Distribution::Uniform(-1.0, 1.0), 7);
+  S21Matrix test4 = S21Matrix::Random(100, 100, S21Distribution::Bernoulli());
+  double ones = 0;
+  for (int i = 0; i < 100; i++) {
+    for (int j = 0; j < 100; j++) {
+      EXPECT_GE(test3(i, j), -1.0);
+      EXPECT_LT(test3(i, j), 1.0);
+      ones += test4(i, j);
+    }
+  }
+  EXPECT_NEAR(ones / 10000, 0.5, 0.03);
+  EXPECT_FALSE(test3 == S21Matrix::Random(100, 100,
+                                          S21Distribution::Uniform(-1.0, 1.0),
+                                          8));
+}
+
+TEST(RANDOM, ERR) {
+  EXPECT_THROW(S21Matrix::Random(2, 2, S21Distribution::Uniform(1.0, 0.0)),
+               std::invalid_argument);
+  EXPECT_THROW(S21Matrix::Random(2, 2, S21Distribution::Normal(0.0, -1.0)),
+               std::invalid_argument);
+  EXPECT_THROW(S21Matrix::Random(2, 2, S21Distribution::Bernoulli(1.5)),
+               std::invalid_argument);
+  EXPECT_TRUE(
+      S21Matrix::Random(2, -1, S21Distribution::Uniform()).IsNullOrEmpty());
+}
+
+TEST(IMPORT_EXPORT, NOERR) {
+  S21Matrix test1 = S21Matrix(3000, 90);
+  test1.SetMatrix(-1000.0 / 3.0, 1.0 / 7.0);
+  test1(0, 0) = 1e-300;
+  test1(1, 1) = -0.1;
+
+  test1.ToCsv("s21_matrix_test.csv");
+  S21Matrix test2 = S21Matrix::FromCsv("s21_matrix_test.csv");
+
+  EXPECT_EQ(test2.GetRowsCount(), test1.GetRowsCount());
+  EXPECT_EQ(test2.GetColsCount(), test1.GetColsCount());
+  for (int i = 0; i < test1.GetRowsCount(); i++) {
+    for (int j = 0; j < test1.GetColsCount(); j++) {
+      EXPECT_EQ(test1(i, j), test2(i, j));
+    }
+  }
+
+  S21Matrix test3 = S21Matrix(7, 5);
+  test3.SetMatrix(0.1, 0.3);
+  test3.ToMatrixMarket("s21_matrix_test.mtx");
+  S21Matrix test4 = S21Matrix::FromMatrixMarket("s21_matrix_test.mtx");
+
+  EXPECT_EQ(test4.GetRowsCount(), 7);
+  EXPECT_EQ(test4.GetColsCount(), 5);
+  for (int i = 0; i < test3.GetRowsCount(); i++) {
+    for (int j = 0; j < test3.GetColsCount(); j++) {
+      EXPECT_EQ(test3(i, j), test4(i, j));
+    }
+  }
+
+  std::ofstream("s21_matrix_test.mtx")
+      << "%%MatrixMarket matrix coordinate real symmetric\n"
+      << "% comment\n"
+      << "3 3 3\n"
+      << "1 1 2.5\n"
+      << "3 1 -4\n"
+      << "2 2 1e3\n";
+  S21Matrix test5 = S21Matrix::FromMatrixMarket("s21_matrix_test.mtx");
+
+  EXPECT_DOUBLE_EQ(test5(0, 0), 2.5);
+  EXPECT_DOUBLE_EQ(test5(2, 0), -4);
+  EXPECT_DOUBLE_EQ(test5(0, 2), -4);
+  EXPECT_DOUBLE_EQ(test5(1, 1), 1000);
+  EXPECT_DOUBLE_EQ(test5(2, 2), 0);
+
+  std::ofstream("s21_matrix_test.mtx")
+      << "%%MatrixMarket matrix array real skew-symmetric\n"
+      << "3 3\n"
+      << "1\n2\n3\n";
+  S21Matrix test6 = S21Matrix::FromMatrixMarket("s21_matrix_test.mtx");
+
+  EXPECT_DOUBLE_EQ(test6(1, 0), 1);
+  EXPECT_DOUBLE_EQ(test6(2, 0), 2);
+  EXPECT_DOUBLE_EQ(test6(2, 1), 3);
+  EXPECT_DOUBLE_EQ(test6(0, 2), -2);
+  EXPECT_DOUBLE_EQ(test6(0, 0), 0);
+
+  std::remove("s21_matrix_test.csv");
+  std::remove("s21_matrix_test.mtx");
+}
+
+TEST(IMPORT_EXPORT, ERR) {
+  S21Matrix test1 = S21Matrix();
+
+  EXPECT_ANY_THROW(test1.ToCsv("s21_matrix_test.csv"));
+  EXPECT_ANY_THROW(test1.ToMatrixMarket("s21_matrix_test.mtx"));
+  EXPECT_ANY_THROW(S21Matrix::FromCsv("s21_matrix_missing.csv"));
+  EXPECT_ANY_THROW(S21Matrix::FromMatrixMarket("s21_matrix_missing.mtx"));
+
+  std::ofstream("s21_matrix_test.csv") << "1,2,3\n4,5\n";
+  EXPECT_ANY_THROW(S21Matrix::FromCsv("s21_matrix_test.csv"));
+
+  std::ofstream("s21_matrix_test.csv") << "1,2\n4,abc\n";
+  EXPECT_ANY_THROW(S21Matrix::FromCsv("s21_matrix_test.csv"));
+
+  std::ofstream("s21_matrix_test.csv") << "\n \n";
+  EXPECT_ANY_THROW(S21Matrix::FromCsv("s21_matrix_test.csv"));
+  EXPECT_ANY_THROW(S21Matrix::FromCsv("s21_matrix_test.csv", ' '));
+
+  std::ofstream("s21_matrix_test.mtx")
+      << "%%MatrixMarket matrix coordinate real general\n"
+      << "2 2 2\n"
+      << "1 1 1\n"
+      << "3 1 1\n";
+  EXPECT_ANY_THROW(S21Matrix::FromMatrixMarket("s21_matrix_test.mtx"));
+
+  std::ofstream("s21_matrix_test.mtx")
+      << "%%MatrixMarket matrix array complex general\n"
+      << "1 1\n"
+      << "1 1\n";
+  EXPECT_ANY_THROW(S21Matrix::FromMatrixMarket("s21_matrix_test.mtx"));
+
+  std::remove("s21_matrix_test.csv");
+  std::remove("s21_matrix_test.mtx");
+}
+
+TEST(STATS, NOERR) {
+  S21MatrixStats::Reset();
+  S21MatrixStats::SetEnabled(true);
+
+  S21Matrix test1 = S21Matrix(3, 3);
+  S21Matrix test2 = S21Matrix(3, 3);
+  test1.SetMatrix(1, 1);
+  test1(2, 2) = 0;
+  test2.SetMatrix(1);
+
+  test1.SumMatrix(test2);
+  double determinant = test1.Determinant();
+
+  S21MatrixStats::SetEnabled(false);
+  test1.SumMatrix(test2);
+
+  std::vector<S21OperationStats> snapshot = S21MatrixStats::Snapshot();
+  const S21OperationStats& create =
+      snapshot[static_cast<int>(S21Operation::kCreate)];
+  const S21OperationStats& sum =
+      snapshot[static_cast<int>(S21Operation::kSumMatrix)];
+  const S21OperationStats& determ =
+      snapshot[static_cast<int>(S21Operation::kDeterminant)];
+
+  EXPECT_DOUBLE_EQ(determinant, 27);
+  EXPECT_STREQ(sum.name, "SumMatrix");
+  EXPECT_EQ(create.calls, 2u);
+  EXPECT_EQ(create.allocatedBytes,
+            2 * (3 * sizeof(double*) + 9 * sizeof(double)));
+  EXPECT_EQ(sum.calls, 1u);
+  EXPECT_EQ(sum.flops, 9u);
+  EXPECT_EQ(determ.calls, 1u);
+  EXPECT_EQ(determ.flops, 18u);
+
+  std::uint64_t histogramCalls = 0;
+  for (std::uint64_t bucket : determ.histogram) histogramCalls += bucket;
+  EXPECT_EQ(histogramCalls, 1u);
+
+  std::string json = S21MatrixStats::ToJson();
+  std::string prometheus = S21MatrixStats::ToPrometheus();
+  EXPECT_NE(json.find("\"name\":\"SumMatrix\",\"calls\":1,"),
+            std::string::npos);
+  EXPECT_NE(prometheus.find("s21_matrix_operation_calls_total{operation="
+                            "\"Determinant\"} 1\n"),
+            std::string::npos);
+  EXPECT_NE(prometheus.find("operation=\"Determinant\",le=\"+Inf\"} 1\n"),
+            std::string::npos);
+
+  S21MatrixStats::Reset();
+  EXPECT_EQ(S21MatrixStats::Snapshot()[0].calls, 0u);
+}
+
+TEST(STATS, ERR) {
+  S21MatrixStats::Reset();
+  S21MatrixStats::SetEnabled(true);
+  {
+    S21OperationTimer timer(S21Operation::kGemm);
+    timer.AddFlops(10);
+    timer.AddFlops(-5);
+    timer.AddFlops(std::nan(""));
+  }
+  {
+    // the factorial counts of a large cofactor expansion
+    S21OperationTimer timer(S21Operation::kDeterminant);
+    timer.AddFlops(1e19);
+    timer.AddFlops(1e19);
+  }
+  S21MatrixStats::SetEnabled(false);
+
+  std::vector<S21OperationStats> snapshot = S21MatrixStats::Snapshot();
+  EXPECT_EQ(snapshot[static_cast<int>(S21Operation::kGemm)].flops, 10u);
+  EXPECT_EQ(snapshot[static_cast<int>(S21Operation::kDeterminant)].flops,
+            UINT64_MAX);
+  S21MatrixStats::Reset();
+}
+
+namespace {
+
+struct CountingArena {
+  std::size_t allocated;
+  std::size_t released;
+  bool fail;
+};
+
+void* CountingAllocate(std::size_t bytes, void* context) {
+  CountingArena* arena = static_cast<CountingArena*>(context);
+  arena->allocated += bytes;
+  if (arena->fail) return nullptr;
+
+  // poisoned, so a missing zero-fill shows up in the results
+  void* result = std::malloc(bytes);
+  if (result != nullptr) std::memset(result, 0xFF, bytes);
+  return result;
+}
+
+void CountingDeallocate(void* pointer, std::size_t bytes, void* context) {
+  static_cast<CountingArena*>(context)->released += bytes;
+  std::free(pointer);
+}
+
+}  // namespace
+
+TEST(ALLOCATOR, NOERR) {
+  constexpr std::int64_t kBytes = 4 * sizeof(double*) + 16 * sizeof(double);
+  S21MemoryStats delta = {};
+  {
+    S21MemoryScope scope([&delta](const S21MemoryStats& stats) {
+      delta = stats;
+    });
+    S21Matrix test1(4, 4);
+    {
+      S21Matrix test2(test1 + test1);
+      EXPECT_EQ(scope.GetDelta().liveBytes, 2 * kBytes);
+    }
+    EXPECT_EQ(scope.GetDelta().liveBytes, kBytes);
+  }
+  EXPECT_EQ(delta.liveBytes, 0);
+  EXPECT_GE(delta.peakBytes, 2 * kBytes);
+  EXPECT_EQ(delta.allocations, delta.deallocations);
+  EXPECT_GE(S21Allocator::GetProcessStats().peakBytes, 2 * kBytes);
+
+  CountingArena arena = {0, 0, false};
+  S21Allocator::SetHooks({CountingAllocate, CountingDeallocate, &arena});
+  {
+    S21Matrix test3(2, 3);
+    test3.SetRowsCount(3);
+  }
+  S21Allocator::ResetHooks();
+  EXPECT_GT(arena.allocated, 0u);
+  EXPECT_EQ(arena.allocated, arena.released);
+}
+
+TEST(ALLOCATOR, ERR) {
+  CountingArena arena = {0, 0, true};
+  S21MemoryScope scope;
+
+  S21Allocator::SetHooks({CountingAllocate, CountingDeallocate, &arena});
+  EXPECT_THROW(S21Matrix(2, 2), std::bad_alloc);
+  S21Allocator::ResetHooks();
+  EXPECT_EQ(scope.GetDelta().liveBytes, 0);
+  EXPECT_EQ(scope.GetDelta().allocations, 0u);
+}
+
+TEST(UNINIT, NOERR) {
+  S21Matrix large(1024, 1024);
+  EXPECT_EQ(large(1023, 1023), 0.0);
+  EXPECT_EQ(large.Sum(), 0.0);
+
+  CountingArena arena = {0, 0, false};
+  S21Allocator::SetHooks({CountingAllocate, CountingDeallocate, &arena});
+  {
+    S21Matrix zeroed(3, 2);
+    EXPECT_EQ(zeroed.Sum(), 0.0);
+    zeroed.SetMatrix(1.0, 1.0);
+    zeroed.SetRowsCount(4);
+    zeroed.SetColsCount(3);
+    EXPECT_EQ(zeroed.Sum(), 21.0);
+    EXPECT_EQ(zeroed(3, 0), 0.0);
+    EXPECT_EQ(zeroed(0, 2), 0.0);
+
+    S21Matrix product = zeroed.Product(zeroed.Transpose());
+    EXPECT_EQ(product(0, 0), 5.0);
+    EXPECT_EQ(product(2, 1), 39.0);
+    EXPECT_EQ(zeroed.Map(S21Abs()), zeroed);
+
+    S21Matrix uninit(2, 5, S21Matrix::uninit);
+    EXPECT_EQ(uninit.GetRowsCount(), 2);
+    EXPECT_EQ(uninit.GetColsCount(), 5);
+    uninit.SetMatrix(2.0);
+    EXPECT_EQ(uninit.Sum(), 20.0);
+  }
+  S21Allocator::ResetHooks();
+  EXPECT_EQ(arena.allocated, arena.released);
+}
+
+TEST(PLACEMENT, NOERR) {
+  S21Allocator::SetPlacement({S21HugePages::kTransparent,
+                              S21NumaPlacement::kFirstTouch, 1 << 16});
+  {
+    S21Matrix test1(300, 200);
+    S21Matrix test2(300, 200, S21Matrix::uninit);
+    EXPECT_EQ(test1.Sum(), 0.0);
+    test1.SetMatrix(1.0, 1.0);
+    test2.SetMatrix(2.0);
+    S21Matrix test3 = test1.Product(test2.Transpose());
+    EXPECT_EQ(test3(299, 299), 2.0 * (60000.0 + 59801.0) * 100.0);
+    test3.SetRowsCount(2);
+    EXPECT_EQ(test3.GetRowsCount(), 2);
+  }
+  S21Allocator::SetPlacement(
+      {S21HugePages::kExplicit, S21NumaPlacement::kInterleave, 0});
+  {
+    S21Matrix test4(4, 4);
+    test4.SetMatrix(1.0);
+    S21Matrix test5 = test4 + test4;
+    EXPECT_EQ(test5.Sum(), 32.0);
+  }
+  S21Allocator::ResetPlacement();
+  EXPECT_EQ(S21Allocator::GetPlacement().hugePages, S21HugePages::kNone);
+  EXPECT_FALSE(S21Allocator::IsPlaced(1 << 30));
+}
+
+TEST(PLACEMENT, ERR) {
+  // a block is released the way it was allocated, whatever the placement
+  // is by then
+  S21Allocator::SetPlacement(
+      {S21HugePages::kTransparent, S21NumaPlacement::kLocal, 1 << 16});
+  S21Matrix* placed = new S21Matrix(300, 200);
+  S21Vector* vector = new S21Vector(1 << 14);
+  placed->SetMatrix(1.0);
+  S21Matrix shared(*placed);
+  shared.SetCopyOnWrite(true);
+  S21Matrix copy(shared);
+  S21Allocator::ResetPlacement();
+  delete placed;
+  delete vector;
+  copy(0, 0) = 2.0;
+  EXPECT_EQ(shared.Sum(), 60000.0);
+  EXPECT_EQ(copy.Sum(), 60001.0);
+
+  S21Matrix* heap = new S21Matrix(300, 200);
+  vector = new S21Vector(1 << 14);
+  S21Allocator::SetPlacement(
+      {S21HugePages::kTransparent, S21NumaPlacement::kLocal, 1 << 16});
+  heap->SetMatrix(1.0);
+  delete heap;
+  delete vector;
+  S21Allocator::ResetPlacement();
+}
+
+TEST(ASYNC, NOERR) {
+  S21Matrix test1(3, 3);
+  test1.SetMatrix(1.0, 1.0);
+  test1(2, 2) = 10.0;
+  test1.ToCsv("s21_matrix_async.csv");
+
+  S21Future<S21Matrix> inverse = test1.InverseMatrixAsync();
+  S21Future<double> determinant = test1.DeterminantAsync();
+  S21Future<S21Matrix> sum = test1.SumMatrixAsync(test1);
+  test1.SetMatrix(0.0);
+  EXPECT_NEAR(determinant.Get(), -3.0, EPS);
+  EXPECT_EQ(sum.Get()(2, 2), 20.0);
+  EXPECT_FALSE(sum.IsValid());
+
+  S21Matrix expected = inverse.Get();
+  S21Future<void> pipeline =
+      S21Matrix::FromCsvAsync("s21_matrix_async.csv")
+          .Then([](S21Matrix matrix) { return matrix.InverseMatrix(); })
+          .Then([](S21Matrix matrix) { matrix.ToCsv("s21_matrix_async.csv"); });
+  pipeline.Get();
+  EXPECT_TRUE(
+      S21Matrix::FromCsv("s21_matrix_async.csv").ApproxEqual(expected, EPS));
+  std::remove("s21_matrix_async.csv");
+
+  std::vector<S21Future<S21Matrix>> products;
+  for (int i = 0; i < 8; i++) {
+    products.push_back(expected.MulNumberAsync(i).Then(
+        [](S21Matrix matrix) { return matrix.Transpose(); }));
+  }
+  for (int i = 0; i < 8; i++) {
+    EXPECT_EQ(products[i].Get()(0, 2), expected(2, 0) * i);
+  }
+
+  int count = 0;
+  S21Async([&count]() { count++; })
+      .Then([&count]() { return count + 1; })
+      .Then([](int value) { EXPECT_EQ(value, 2); })
+      .Get();
+  EXPECT_EQ(count, 1);
+}
+
+TEST(ASYNC, ERR) {
+  S21Matrix test1(2, 2);
+  S21Matrix test2(3, 3);
+  bool called = false;
+
+  S21Future<S21Matrix> sum = test1.SumMatrixAsync(test2).Then(
+      [&called](S21Matrix matrix) {
+        called = true;
+        return matrix;
+      });
+  EXPECT_THROW(sum.Get(), std::invalid_argument);
+  EXPECT_FALSE(called);
+  EXPECT_THROW(sum.Get(), std::invalid_argument);
+  EXPECT_THROW(test2.InverseMatrixAsync().Get(), std::invalid_argument);
+  EXPECT_THROW(S21Matrix::FromCsvAsync("s21_matrix_missing.csv").Get(),
+               std::exception);
+}
+
+namespace {
+
+long long ForkSum(int begin, int end) {
+  long long result = 0;
+
+  if (end - begin <= 64) {
+    for (int i = begin; i < end; i++) result += i;
+  } else {
+    long long left = 0;
+    long long right = 0;
+    int middle = begin + (end - begin) / 3;
+    S21TaskGroup group;
+    group.Run([&left, begin, middle]() { left = ForkSum(begin, middle); });
+    group.Run([&right, middle, end]() { right = ForkSum(middle, end); });
+    group.Wait();
+    result = left + right;
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST(TASK_GROUP, NOERR) {
+  EXPECT_EQ(ForkSum(0, 100000), 4999950000ll);
+
+  S21WorkStealingDeque deque;
+  std::vector<S21Task> tasks(1000);
+  for (S21Task& task : tasks) deque.Push(&task);
+  EXPECT_EQ(deque.Steal(), &tasks[0]);
+  EXPECT_EQ(deque.Pop(), &tasks[999]);
+  for (int i = 998; i > 0; i--) deque.Pop();
+  EXPECT_EQ(deque.Pop(), nullptr);
+  EXPECT_EQ(deque.Steal(), nullptr);
+
+  S21ThreadPool pool(3);
+  std::atomic<int> count{0};
+  {
+    S21TaskGroup group(pool);
+    for (int i = 0; i < 100; i++) {
+      group.Run([&pool, &count]() {
+        S21TaskGroup nested(pool);
+        for (int j = 0; j < 10; j++) nested.Run([&count]() { count++; });
+        nested.Wait();
+      });
+    }
+    group.Wait();
+  }
+  EXPECT_EQ(count.load(), 1000);
+
+  // a thread outside the pool sleeps while it waits, it doesn't spin
+  std::clock_t start = std::clock();
+  {
+    S21TaskGroup group(pool);
+    group.Run([]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    });
+    group.Wait();
+  }
+  EXPECT_LT(std::clock() - start, CLOCKS_PER_SEC / 20);
+
+  S21Matrix test1(8, 8);
+  test1.SetMatrix(1.0, 0.5);
+  for (int i = 0; i < 8; i++) test1(i, i) += 10.0;
+  S21Matrix inverse = test1.InverseMatrix();
+  S21Matrix identity(8, 8);
+  for (int i = 0; i < 8; i++) identity(i, i) = 1.0;
+  EXPECT_TRUE(test1.Product(inverse).ApproxEqual(identity, 1e-9));
+}
+
+TEST(TASK_GROUP, ERR) {
+  S21ThreadPool pool(2);
+  std::atomic<int> count{0};
+  S21TaskGroup group(pool);
+
+  for (int i = 0; i < 10; i++) {
+    group.Run([&count, i]() {
+      count++;
+      if (i % 3 == 0) throw std::runtime_error("task");
+    });
+  }
+  EXPECT_THROW(group.Wait(), std::runtime_error);
+  EXPECT_EQ(count.load(), 10);
+  EXPECT_NO_THROW(group.Wait());
+}
+
+TEST(LAZY, NOERR) {
+  S21Distribution uniform = S21Distribution::Uniform(-1.0, 1.0);
+  S21Matrix a = S21Matrix::Random(6, 6, uniform, 1);
+  S21Matrix b = S21Matrix::Random(6, 6, uniform, 2);
+  S21Matrix c = S21Matrix::Random(6, 6, uniform, 3);
+  S21Matrix product = a.Product(b);
+  S21LazyMatrix lazyA(a);
+  S21LazyMatrix lazyB(b);
+  S21LazyMatrix lazyC(c);
+  S21LazyReport report;
+
+  S21Matrix result = (lazyA.Product(lazyB).Transpose() +
+                      lazyA.Product(lazyB) * 2.0)
+                         .Evaluate(&report);
+  EXPECT_TRUE(result.ApproxEqual(product.Transpose() + product * 2.0, EPS));
+  EXPECT_EQ(report.nodes, 7u);
+  EXPECT_EQ(report.merged, 1u);
+  EXPECT_EQ(report.fused, 2u);
+  EXPECT_EQ(report.steps, 2u);
+
+  result = (lazyA.Transpose().Product(lazyB) * 3.0 + lazyC).Evaluate(&report);
+  EXPECT_TRUE(result.ApproxEqual(a.Transpose().Product(b) * 3.0 + c, EPS));
+  EXPECT_EQ(report.folded, 3u);
+  EXPECT_EQ(report.steps, 1u);
+
+  result = lazyA.Product(lazyB).Transpose().Evaluate(&report);
+  EXPECT_TRUE(result.ApproxEqual(product.Transpose(), EPS));
+  EXPECT_EQ(report.folded, 1u);
+
+  result = (lazyA.Transpose().Transpose() - lazyA).Evaluate();
+  EXPECT_TRUE(result.ApproxEqual(S21Matrix(6, 6), 0.0));
+
+  result = (lazyA + lazyB).Product(lazyC).Product(lazyC).Evaluate(&report);
+  EXPECT_TRUE(result.ApproxEqual((a + b).Product(c).Product(c), EPS));
+  EXPECT_EQ(report.reused, 1u);
+
+  result = ((lazyA + lazyB) + lazyA.Product(lazyB)).Evaluate(&report);
+  EXPECT_TRUE(result.ApproxEqual(a + b + product, EPS));
+  EXPECT_EQ(report.folded, 1u);
+  EXPECT_EQ(report.reused, 1u);
+
+  S21LazyMatrix shared = lazyA.Product(lazyB);
+  std::vector<S21Matrix> results = S21LazyMatrix::Evaluate(
+      {shared + lazyC, shared * lazyC, lazyA, shared}, &report);
+  EXPECT_TRUE(results[0].ApproxEqual(product + c, EPS));
+  EXPECT_TRUE(results[1].ApproxEqual(product * c, EPS));
+  EXPECT_TRUE(results[2].ApproxEqual(a, 0.0));
+  EXPECT_TRUE(results[3].ApproxEqual(product, EPS));
+  EXPECT_EQ(report.steps, 3u);
+
+  // fused on the thread pool, with the operations of the eager methods
+  S21Matrix x = S21Matrix::Random(300, 300, uniform, 4);
+  S21Matrix y = S21Matrix::Random(300, 300, uniform, 5);
+  S21LazyMatrix lazyX(x);
+  S21LazyMatrix lazyY(y);
+  result = ((lazyX + lazyY) * 0.5 - lazyX * lazyY.Transpose()).Evaluate();
+  EXPECT_TRUE(result.ApproxEqual((x + y) * 0.5 - x * y.Transpose(), 0.0));
+
+  double first = a(0, 0);
+  S21LazyMatrix doubled = lazyA * 2.0;
+  a(0, 0) = 100.0;
+  EXPECT_EQ(doubled.Evaluate()(0, 0), first * 2.0);
+  EXPECT_EQ(doubled.GetRowsCount(), 6);
+}
+
+TEST(LAZY, ERR) {
+  S21LazyMatrix null;
+  S21LazyMatrix wide(S21Matrix(2, 3));
+  S21LazyMatrix tall(S21Matrix(3, 2));
+
+  EXPECT_TRUE(null.IsNull());
+  EXPECT_THROW(S21LazyMatrix{S21Matrix()}, std::invalid_argument);
+  EXPECT_THROW(null.Evaluate(), std::invalid_argument);
+  EXPECT_THROW(null.Transpose(), std::invalid_argument);
+  EXPECT_THROW(wide + null, std::invalid_argument);
+  EXPECT_THROW(wide + tall, std::invalid_argument);
+  EXPECT_THROW(wide - tall, std::invalid_argument);
+  EXPECT_THROW(wide * tall, std::invalid_argument);
+  EXPECT_THROW(wide.Product(wide), std::invalid_argument);
+  EXPECT_THROW(S21LazyMatrix::Evaluate({wide, null}), std::invalid_argument);
+  EXPECT_EQ(wide.Product(tall).Evaluate().GetRowsCount(), 2);
+}
+
+TEST(CACHE, NOERR) {
+  S21MatrixCache::SetBudget(1 << 20);
+  S21MatrixCache::Clear();
+  S21MatrixCache::ResetStats();
+
+  S21Matrix test = S21Matrix::Random(6, 6, S21Distribution::Normal(), 7);
+  double determinant = test.Determinant();
+  S21Matrix inverse = test.InverseMatrix();
+  S21Matrix complements = test.CalcComplements();
+  EXPECT_EQ(S21MatrixCache::GetStats().misses, 3u);
+  EXPECT_EQ(S21MatrixCache::GetStats().entries, 3u);
+
+  // an equal matrix hits, a copy keeps the hash
+  S21Matrix copy(test);
+  EXPECT_EQ(copy.ContentHash(), test.ContentHash());
+  EXPECT_EQ(copy.Determinant(), determinant);
+  EXPECT_TRUE(copy.InverseMatrix().EqMatrix(inverse));
+  EXPECT_TRUE(test.CalcComplements().EqMatrix(complements));
+  EXPECT_EQ(S21MatrixCache::GetStats().hits, 3u);
+
+  // a write invalidates the hash
+  std::uint64_t hash = copy.ContentHash();
+  copy.SetElementAtIndex(0, 0, copy(0, 0) + 1.0);
+  EXPECT_NE(copy.ContentHash(), hash);
+  EXPECT_NE(copy.Determinant(), determinant);
+  copy.SetElementAtIndex(0, 0, test(0, 0));
+  EXPECT_EQ(copy.ContentHash(), hash);
+  EXPECT_EQ(S21MatrixCache::GetStats().hits, 3u);
+
+  // below kMinSize nothing is cached
+  S21Matrix small = S21Matrix::Random(3, 3, S21Distribution::Normal(), 7);
+  small.Determinant();
+  EXPECT_EQ(S21MatrixCache::GetStats().entries, 4u);
+
+  S21MatrixCache::SetBudget(0);
+  EXPECT_FALSE(S21MatrixCache::IsEnabled());
+  EXPECT_EQ(S21MatrixCache::GetStats().entries, 0u);
+  EXPECT_EQ(S21MatrixCache::GetStats().evictions, 4u);
+  EXPECT_EQ(test.Determinant(), determinant);
+  EXPECT_EQ(S21MatrixCache::GetStats().hits, 3u);
+
+  // the stored operand is a private copy, a write through a reference kept
+  // into a copy-on-write matrix is a miss
+  S21MatrixCache::SetBudget(1 << 20);
+  S21Matrix shared(4, 4);
+  shared.SetCopyOnWrite(true);
+  for (int i = 0; i < 4; i++) shared(i, i) = 2.0;
+  double& element = shared.At(0, 0);
+  EXPECT_DOUBLE_EQ(shared.Determinant(), 16.0);
+  element = 10.0;
+  EXPECT_DOUBLE_EQ(shared.Determinant(), 80.0);
+  S21MatrixCache::SetBudget(0);
+  S21MatrixCache::ResetStats();
+}
+
+TEST(CACHE, ERR) {
+  S21MatrixCache::SetBudget(1 << 20);
+  S21MatrixCache::ResetStats();
+
+  // a failed inverse is not stored
+  S21Matrix singular(5, 5);
+  EXPECT_THROW(singular.InverseMatrix(), std::invalid_argument);
+  EXPECT_THROW(singular.InverseMatrix(), std::invalid_argument);
+  EXPECT_EQ(S21MatrixCache::GetStats().insertions, 0u);
+
+  // an entry over the share of a shard is never kept
+  S21MatrixCache::SetBudget(16 * 1024);
+  S21Matrix test = S21Matrix::Random(8, 8, S21Distribution::Normal(), 3);
+  test.InverseMatrix();
+  test.Determinant();
+  EXPECT_EQ(S21MatrixCache::GetStats().insertions, 1u);
+  EXPECT_LE(S21MatrixCache::GetStats().bytes, 16u * 1024);
+
+  S21MatrixCache::SetBudget(0);
+  S21MatrixCache::ResetStats();
+  EXPECT_EQ(S21MatrixCache::GetBudget(), 0u);
+}
+
+TEST(FACTORIZATION, NOERR) {
+  const int size = 40;
+  S21Matrix matrix =
+      S21Matrix::Random(size, size, S21Distribution::Normal(), 5);
+  S21Vector u = S21Matrix::Random(size, 1, S21Distribution::Normal(), 6)
+                    .GetCol(0);
+  S21Vector v = S21Matrix::Random(size, 1, S21Distribution::Normal(), 7)
+                    .GetCol(0);
+  S21LU lu(matrix);
+
+  S21Matrix permuted(size, size);
+  for (int i = 0; i < size; i++) {
+    permuted.SetRow(i, matrix.GetRow(lu.GetPivots()[i]));
+  }
+  EXPECT_TRUE(lu.GetL().Product(lu.GetU()).ApproxEqual(permuted, 1e-12));
+  S21Vector residual = matrix.Product(lu.Solve(u));
+  residual.Axpy(-1.0, u);
+  EXPECT_LT(residual.Norm(), 1e-9);
+
+  // the updated factors match a new factorization
+  lu.Update(0.5, u, v);
+  lu.Update(-0.25, v, u);
+  lu.SetElementAtIndex(3, 7, 10.0);
+  lu.SetRow(5, u);
+  lu.SetCol(11, v);
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) {
+      matrix(i, j) += 0.5 * u(i) * v(j) - 0.25 * v(i) * u(j);
+    }
+  }
+  matrix(3, 7) = 10.0;
+  matrix.SetRow(5, u);
+  matrix.SetCol(11, v);
+  S21LU fresh(matrix);
+  EXPECT_TRUE(lu.GetMatrix().ApproxEqual(matrix, 1e-12));
+  EXPECT_NEAR(lu.Determinant() / fresh.Determinant(), 1.0, 1e-9);
+  EXPECT_TRUE(lu.InverseMatrix().ApproxEqual(fresh.InverseMatrix(), 1e-9));
+  EXPECT_EQ(lu.GetRefactorsCount(), 0);
+
+  S21Matrix spd = matrix.Transpose().Product(matrix);
+  for (int i = 0; i < size; i++) spd(i, i) += size;
+  S21Cholesky cholesky(spd);
+  EXPECT_TRUE(cholesky.GetL().Product(cholesky.GetL().Transpose())
+                  .ApproxEqual(spd, 1e-9));
+
+  cholesky.Update(u);
+  cholesky.Downdate(v);
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) spd(i, j) += u(i) * u(j) - v(i) * v(j);
+  }
+  spd(2, 9) += 1.0;
+  spd(9, 2) = spd(2, 9);
+  spd(4, 4) -= 1.0;
+  cholesky.SetElementAtIndex(2, 9, spd(2, 9));
+  cholesky.SetElementAtIndex(4, 4, spd(4, 4));
+  EXPECT_TRUE(cholesky.GetMatrix().ApproxEqual(spd, 1e-9));
+  EXPECT_TRUE(cholesky.GetL().Product(cholesky.GetL().Transpose())
+                  .ApproxEqual(spd, 1e-9));
+  EXPECT_NEAR(cholesky.Determinant() / S21LU(spd).Determinant(), 1.0, 1e-9);
+  EXPECT_TRUE(
+      cholesky.InverseMatrix().ApproxEqual(S21LU(spd).InverseMatrix(), 1e-9));
+  residual = spd.Product(cholesky.Solve(u));
+  residual.Axpy(-1.0, u);
+  EXPECT_LT(residual.Norm(), 1e-9);
+}
+
+TEST(FACTORIZATION, ERR) {
+  S21Matrix singular(3, 3);
+  singular.SetMatrix(1.0, 1.0);
+  S21Matrix rectangular(2, 3);
+  S21Matrix identity(3, 3);
+  for (int i = 0; i < 3; i++) identity(i, i) = 1.0;
+  S21Vector e0(3);
+  e0(0) = 1.0;
+
+  EXPECT_THROW(S21LU{S21Matrix()}, std::invalid_argument);
+  EXPECT_THROW(S21LU{rectangular}, std::invalid_argument);
+  EXPECT_THROW(S21LU{singular}, std::invalid_argument);
+
+  // a singular result is refused and the factors are kept
+  S21LU lu(identity);
+  EXPECT_THROW(lu.SetElementAtIndex(0, 0, 0.0), std::invalid_argument);
+  EXPECT_THROW(lu.Update(-1.0, e0, e0), std::invalid_argument);
+  EXPECT_TRUE(lu.GetMatrix().EqMatrix(identity));
+  EXPECT_DOUBLE_EQ(lu.Determinant(), 1.0);
+  EXPECT_THROW(lu.SetRow(3, e0), std::out_of_range);
+  EXPECT_THROW(lu.SetCol(0, S21Vector(2)), std::invalid_argument);
+  EXPECT_THROW(lu.Solve(S21Vector(2)), std::invalid_argument);
+
+  // a vanishing pivot is avoided by factorizing again
+  lu.SetElementAtIndex(0, 1, 2.0);
+  lu.SetElementAtIndex(1, 0, 1.0);
+  lu.SetElementAtIndex(0, 0, 0.0);
+  EXPECT_DOUBLE_EQ(lu.Determinant(), -2.0);
+  EXPECT_EQ(lu.GetRefactorsCount(), 1);
+
+  S21Matrix notSymmetric(identity);
+  notSymmetric(0, 1) = 1.0;
+  S21Matrix indefinite(identity);
+  indefinite(2, 2) = -1.0;
+  EXPECT_THROW(S21Cholesky{notSymmetric}, std::invalid_argument);
+  EXPECT_THROW(S21Cholesky{indefinite}, std::invalid_argument);
+
+  S21Cholesky cholesky(identity);
+  EXPECT_THROW(cholesky.Downdate(e0), std::invalid_argument);
+  EXPECT_THROW(cholesky.SetElementAtIndex(0, 1, 1.0), std::invalid_argument);
+  EXPECT_THROW(cholesky.SetElementAtIndex(1, 1, -1.0), std::invalid_argument);
+  EXPECT_TRUE(cholesky.GetMatrix().EqMatrix(identity));
+  EXPECT_TRUE(cholesky.GetL().EqMatrix(identity));
+  EXPECT_THROW(cholesky.Update(S21Vector(4)), std::invalid_argument);
+  EXPECT_THROW(cholesky.SetElementAtIndex(0, -1, 1.0), std::out_of_range);
+}
+
+TEST(UPDATE_INVERSE, NOERR) {
+  const int size = 30;
+  S21Matrix matrix =
+      S21Matrix::Random(size, size, S21Distribution::Normal(), 8);
+  S21Matrix u = S21Matrix::Random(size, 3, S21Distribution::Normal(), 9);
+  S21Matrix v = S21Matrix::Random(size, 3, S21Distribution::Normal(), 10);
+  S21Matrix inverse = S21LU(matrix).InverseMatrix();
+
+  inverse.UpdateInverse(u.GetCol(0), v.GetCol(0));
+  S21Matrix changed(matrix);
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) changed(i, j) += u(i, 0) * v(j, 0);
+  }
+  EXPECT_TRUE(inverse.ApproxEqual(S21LU(changed).InverseMatrix(), 1e-9));
+
+  // rank 3 on top of it
+  inverse.UpdateInverse(u, v);
+  changed.Gemm(1.0, u, false, v, true, 1.0);
+  EXPECT_TRUE(inverse.ApproxEqual(S21LU(changed).InverseMatrix(), 1e-9));
+}
+
+TEST(UPDATE_INVERSE, ERR) {
+  S21Matrix identity(2, 2);
+  identity(0, 0) = 1.0;
+  identity(1, 1) = 1.0;
+  S21Vector e0(2);
+  e0(0) = 1.0;
+  S21Vector minusE0(e0);
+  minusE0(0) = -1.0;
+
+  EXPECT_THROW(S21Matrix().UpdateInverse(e0, e0), std::invalid_argument);
+  EXPECT_THROW(S21Matrix(2, 3).UpdateInverse(e0, e0), std::invalid_argument);
+  EXPECT_THROW(identity.UpdateInverse(e0, S21Vector(3)),
+               std::invalid_argument);
+  EXPECT_THROW(identity.UpdateInverse(e0, minusE0), std::invalid_argument);
+  EXPECT_THROW(identity.UpdateInverse(S21Matrix(2, 1), S21Matrix(2, 2)),
+               std::invalid_argument);
+  S21Matrix a(2, 1);
+  S21Matrix b(2, 1);
+  a(0, 0) = -1.0;
+  b(0, 0) = 1.0;
+  EXPECT_THROW(identity.UpdateInverse(a, b), std::invalid_argument);
+  EXPECT_DOUBLE_EQ(identity(0, 0), 1.0);
+}
+
 int main() {
   testing::InitGoogleTest();
   return RUN_ALL_TESTS();